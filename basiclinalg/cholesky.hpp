@@ -40,6 +40,10 @@ namespace ngbla
       Factor (a);
     }
 
+    /// The factors of a matrix of size an, computed before into data
+    FlatCholeskyFactors (int an, T * data)
+      : n(an), lfact(data+an), diag(data) { ; }
+
     ///
     NGS_DLL_HEADER void Factor (const FlatMatrix<T> & a);
     /// Multiply with the inverse of A 
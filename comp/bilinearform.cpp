@@ -93,6 +93,8 @@ namespace ngcomp
     spd = flags.GetDefineFlag ("spd");
     if (spd) symmetric = true;
     SetCheckUnused (!flags.GetDefineFlagX("check_unused").IsFalse());
+    SetTaskGraph (flags.GetDefineFlag ("taskgraph"));
+    SetCacheElementMatrices (flags.GetDefineFlag ("cache_elmats"));
   }
 
 
@@ -143,6 +145,8 @@ namespace ngcomp
     precompute = flags.GetDefineFlag ("precompute");
     checksum = flags.GetDefineFlag ("checksum");
     SetCheckUnused (!flags.GetDefineFlagX("check_unused").IsFalse());    
+    SetTaskGraph (flags.GetDefineFlag ("taskgraph"));
+    SetCacheElementMatrices (flags.GetDefineFlag ("cache_elmats"));
   }
 
 
@@ -252,7 +256,18 @@ namespace ngcomp
   */
 
   BilinearForm :: ~BilinearForm ()
-  { ; }
+  {
+    DeletePrecomputedData();
+  }
+
+  void BilinearForm :: DeletePrecomputedData ()
+  {
+    for (size_t i = 0; i < precomputed_data.Size(); i++)
+      if (precomputed_data[i])
+        precomputed_owner[i]->DeletePrecomputedData (precomputed_data[i]);
+    precomputed_data.SetSize0();
+    precomputed_owner.SetSize0();
+  }
 
   void BilinearForm :: SetPrint (bool ap)
   { 
@@ -522,45 +537,27 @@ namespace ngcomp
       
         if (precompute)
           {
-            Array<DofId> dnums;
-            precomputed_data.SetSize( max2(max2(ma->GetNE(VOL), ma->GetNE(BND)),ma->GetNE(BBND))*NumIntegrators() );
+            // element data of the volume integrators, entry el*nparts+k
+            DeletePrecomputedData();
+            auto & vol_parts = VB_parts[VOL];
+            precomputed_data.SetSize (ma->GetNE(VOL) * vol_parts.Size());
             precomputed_data = nullptr;
+            precomputed_owner.SetSize (precomputed_data.Size());
 
-            LocalHeap lh (20000000, "biform - assemble");
-            
-            // int hasbound = 0;
-            // int hasinner = 0;
-            for (VorB vb : {VOL, BND, BBND})
-	      {
-		int ne = ma->GetNE(vb);
-		if(VB_parts[vb].Size())
-		  {
-		    for (int i=0; i < ne; i++)
-		      {
-                        ElementId ei(vb, i);
-			// auto & fel = fespace->GetFE(ei,lh);
-			// auto & eltrans = ma->GetTrafo(ei,lh);
-			fespace->GetDofNrs(ei,dnums);
-                        /*
-			for(int j=0; j<NumIntegrators(); j++)
-			  {
-			    const BilinearFormIntegrator & bfi = *parts[j];
-                        */
-                        /*
-                        for (auto & bfi : VB_parts[vb])
-                          {
-			    // if(bfi.VB()!=vb) continue;
-			    if(!bfi->DefinedOn (ma->GetElIndex(i))) continue;
-                            
-			    precomputed_data[i*NumIntegrators()+j] =
-			      bfi->PrecomputeData(fel,eltrans,lh);
-			  }
-                        */
-                        throw Exception ("precomputed currently not supported");
-		      }
-		  }
-	      }
-	  }
+            IterateElements 
+              (*fespace, VOL, lh, 
+               [&] (FESpace::Element el, LocalHeap & llh)
+               {
+                 for (size_t k : Range(vol_parts))
+                   if (vol_parts[k]->DefinedOn (el.GetIndex()))
+                     {
+                       size_t ii = el.Nr()*vol_parts.Size()+k;
+                       precomputed_data[ii] =
+                         vol_parts[k]->PrecomputeData (el.GetFE(), el.GetTrafo(), llh);
+                       precomputed_owner[ii] = vol_parts[k];
+                     }
+               });
+          }
             
         
         if (timing)
@@ -704,6 +701,8 @@ namespace ngcomp
         << "eliminate_internal = " << eliminate_internal << endl
         << "keep_internal = " << keep_internal << endl
         << "store_inner = " << store_inner << endl
+        << "taskgraph = " << taskgraph << endl
+        << "cache_elmats = " << cache_elmats << endl
         << "integrators: " << endl;
   
     for (int i = 0; i < parts.Size(); i++)
@@ -730,6 +729,78 @@ namespace ngcomp
   S_BilinearForm<SCAL> :: ~S_BilinearForm() { ; }
 
 
+  template <class SCAL>
+  void S_BilinearForm<SCAL> :: UpdateElementMatrixCache ()
+  {
+    if (!cache_elmats) return;
+    // a replaced or re-marked integrator has another version
+    Array<size_t> versions;
+    for (auto & part : parts)
+      if (IsCached (*part))
+        versions.Append (part->CacheElementMatrixVersion());
+
+    size_t geom_timestamp = ma->GetGeometryTimeStamp();
+    if (elmat_cache_timestamp == geom_timestamp &&
+        elmat_cache_ndof == fespace->GetNDof() &&
+        elmat_cache_versions == versions)
+      return;
+
+    for (VorB vb : { VOL, BND, BBND, BBBND })
+      elmat_cache[vb] = Array<Array<SCAL>> (VB_parts[vb].Size() ? ma->GetNE(vb) : 0);
+    elmat_cache_timestamp = geom_timestamp;
+    elmat_cache_ndof = fespace->GetNDof();
+    elmat_cache_versions = move(versions);
+  }
+
+
+  template <class SCAL>
+  void S_BilinearForm<SCAL> ::
+  AddCachedElementMatrix (ElementId ei, const FiniteElement & fel,
+                          const ElementTransformation & eltrans,
+                          FlatMatrix<SCAL> sum_elmat, LocalHeap & lh)
+  {
+    static Timer t("element matrix cache - fill", 2);
+    VorB vb = ei.VB();
+    size_t h = sum_elmat.Height(), w = sum_elmat.Width();
+    if (h*w == 0) return;
+    // every element is visited by one thread only
+    Array<SCAL> & cached = elmat_cache[vb][ei.Nr()];
+
+    if (cached.Size() != h*w)
+      {
+        ThreadRegionTimer reg (t, TaskManager::GetThreadId());
+        HeapReset hr(lh);
+        FlatMatrix<SCAL> elmat(h, w, lh);
+        int index = eltrans.GetElementIndex();
+        bool done = false;
+        while (!done)
+          {
+            done = true;
+            elmat = 0;
+            for (auto & bfip : VB_parts[vb])
+              {
+                const BilinearFormIntegrator & bfi = *bfip;
+                if (!IsCached (bfi)) continue;
+                if (!bfi.DefinedOn (index)) continue;
+                if (!bfi.DefinedOnElement (ei.Nr())) continue;
+                try
+                  {
+                    bfi.CalcElementMatrixAdd (fel, eltrans, elmat, lh);
+                  }
+                catch (ExceptionNOSIMD & e)
+                  {
+                    done = false;
+                  }
+              }
+          }
+        cached.SetSize (h*w);
+        FlatMatrix<SCAL> (h, w, &cached[0]) = elmat;
+      }
+
+    sum_elmat += FlatMatrix<SCAL> (h, w, &cached[0]);
+  }
+
+
 
 
   template <class SCAL>
@@ -791,6 +862,7 @@ namespace ngcomp
             size_t nf = ma->GetNFacets();
 
             GetMatrix().SetZero();
+            UpdateElementMatrixCache();
 	    
             if (print)
               {
@@ -920,7 +992,7 @@ namespace ngcomp
                           innermatrix = make_shared<ElementByElementMatrix<SCAL>>(ndof, ne);
                       }
                     
-                    IterateElements
+                    (taskgraph ? IterateElementsTaskGraph : IterateElements)
                       (*fespace, vb, clh,  [&] (FESpace::Element el, LocalHeap & lh)
                        {
                          if (elmat_ev && vb == VOL) 
@@ -1026,6 +1098,7 @@ namespace ngcomp
                                }
                              */
                              bool done = false;
+                             bool elem_has_cached = false;
                              while (!done)
                                {
                                  done = true;
@@ -1037,6 +1110,11 @@ namespace ngcomp
                                      if (!bfi.DefinedOnElement (el.Nr())) continue;                        
                                      
                                      elem_has_integrator = true;
+                                     if (IsCached (bfi))
+                                       {
+                                         elem_has_cached = true;
+                                         continue;
+                                       }
                                      
                                      try
                                        {
@@ -1048,6 +1126,8 @@ namespace ngcomp
                                        }
                                    }
                                }
+                             if (elem_has_cached)
+                               AddCachedElementMatrix (el, fel, eltrans, sum_elmat, lh);
                            }
                          } 
                          
@@ -2420,6 +2500,7 @@ namespace ngcomp
       
         BaseMatrix & mat = GetMatrix();
         mat = 0.0;
+        UpdateElementMatrixCache();
       
         cout << IM(3) << "Assemble linearization" << endl;
       
@@ -2448,7 +2529,7 @@ namespace ngcomp
                   innermatrix = make_shared<ElementByElementMatrix<SCAL>>(ndof, ne);
               }
             
-            IterateElements 
+            (taskgraph ? IterateElementsTaskGraph : IterateElements)
               (*fespace, vb, clh,  [&] (FESpace::Element el, LocalHeap & lh)
                {
                  const FiniteElement & fel = fespace->GetFE (el, lh);
@@ -2474,10 +2555,17 @@ namespace ngcomp
                  lin.GetIndirect (dnums, elveclin);
                  fespace->TransformVec (el, elveclin, TRANSFORM_SOL);
 
+                 bool elem_has_cached = false;
                  for (auto & bfi : VB_parts[vb])
                    {
                      if (!bfi->DefinedOn (el.GetIndex())) continue;
                      if (!bfi->DefinedOnElement (el.Nr())) continue;
+                     // linear in the constant coefficient case
+                     if (IsCached (*bfi) && !printelmat)
+                       {
+                         elem_has_cached = true;
+                         continue;
+                       }
                      
                      try
                        {
@@ -2516,7 +2604,8 @@ namespace ngcomp
                      
                      sum_elmat += elmat;
                    }
-                 
+                 if (elem_has_cached)
+                   AddCachedElementMatrix (el, fel, eltrans, sum_elmat, lh);
                  
                  fespace->TransformMat (el, sum_elmat, TRANSFORM_MAT_LEFT_RIGHT);
                  
@@ -3350,10 +3439,16 @@ namespace ngcomp
                    x.GetIndirect (dnums, elvecx);
                    this->fespace->TransformVec (el, elvecx, TRANSFORM_SOL);
                    
-                   for (auto & bfi : VB_parts[vb])
+                   for (size_t k : Range(VB_parts[vb]))
                      {
+                       auto & bfi = VB_parts[vb][k];
                        if (!bfi->DefinedOn (el.GetIndex())) continue;
-                       bfi->ApplyElementMatrix (fel, trafo, elvecx, elvecy, 0, lh);
+                       // integrators may have been added since the data was computed
+                       size_t ii = el.Nr()*VB_parts[VOL].Size()+k;
+                       void * precomputed = (vb == VOL && ii < precomputed_data.Size() &&
+                                             precomputed_owner[ii] == bfi)
+                         ? precomputed_data[ii] : nullptr;
+                       bfi->ApplyElementMatrix (fel, trafo, elvecx, elvecy, precomputed, lh);
                        
                        this->fespace->TransformVec (el, elvecy, TRANSFORM_RHS);
                        
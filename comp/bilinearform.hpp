@@ -48,6 +48,10 @@ namespace ngcomp
     double unuseddiag;
     /// check if all dofs declared used are used in assemble
     bool check_unused = true;
+    /// assemble along the element task-graph instead of color by color
+    bool taskgraph = false;
+    /// keep element matrices of integrators with constant coefficients
+    bool cache_elmats = false;
     /// low order bilinear-form, 0 if not used
     shared_ptr<BilinearForm> low_order_bilinear_form;
 
@@ -99,6 +103,10 @@ namespace ngcomp
     bool precompute;
     /// precomputed element-wise data
     Array<void*> precomputed_data;
+    /// the integrator which produced each entry of precomputed_data
+    Array<shared_ptr<BilinearFormIntegrator>> precomputed_owner;
+    /// frees precomputed data via its integrators
+    void DeletePrecomputedData ();
     /// output of norm of matrix entries
     bool checksum;
 
@@ -335,6 +343,12 @@ namespace ngcomp
     void SetStoreInner (bool storei) 
     { store_inner = storei; }
 
+    void SetTaskGraph (bool atg) 
+    { taskgraph = atg; }
+
+    void SetCacheElementMatrices (bool ace)
+    { cache_elmats = ace; }
+
     void SetPrint (bool ap);
     void SetPrintElmat (bool ap);
     void SetElmatEigenValues (bool ee);
@@ -404,6 +418,15 @@ namespace ngcomp
     shared_ptr<ElementByElementMatrix<SCAL>> innersolve; //  = NULL;
     shared_ptr<ElementByElementMatrix<SCAL>> innermatrix; //  = NULL;
 
+    /// sum of element matrices of integrators with constant coefficients,
+    /// before TransformMat, empty if not computed yet
+    Array<Array<SCAL>> elmat_cache[4];
+    /// geometry timestamp, number of dofs, and versions of the cached
+    /// integrators the cache is valid for
+    size_t elmat_cache_timestamp = 0;
+    size_t elmat_cache_ndof = 0;
+    Array<size_t> elmat_cache_versions;
+
 #ifdef PARALLEL
     //data for mpi-facets; only has data if there are relevant integrators in the BLF!
     mutable bool have_mpi_facet_data = false;
@@ -501,6 +524,16 @@ namespace ngcomp
     virtual void DoAssemble (LocalHeap & lh);
     ///
     // virtual void DoAssembleIndependent (BitArray & useddof, LocalHeap & lh);
+    /// clears the element matrix cache if mesh, space or integrators changed
+    void UpdateElementMatrixCache ();
+    /// adds the element matrices of integrators with constant coefficients,
+    /// they are computed at the first call and taken from the cache later on
+    void AddCachedElementMatrix (ElementId ei, const FiniteElement & fel,
+                                 const ElementTransformation & eltrans,
+                                 FlatMatrix<SCAL> sum_elmat, LocalHeap & lh);
+    /// is the element matrix of bfi taken from the cache ?
+    bool IsCached (const BilinearFormIntegrator & bfi) const
+    { return cache_elmats && bfi.CacheElementMatrix(); }
     ///
     virtual void AssembleLinearization (const BaseVector & lin,
 					LocalHeap & lh, 
@@ -50,6 +50,7 @@ namespace ngcomp
 
 #include "pmltrafo.hpp"
 #include "meshaccess.hpp"
+#include "searchtree.hpp"
 #include "ngsobject.hpp"
 #include "fespace.hpp"
 
@@ -81,5 +82,7 @@ namespace ngcomp
 #include "hypre_precond.hpp"
 #include "hypre_ams_precond.hpp"
 #include "vtkoutput.hpp"
+#include "pointevaluation.hpp"
+#include "dgoperator.hpp"
 
 #endif
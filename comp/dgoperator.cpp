@@ -0,0 +1,462 @@
+/*********************************************************************/
+/* File:   dgoperator.cpp                                            */
+/* Date:   Oct. 2026                                                 */
+/*********************************************************************/
+
+#include <comp.hpp>
+#include <map>
+
+namespace ngcomp
+{
+
+  /// - b^T J^{-T} w |J| in the volume points, component-wise
+  template <int D>
+  static void CalcVolumeWind (const CoefficientFunction & wind,
+                              const BaseMappedIntegrationRule & bmir,
+                              FlatVector<> bvol, LocalHeap & lh)
+  {
+    auto & mir = static_cast<const MappedIntegrationRule<D,D>&> (bmir);
+    size_t nip = mir.Size();
+    FlatMatrix<> b(nip, D, lh);
+    wind.Evaluate (mir, b);
+    for (size_t q = 0; q < nip; q++)
+      {
+        Vec<D> bq;
+        for (int k = 0; k < D; k++)
+          bq(k) = b(q,k);
+        Vec<D> hb = mir[q].GetJacobianInverse() * bq;
+        for (int k = 0; k < D; k++)
+          bvol(k*nip+q) = -mir[q].GetWeight() * hb(k);
+      }
+  }
+
+  /// b.n times the weights in the facet points
+  template <int D>
+  static void CalcFacetWind (const CoefficientFunction & wind,
+                             const IntegrationRule & ir_facet,
+                             BaseMappedIntegrationRule & bmir,
+                             ELEMENT_TYPE et, int facetnr,
+                             FlatVector<> bn, LocalHeap & lh)
+  {
+    bmir.ComputeNormalsAndMeasure (et, facetnr);
+    auto & mir = static_cast<const MappedIntegrationRule<D,D>&> (bmir);
+    FlatMatrix<> b(mir.Size(), D, lh);
+    wind.Evaluate (mir, b);
+    for (size_t q = 0; q < mir.Size(); q++)
+      {
+        double bnq = 0;
+        for (int k = 0; k < D; k++)
+          bnq += b(q,k) * mir[q].GetNV()(k);
+        bn(q) = ir_facet[q].Weight() * mir[q].GetMeasure() * bnq;
+      }
+  }
+
+
+  /// the order of SymbolicBFI for u * grad v
+  static int VolumeOrder (ELEMENT_TYPE et, int order, int bonus_intorder)
+  {
+    int intorder = 2*order + bonus_intorder;
+    if (et == ET_TRIG || et == ET_TET)
+      intorder--;
+    return max2 (intorder, 0);
+  }
+
+
+  DGConvectionOperator ::
+  DGConvectionOperator (shared_ptr<FESpace> afes, shared_ptr<CoefficientFunction> awind,
+                        int bonus_intorder)
+    : fes(dynamic_pointer_cast<L2HighOrderFESpace> (afes)), wind(awind)
+  {
+    static Timer t("DGConvectionOperator - setup");
+    RegionTimer reg(t);
+
+    if (!fes)
+      throw Exception ("DGConvectionOperator: needs an L2HighOrderFESpace");
+    if (fes->IsComplex() || fes->GetDimension() != 1)
+      throw Exception ("DGConvectionOperator: only real, scalar spaces");
+    auto ma = fes->GetMeshAccess();
+    dim = ma->GetDimension();
+    if (wind->Dimension() != dim)
+      throw Exception ("DGConvectionOperator: wind must have "+ToString(dim)+" components");
+
+    size_t ne = ma->GetNE(VOL);
+    LocalHeap clh(10000000 * TaskManager::GetNumThreads(), "DGConvectionOperator - setup", true);
+
+    // elements of the same type, order and vertex ordering have the same shape functions
+    Array<int> order(ne), ndof(ne), vcode(ne);
+    ParallelForRange (ne, [&] (IntRange r)
+                      {
+                        LocalHeap lh = clh.Split();
+                        for (size_t i : r)
+                          {
+                            HeapReset hr(lh);
+                            ElementId ei(VOL, i);
+                            const FiniteElement & fel = fes->GetFE (ei, lh);
+                            order[i] = fel.Order();
+                            ndof[i] = fel.GetNDof();
+                            auto vnums = ma->GetElVertices (ei);
+                            int code = 0;
+                            for (size_t j : Range(vnums))
+                              {
+                                int rank = 0;
+                                for (auto v : vnums)
+                                  if (v < vnums[j]) rank++;
+                                code = 8*code + rank;
+                              }
+                            vcode[i] = code;
+                          }
+                      });
+
+    int maxorder = 0;
+    for (int o : order)
+      maxorder = max2 (maxorder, o);
+    int facetorder = 2*maxorder + bonus_intorder;
+
+    std::map<tuple<int,int,int,int>, int> classnr;
+    elclass.SetSize (ne);
+    for (size_t i = 0; i < ne; i++)
+      {
+        elclass[i] = -1;
+        if (ndof[i] == 0) continue;
+        ELEMENT_TYPE et = ma->GetElType (ElementId(VOL, i));
+        auto key = make_tuple (int(et), order[i], ndof[i], vcode[i]);
+        auto pos = classnr.find (key);
+        if (pos == classnr.end())
+          {
+            pos = classnr.emplace (key, classes.Size()).first;
+            auto cls = make_shared<ElementClass>();
+            cls->et = et;
+            cls->ndof = ndof[i];
+            classes.Append (cls);
+          }
+        elclass[i] = pos->second;
+        classes[pos->second]->elements.Append (i);
+      }
+
+    ParallelFor (classes.Size(), [&] (size_t c)
+                 {
+                   LocalHeap lh = clh.Split();
+                   auto & cls = *classes[c];
+                   ElementId ei(VOL, cls.elements[0]);
+                   auto & fel = static_cast<const BaseScalarFiniteElement&> (fes->GetFE (ei, lh));
+                   int nd = cls.ndof;
+
+                   const IntegrationRule & ir =
+                     SelectIntegrationRule (cls.et, VolumeOrder (cls.et, fel.Order(), bonus_intorder));
+                   size_t nip = ir.Size();
+                   cls.shape.SetSize (nip, nd);
+                   cls.dshapet.SetSize (nd, dim*nip);
+                   FlatMatrix<> dshape(nd, dim, lh);
+                   for (size_t q = 0; q < nip; q++)
+                     {
+                       fel.CalcShape (ir[q], cls.shape.Row(q));
+                       fel.CalcDShape (ir[q], dshape);
+                       for (int k = 0; k < dim; k++)
+                         cls.dshapet.Col(k*nip+q) = dshape.Col(k);
+                     }
+
+                   // the same facet points as seen from both neighbours
+                   ArrayMem<int,8> vnums;
+                   vnums = ma->GetElVertices (ei);
+                   Facet2ElementTrafo transform(cls.et, vnums);
+                   int nf = ElementTopology::GetNFacets (cls.et);
+                   cls.facetshape.SetSize (nf);
+                   cls.facetshapet.SetSize (nf);
+                   cls.facetoffset.SetSize (nf+1);
+                   cls.facetoffset[0] = 0;
+                   for (int k = 0; k < nf; k++)
+                     {
+                       HeapReset hr(lh);
+                       ELEMENT_TYPE etfacet = ElementTopology::GetFacetType (cls.et, k);
+                       const IntegrationRule & ir_facet = SelectIntegrationRule (etfacet, facetorder);
+                       IntegrationRule & ir_facet_vol = transform(k, ir_facet, lh);
+                       auto & fshape = cls.facetshape[k];
+                       fshape.SetSize (ir_facet.Size(), nd);
+                       for (size_t q = 0; q < ir_facet.Size(); q++)
+                         fel.CalcShape (ir_facet_vol[q], fshape.Row(q));
+                       cls.facetshapet[k].SetSize (nd, ir_facet.Size());
+                       cls.facetshapet[k] = Trans (fshape);
+                       cls.facetoffset[k+1] = cls.facetoffset[k] + ir_facet.Size();
+                     }
+                 });
+
+    // batches of elements of one class
+    elblock.SetSize (ne);
+    elcol.SetSize (ne);
+    size_t nvol = 0, nfp = 0, nfacets = 0;
+    for (int c : Range(classes))
+      {
+        auto & cls = *classes[c];
+        size_t nip = cls.shape.Height(), nipf = cls.facetoffset.Last(), nf = cls.facetshape.Size();
+        size_t perel = (dim+1) * nip + 2 * nipf + 2 * cls.ndof;
+        int bs = max2 (1, min2 (64, int(20000 / perel)));
+        for (int first = 0; first < cls.elements.Size(); first += bs)
+          {
+            int next = min2 (first+bs, int(cls.elements.Size()));
+            for (int j = first; j < next; j++)
+              {
+                elblock[cls.elements[j]] = blocks.Size();
+                elcol[cls.elements[j]] = j-first;
+              }
+            blocks.Append (Block { c, first, next, nvol, nfp, nfacets });
+            size_t nb = next-first;
+            nvol += dim * nip * nb;
+            nfp += nipf * nb;
+            nfacets += nf * nb;
+            heapsize = max2 (heapsize, sizeof(double) * perel * nb + 1024);
+          }
+      }
+    ntraces = nfp;
+    volwind.SetSize (nvol);
+    upwind_own.SetSize (nfp);
+    upwind_other.SetSize (nfp);
+    neighbour_trace.SetSize (nfacets);
+    neighbour_stride.SetSize (nfacets);
+
+    TableCreator<int> creator(ne);
+    for ( ; !creator.Done(); creator++)
+      ParallelForRange (ne, [&] (IntRange r)
+                        {
+                          Array<DofId> dnums;
+                          for (size_t i : r)
+                            if (elclass[i] != -1)
+                              {
+                                fes->GetDofNrs (ElementId(VOL, i), dnums);
+                                for (auto d : dnums)
+                                  creator.Add (i, d);
+                              }
+                        });
+    eldofs = creator.MoveTable();
+
+    // geometry of the elements, and the neighbour across every facet
+    atomic<bool> nonmatching(false);
+    ParallelForRange (ne, [&] (IntRange r)
+                      {
+                        LocalHeap lh = clh.Split();
+                        Array<int> elnums;
+                        ArrayMem<int,8> vnums;
+                        for (size_t i : r)
+                          {
+                            if (elclass[i] == -1) continue;
+                            HeapReset hr(lh);
+                            auto & cls = *classes[elclass[i]];
+                            const Block & block = blocks[elblock[i]];
+                            size_t nb = block.next-block.first, j = elcol[i];
+                            ElementId ei(VOL, i);
+                            auto & trafo = ma->GetTrafo (ei, lh);
+
+                            const IntegrationRule & ir =
+                              SelectIntegrationRule (cls.et, VolumeOrder (cls.et, order[i], bonus_intorder));
+                            auto & mir = trafo(ir, lh);
+                            FlatVector<> bvol(dim*ir.Size(), lh);
+                            switch (dim)
+                              {
+                              case 1: CalcVolumeWind<1> (*wind, mir, bvol, lh); break;
+                              case 2: CalcVolumeWind<2> (*wind, mir, bvol, lh); break;
+                              case 3: CalcVolumeWind<3> (*wind, mir, bvol, lh); break;
+                              }
+                            for (size_t l : Range(bvol))
+                              volwind[block.vol + l*nb + j] = bvol(l);
+
+                            vnums = ma->GetElVertices (ei);
+                            Facet2ElementTrafo transform(cls.et, vnums);
+                            auto fnums = ma->GetElFacets (ei);
+                            for (int k : Range(cls.facetshape))
+                              {
+                                HeapReset hr(lh);
+                                ELEMENT_TYPE etfacet = ElementTopology::GetFacetType (cls.et, k);
+                                const IntegrationRule & ir_facet = SelectIntegrationRule (etfacet, facetorder);
+                                IntegrationRule & ir_facet_vol = transform(k, ir_facet, lh);
+                                auto & fmir = trafo(ir_facet_vol, lh);
+                                FlatVector<> bn(ir_facet.Size(), lh);
+                                switch (dim)
+                                  {
+                                  case 1: CalcFacetWind<1> (*wind, ir_facet, fmir, cls.et, k, bn, lh); break;
+                                  case 2: CalcFacetWind<2> (*wind, ir_facet, fmir, cls.et, k, bn, lh); break;
+                                  case 3: CalcFacetWind<3> (*wind, ir_facet, fmir, cls.et, k, bn, lh); break;
+                                  }
+
+                                int facet = fnums[k], facet2 = facet;
+                                int nbel = -1;
+                                ma->GetFacetElements (facet, elnums);
+                                if (elnums.Size() == 2)
+                                  nbel = (elnums[0] == int(i)) ? elnums[1] : elnums[0];
+                                else
+                                  {
+                                    facet2 = ma->GetPeriodicFacet (facet);
+                                    if (facet2 != facet)
+                                      {
+                                        ma->GetFacetElements (facet2, elnums);
+                                        if (elnums.Size() == 1)
+                                          nbel = elnums[0];
+                                      }
+                                  }
+                                if (nbel != -1 && elclass[nbel] == -1)
+                                  nbel = -1;
+
+                                // without neighbour the own trace with weight 0
+                                size_t own = block.trace + cls.facetoffset[k]*nb + j;
+                                size_t & nbtrace = neighbour_trace[block.facets + k*nb + j];
+                                size_t & nbstride = neighbour_stride[block.facets + k*nb + j];
+                                nbtrace = own;
+                                nbstride = nb;
+                                if (nbel != -1)
+                                  {
+                                    auto & nbcls = *classes[elclass[nbel]];
+                                    const Block & nbblock = blocks[elblock[nbel]];
+                                    ElementId nbei(VOL, nbel);
+                                    int knb = ma->GetElFacets(nbei).Pos(facet2);
+                                    if (nbcls.facetshape[knb].Height() != ir_facet.Size())
+                                      nonmatching = true;
+                                    nbstride = nbblock.next-nbblock.first;
+                                    nbtrace = nbblock.trace + nbcls.facetoffset[knb]*nbstride + elcol[nbel];
+
+                                    // periodic neighbours: the points must differ by one translation
+                                    if (facet2 != facet && !nonmatching)
+                                      {
+                                        auto & nbtrafo = ma->GetTrafo (nbei, lh);
+                                        ArrayMem<int,8> nbvnums;
+                                        nbvnums = ma->GetElVertices (nbei);
+                                        Facet2ElementTrafo nbtransform(nbcls.et, nbvnums);
+                                        IntegrationRule & ir_nb = nbtransform(knb, ir_facet, lh);
+                                        auto & nbmir = nbtrafo(ir_nb, lh);
+                                        Vec<3> shift = 0.0;
+                                        double h = 0;
+                                        for (size_t q = 0; q < ir_facet.Size(); q++)
+                                          for (int d = 0; d < dim; d++)
+                                            {
+                                              double diff = nbmir[q].GetPoint()(d) - fmir[q].GetPoint()(d);
+                                              if (q == 0) shift(d) = diff;
+                                              h = max2 (h, fabs (diff-shift(d)));
+                                            }
+                                        if (h > 1e-8 * (1+L2Norm(shift)))
+                                          nonmatching = true;
+                                      }
+                                  }
+
+                                for (size_t q = 0; q < ir_facet.Size(); q++)
+                                  {
+                                    upwind_own[own + q*nb] = max2 (bn(q), 0.0);
+                                    upwind_other[own + q*nb] = (nbel != -1) ? min2 (bn(q), 0.0) : 0.0;
+                                  }
+                              }
+                          }
+                      });
+    if (nonmatching)
+      throw Exception ("DGConvectionOperator: facet integration points don't match");
+  }
+
+
+  AutoVector DGConvectionOperator :: CreateVector () const
+  {
+    return make_shared<VVector<double>> (fes->GetNDof());
+  }
+
+
+  void DGConvectionOperator :: Mult (const BaseVector & x, BaseVector & y) const
+  {
+    y = 0.0;
+    MultAdd (1, x, y);
+  }
+
+
+  void DGConvectionOperator :: MultAdd (double s, const BaseVector & x, BaseVector & y) const
+  {
+    static Timer t("DGConvectionOperator::MultAdd");
+    static Timer tvol("DGConvectionOperator::MultAdd - volume");
+    static Timer tfacet("DGConvectionOperator::MultAdd - facets");
+    RegionTimer reg(t);
+
+    auto fx = x.FV<double>();
+    auto fy = y.FV<double>();
+    Array<double> traces(ntraces);
+    LocalHeap heap(heapsize * TaskManager::GetNumThreads(), "DGConvectionOperator::MultAdd", true);
+
+    // volume terms, and the traces on all facets
+    tvol.Start();
+    ParallelFor (blocks.Size(), [&] (size_t bnr)
+                 {
+                   LocalHeap lh = heap.Split();
+                   const Block & block = blocks[bnr];
+                   auto & cls = *classes[block.cls];
+                   FlatArray<int> els = cls.elements.Range (block.first, block.next);
+                   size_t nb = els.Size(), nd = cls.ndof, nip = cls.shape.Height();
+
+                   FlatMatrix<> c(nd, nb, lh);
+                   for (size_t j : Range(els))
+                     {
+                       FlatArray<int> dnums = eldofs[els[j]];
+                       for (size_t l = 0; l < nd; l++)
+                         c(l,j) = fx(dnums[l]);
+                     }
+
+                   FlatMatrix<> u(nip, nb, lh);
+                   FlatMatrix<> g(dim*nip, nb, lh);
+                   FlatMatrix<> yel(nd, nb, lh);
+                   FlatMatrix<> bvol(dim*nip, nb, &volwind[block.vol]);
+                   MultMatMat (cls.shape, c, u);
+                   for (int k = 0; k < dim; k++)
+                     for (size_t q = 0; q < nip; q++)
+                       g.Row(k*nip+q) = pw_mult (bvol.Row(k*nip+q), u.Row(q));
+                   MultMatMat (cls.dshapet, g, yel);
+
+                   for (size_t j : Range(els))
+                     {
+                       FlatArray<int> dnums = eldofs[els[j]];
+                       for (size_t l = 0; l < nd; l++)
+                         fy(dnums[l]) += s * yel(l,j);
+                     }
+
+                   for (int k : Range(cls.facetshape))
+                     {
+                       FlatMatrix<> tr(cls.facetshape[k].Height(), nb,
+                                       &traces[block.trace + cls.facetoffset[k]*nb]);
+                       MultMatMat (cls.facetshape[k], c, tr);
+                     }
+                 });
+    tvol.Stop();
+
+    // upwind fluxes, every element adds only to its own dofs
+    tfacet.Start();
+    ParallelFor (blocks.Size(), [&] (size_t bnr)
+                 {
+                   LocalHeap lh = heap.Split();
+                   const Block & block = blocks[bnr];
+                   auto & cls = *classes[block.cls];
+                   FlatArray<int> els = cls.elements.Range (block.first, block.next);
+                   size_t nb = els.Size(), nd = cls.ndof;
+
+                   FlatMatrix<> yel(nd, nb, lh);
+                   FlatMatrix<> hyel(nd, nb, lh);
+                   yel = 0.0;
+                   for (int k : Range(cls.facetshape))
+                     {
+                       size_t nipf = cls.facetshape[k].Height();
+                       size_t first = block.trace + cls.facetoffset[k]*nb;
+                       FlatMatrix<> flux(nipf, nb, lh);
+                       FlatMatrix<> tr(nipf, nb, &traces[first]);
+                       FlatMatrix<> wown(nipf, nb, &upwind_own[first]);
+                       FlatMatrix<> wother(nipf, nb, &upwind_other[first]);
+                       flux = pw_mult (wown, tr);
+                       for (size_t j = 0; j < nb; j++)
+                         {
+                           size_t other = neighbour_trace[block.facets + k*nb + j];
+                           size_t stride = neighbour_stride[block.facets + k*nb + j];
+                           for (size_t q = 0; q < nipf; q++)
+                             flux(q,j) += wother(q,j) * traces[other + q*stride];
+                         }
+                       MultMatMat (cls.facetshapet[k], flux, hyel);
+                       yel += hyel;
+                     }
+
+                   for (size_t j : Range(els))
+                     {
+                       FlatArray<int> dnums = eldofs[els[j]];
+                       for (size_t l = 0; l < nd; l++)
+                         fy(dnums[l]) += s * yel(l,j);
+                     }
+                 });
+    tfacet.Stop();
+  }
+
+}
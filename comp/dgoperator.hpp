@@ -0,0 +1,104 @@
+#ifndef FILE_DGOPERATOR
+#define FILE_DGOPERATOR
+
+/*********************************************************************/
+/* File:   dgoperator.hpp                                            */
+/* Date:   Oct. 2026                                                 */
+/*********************************************************************/
+
+namespace ngcomp
+{
+
+  /**
+     Matrix-free upwind DG operator for linear transport in an
+     L2HighOrderFESpace:
+
+     (A u, v) = - \int_T u b \cdot \nabla v + \int_{\partial T} b \cdot n \, u^{up} v
+
+     with zero inflow on the boundary, and periodic facets connected.
+     This is the operator of the symbolic forms
+
+     -u*b*grad(v)  and  bn*IfPos(bn, u, u.Other(bnd=0))*v  (element_boundary=True)
+
+     All geometry is precomputed: the wind times weights and Jacobians
+     in the volume points, and the upwind weights max(b.n,0) and
+     min(b.n,0) times facet weights in the facet points. Elements with
+     the same type, order and vertex ordering share the shape functions
+     and the facet-to-element maps of the integration points, they are
+     processed in batches with dense matrix-matrix products. All point
+     data of a batch is stored point by point with the elements of the
+     batch contiguous, so the pointwise products are plain vector loops
+     and the facet traces are the results of the matrix products.
+     The application first evaluates all facet traces, the fluxes are
+     then computed batch by batch without write conflicts.
+
+     Only this operator is covered, general symbolic facet forms still
+     go through the BilinearForm. The application allocates its
+     temporaries per call, so it may be used concurrently.
+   */
+  class NGS_DLL_HEADER DGConvectionOperator : public BaseMatrix
+  {
+    /// shape functions of all elements of one class
+    struct ElementClass
+    {
+      ELEMENT_TYPE et;
+      int ndof;
+      /// volume points x ndof, and ndof x dim*volume points
+      Matrix<double> shape, dshapet;
+      /// per facet: facet points x ndof, and the transpose
+      Array<Matrix<double>> facetshape, facetshapet;
+      /// first point of each facet in the facet points of an element
+      Array<int> facetoffset;
+      Array<int> elements;
+    };
+
+    /**
+       Elements first ... next of one class. The point data of the
+       block are matrices (points x elements of the block) starting
+       at vol in volwind, and at trace in the traces and the upwind
+       weights. The neighbour traces of facet k of element j are at
+       facets + k*nb + j.
+     */
+    struct Block
+    {
+      int cls;
+      int first, next;
+      size_t vol, trace, facets;
+    };
+
+    shared_ptr<L2HighOrderFESpace> fes;
+    shared_ptr<CoefficientFunction> wind;
+    int dim;
+    Array<shared_ptr<ElementClass>> classes;
+    Array<Block> blocks;
+    /// class of every element, -1 for elements without dofs
+    Array<int> elclass;
+    /// block and column in the block of every element
+    Array<int> elblock, elcol;
+    Table<int> eldofs;
+    Array<double> volwind;
+    Array<double> upwind_own, upwind_other;
+    /// first trace point of the neighbour, and the distance of its points
+    Array<size_t> neighbour_trace, neighbour_stride;
+    size_t ntraces = 0;
+    /// heap needed per thread for one block
+    size_t heapsize = 0;
+
+  public:
+    DGConvectionOperator (shared_ptr<FESpace> afes, shared_ptr<CoefficientFunction> awind,
+                          int bonus_intorder = 0);
+
+    virtual int VHeight() const override { return fes->GetNDof(); }
+    virtual int VWidth() const override { return fes->GetNDof(); }
+    virtual AutoVector CreateVector () const override;
+
+    virtual void Mult (const BaseVector & x, BaseVector & y) const override;
+    virtual void MultAdd (double s, const BaseVector & x, BaseVector & y) const override;
+
+    /// number of classes of elements sharing shape functions
+    size_t GetNClasses () const { return classes.Size(); }
+  };
+
+}
+
+#endif
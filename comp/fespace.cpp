@@ -670,8 +670,10 @@ lot of new non-zero entries in the matrix!\n" << endl;
       }
       }
     
-    // invalidate facet_coloring
+    // invalidate facet_coloring and element task-graphs
     facet_coloring = Table<int>();
+    for (auto & graph : element_taskgraph)
+      graph = ElementTaskGraph();
        
     level_updated = ma->GetNLevels();
     if (timing) Timing();
@@ -765,6 +767,112 @@ lot of new non-zero entries in the matrix!\n" << endl;
 
     return facet_coloring;
   }
+
+
+  const ElementTaskGraph & FESpace :: GetElementTaskGraph (VorB vb) const
+  {
+    ElementTaskGraph & graph = const_cast<ElementTaskGraph&> (element_taskgraph[vb]);
+    if (graph.chunks.Size()) return graph;
+
+    static Timer t ("FESpace::GetElementTaskGraph");
+    RegionTimer reg(t);
+
+    Array<int> els;
+    for (ElementId el : Elements(vb))
+      els.Append (el.Nr());
+    if (els.Size() == 0) return graph;
+
+    // consecutive elements are neighbours for netgen meshes, so small
+    // chunks keep the conflict graph sparse
+    size_t chunksize = els.Size() / (32*TaskManager::GetMaxThreads()) + 1;
+    chunksize = min(chunksize, size_t(256));
+    size_t nchunks = (els.Size()+chunksize-1) / chunksize;
+
+    Array<int> cnt(nchunks);
+    for (size_t c : Range(nchunks))
+      cnt[c] = min(chunksize, els.Size()-c*chunksize);
+    graph.chunks = Table<int> (cnt);
+    for (size_t c : Range(nchunks))
+      graph.chunks[c] = els.Range(c*chunksize, c*chunksize+cnt[c]);
+
+    // dof -> chunks touching it
+    TableCreator<int> creator(GetNDof());
+    for ( ; !creator.Done(); creator++)
+      ParallelFor (nchunks, [&] (size_t c)
+                   {
+                     Array<DofId> dofs;
+                     for (int elnr : graph.chunks[c])
+                       {
+                         GetDofNrs (ElementId(vb, elnr), dofs);
+                         for (auto d : dofs)
+                           if (d != -1 && !(HasAtomicDofs() && IsAtomicDof(d)))
+                             creator.Add (d, c);
+                       }
+                   });
+    Table<int> dof2chunk = creator.MoveTable();
+
+    Array<size_t> mark(nchunks);
+    mark = size_t(-1);
+    size_t stamp = 0;
+    Array<DofId> dofs;
+    auto IterateNeighbours = [&] (size_t c, auto func)
+      {
+        stamp++;
+        for (int elnr : graph.chunks[c])
+          {
+            GetDofNrs (ElementId(vb, elnr), dofs);
+            for (auto d : dofs)
+              {
+                if (d == -1 || (HasAtomicDofs() && IsAtomicDof(d))) continue;
+                for (size_t c2 : dof2chunk[d])
+                  if (c2 != c && mark[c2] != stamp)
+                    {
+                      mark[c2] = stamp;
+                      func (c2);
+                    }
+              }
+          }
+      };
+
+    // greedy coloring of the chunk graph. Conflicting chunks are ordered by
+    // (color, number), so the longest path is bounded by the number of colors
+    Array<int> col(nchunks);
+    Array<int> usedcol;
+    int maxcolor = 0;
+    for (size_t c : Range(nchunks))
+      {
+        usedcol.SetSize0();
+        IterateNeighbours (c, [&] (size_t c2)
+                           {
+                             if (c2 < c) usedcol.Append (col[c2]);
+                           });
+        int color = 0;
+        while (usedcol.Contains(color)) color++;
+        col[c] = color;
+        maxcolor = max(maxcolor, color);
+      }
+
+    TableCreator<int> dag_creator(nchunks), trans_creator(nchunks);
+    for ( ; !dag_creator.Done(); dag_creator++, trans_creator++)
+      for (size_t c : Range(nchunks))
+        IterateNeighbours (c, [&] (size_t c2)
+                           {
+                             if (col[c2] > col[c] || (col[c2] == col[c] && c2 > c))
+                               {
+                                 dag_creator.Add (c, c2);
+                                 trans_creator.Add (c2, c);
+                               }
+                           });
+
+    graph.dag = dag_creator.MoveTable();
+    graph.trans_dag = trans_creator.MoveTable();
+
+    if (print)
+      *testout << "element task-graph: " << nchunks << " chunks of size " << chunksize
+               << ", critical path <= " << maxcolor+1
+               << " for " << ((vb == VOL) ? "vol" : "bnd") << endl;
+    return graph;
+  }
   
 
   // FiniteElement & FESpace :: GetFE (ElementId ei, Allocator & alloc) const
@@ -1461,6 +1569,96 @@ lot of new non-zero entries in the matrix!\n" << endl;
   }
   
 
+  void IterateElementsTaskGraph (const FESpace & fes, 
+                                 VorB vb, 
+                                 LocalHeap & clh, 
+                                 const function<void(FESpace::Element,LocalHeap&)> & func)
+  {
+    const ElementTaskGraph & graph = fes.GetElementTaskGraph(vb);
+    const Table<int> & chunks = graph.chunks;
+    size_t nchunks = chunks.Size();
+
+    if (!task_manager)
+      {
+        // single-threaded, any order is conflict free
+        Array<int> temp_dnums;
+        for (auto chunk : chunks)
+          for (int elnr : chunk)
+            {
+              HeapReset hr(clh);
+              FESpace::Element el(fes, ElementId (vb, elnr), temp_dnums, clh);
+              func (move(el), clh);
+            }
+        return;
+      }
+
+    Array<atomic<int>> cnt_dep(nchunks);
+    for (auto i : Range(cnt_dep))
+      cnt_dep[i].store (graph.trans_dag[i].Size(), memory_order_relaxed);
+
+    // every chunk is queued exactly once, so a fixed-size array does it
+    Array<int> queue(nchunks);
+    Array<atomic<bool>> queued(nchunks);
+    for (auto & q : queued) q.store (false, memory_order_relaxed);
+    atomic<size_t> wcnt(0), rcnt(0);
+
+    auto Push = [&] (int c)
+      {
+        size_t pos = wcnt++;
+        queue[pos] = c;
+        queued[pos].store (true, memory_order_release);
+      };
+
+    for (auto c : Range(nchunks))
+      if (cnt_dep[c] == 0) Push (c);
+
+    static mutex copyex_mutex;
+    Exception * ex = nullptr;
+
+    task_manager -> CreateJob
+      ( [&] (const TaskInfo & ti) 
+        {
+          LocalHeap lh = clh.Split(ti.thread_nr, ti.nthreads);
+          ArrayMem<int,100> temp_dnums;
+
+          while (true)
+            {
+              size_t pos = rcnt++;
+              if (pos >= nchunks) break;
+              // the slot is filled as soon as all its predecessors are done
+              while (!queued[pos].load (memory_order_acquire)) ;
+              int c = queue[pos];
+
+              for (int elnr : chunks[c])
+                try
+                  {
+                    HeapReset hr(lh);
+                    FESpace::Element el(fes, ElementId (vb, elnr), temp_dnums, lh);
+                    func (move(el), lh);
+                  }
+                catch (const Exception & e)
+                  {
+                    lock_guard<mutex> guard(copyex_mutex);
+                    if (!ex) ex = new Exception (e);
+                  }
+              
+              for (int j : graph.dag[c])
+                if (--cnt_dep[j] == 0)
+                  Push (j);
+            }
+
+          ProgressOutput::SumUpLocal();
+        } );
+
+    if (ex)
+      {
+        Exception e(*ex);
+        delete ex;
+        throw e;
+      }
+  }
+  
+
   // Aendern, Bremse!!!
   template < int S, class T >
   void FESpace :: TransformVec (int elnr, VorB vb,
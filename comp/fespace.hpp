@@ -73,6 +73,21 @@ ANY                  1 1 1 1 | 15
 
   using ngmg::Prolongation;
 
+  /**
+     Elements grouped into chunks, and a dependency DAG between chunks
+     sharing (non-atomic) dofs. Chunks without a path between them can be
+     assembled concurrently, so there is no barrier between colors.
+  */
+  struct ElementTaskGraph
+  {
+    /// element numbers of every chunk
+    Table<int> chunks;
+    /// chunks which have to wait for chunk i
+    Table<int> dag;
+    /// chunks chunk i has to wait for
+    Table<int> trans_dag;
+  };
+
   /**
      Base class for finite element space.
      Provides finite elements, global degrees of freedom, 
@@ -168,6 +183,7 @@ ANY                  1 1 1 1 | 15
     
     Table<int> element_coloring[4]; 
     Table<int> facet_coloring;  // elements on facet in own colors (DG)
+    ElementTaskGraph element_taskgraph[4];  // built on demand
     Array<COUPLING_TYPE> ctofdof;
 
     shared_ptr<ParallelDofs> paralleldofs;
@@ -250,6 +266,9 @@ ANY                  1 1 1 1 | 15
     { return element_coloring[vb]; }
 
     const Table<int> & FacetColoring() const;
+
+    /// element chunks ordered by a dependency DAG of dof-conflicts (built on demand)
+    const ElementTaskGraph & GetElementTaskGraph (VorB vb = VOL) const;
     
     /// print report to stream
     virtual void PrintReport (ostream & ost) const;
@@ -863,6 +882,12 @@ ANY                  1 1 1 1 | 15
 			       VorB vb, 
 			       LocalHeap & clh, 
 			       const function<void(FESpace::Element,LocalHeap&)> & func);
+
+  /// as IterateElements, but runs along FESpace::GetElementTaskGraph instead of colors
+  extern NGS_DLL_HEADER void IterateElementsTaskGraph (const FESpace & fes,
+                                                       VorB vb, 
+                                                       LocalHeap & clh, 
+                                                       const function<void(FESpace::Element,LocalHeap&)> & func);
   /*
   template <typename TFUNC>
   inline void IterateElements (const FESpace & fes, 
@@ -4,6 +4,13 @@
 #include <parallelngs.hpp>
 #include <stdlib.h>
 
+#ifndef WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 using namespace ngcomp; 
 
 
@@ -776,6 +783,472 @@ namespace ngcomp
 
 
 
+  /*
+    Binary checkpoint, one file per MPI rank:
+
+      CheckpointHeader
+      for vertices, edges, faces, cells:
+        keys    nnodes x N sorted global vertex numbers (N = 1, 2, 4, 8)
+        ndofs   nnodes ints, number of values of the node
+      values    multidim x ndata scalars in the order of the keys
+
+    Sections start at multiples of 16 bytes. Nodes are identified by their
+    vertices, the keys of a file are sorted. Every rank writes the nodes of
+    its master dofs, so a checkpoint can be loaded with a different number
+    of ranks. The header holds the bounding box of the vertices of the
+    nodes of the file, a rank reads keys and values only from files whose
+    box meets the box of its own nodes.
+  */
+  struct CheckpointHeader
+  {
+    char magic[8];
+    int version;
+    int iscomplex;
+    int dim;
+    int order;
+    int multidim;
+    int nchunks;
+    size_t ndof;
+    size_t meshhash;
+    size_t nnodes[4];
+    size_t ndata;
+    double pmin[3], pmax[3];
+    char spacetype[64];
+  };
+
+  static constexpr int checkpoint_version = 2;
+
+  static size_t CheckpointAlign (size_t size) { return (size+15) / 16 * 16; }
+
+  static string CheckpointChunkName (const string & filename, int chunk, int nchunks)
+  {
+    return (nchunks == 1) ? filename : filename + "." + ToString(chunk);
+  }
+
+  static int CheckpointVertexNr (const MeshAccess & ma, int v)
+  {
+    if (MyMPI_GetNTasks() == 1) return v;
+    return ma.GetGlobalNodeNum (NodeId(NT_VERTEX, v));
+  }
+
+  /*
+    Hash of the vertex numbers and coordinates, independent of the
+    partitioning. A vertex is counted by the lowest rank holding it.
+  */
+  static size_t CheckpointMeshHash (const MeshAccess & ma)
+  {
+    int id = MyMPI_GetId(), ntasks = MyMPI_GetNTasks();
+    size_t hash = 0;
+    if (ntasks == 1 || id > 0)
+      for (size_t v = 0; v < ma.GetNV(); v++)
+        {
+          bool owner = true;
+          for (int p : ma.GetDistantProcs (NodeId(NT_VERTEX, v)))
+            if (p > 0 && p < id) owner = false;
+          if (!owner) continue;
+
+          size_t h = CheckpointVertexNr (ma, v) + 1;
+          Vec<3> p = ma.GetPoint<3> (v);
+          for (int k = 0; k < 3; k++)
+            h = h * 1000003 + size_t(int64_t(round (p(k) * (1 << 20))));
+          // splitmix64 finalizer
+          h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ull;
+          h = (h ^ (h >> 27)) * 0x94d049bb133111ebull;
+          hash += h ^ (h >> 31);
+        }
+    return MyMPI_AllReduce (hash, MPI_SUM);
+  }
+
+  /*
+    Nodes of type nt with dofs, and their keys, sorted by the keys.
+    With master_only, only nodes of master dofs of this rank.
+    pmin and pmax are extended by the vertices of these nodes.
+  */
+  template <int N>
+  static void CheckpointNodes (const MeshAccess & ma, const FESpace & fes, NODE_TYPE nt,
+                               bool master_only,
+                               Array<Vec<N,int>> & keys, Array<int> & nodes,
+                               Vec<3> & pmin, Vec<3> & pmax)
+  {
+    Array<Vec<N,int>> hkeys;
+    Array<int> hnodes;
+    Array<DofId> dnums;
+    Array<int> pnums;
+
+    for (size_t i = 0; i < ma.GetNNodes(nt); i++)
+      {
+        fes.GetDofNrs (NodeId(nt, i), dnums);
+        if (dnums.Size() == 0) continue;
+#ifdef PARALLEL
+        shared_ptr<ParallelDofs> par = fes.GetParallelDofs();
+        if (master_only && par && !par->IsMasterDof (dnums[0])) continue;
+#endif
+
+        switch (nt)
+          {
+          case NT_VERTEX: pnums.SetSize(1); pnums[0] = i; break;
+          case NT_EDGE: pnums = ma.GetEdgePNums (i); break;
+          case NT_FACE: pnums = ma.GetFacePNums (i); break;
+          case NT_CELL: pnums = ma.GetElVertices (ElementId(VOL,i)); break;
+          default:
+            __assume(false);
+          }
+
+        Vec<N,int> key;
+        key = -1;
+        for (int j = 0; j < pnums.Size(); j++)
+          {
+            key[j] = CheckpointVertexNr (ma, pnums[j]);
+            Vec<3> p = ma.GetPoint<3> (pnums[j]);
+            for (int k = 0; k < 3; k++)
+              {
+                pmin(k) = min2 (pmin(k), p(k));
+                pmax(k) = max2 (pmax(k), p(k));
+              }
+          }
+        // independent of the local orientation
+        QuickSort (FlatArray<int> (pnums.Size(), &key[0]));
+        hkeys.Append (key);
+        hnodes.Append (i);
+      }
+
+    Array<int> index(hkeys.Size());
+    for (int i = 0; i < index.Size(); i++) index[i] = i;
+    QuickSortI (hkeys, index, MyLess<N>);
+
+    keys.SetSize (hkeys.Size());
+    nodes.SetSize (hkeys.Size());
+    for (int i = 0; i < index.Size(); i++)
+      {
+        keys[i] = hkeys[index[i]];
+        nodes[i] = hnodes[index[i]];
+      }
+  }
+
+  template <typename T>
+  static void CheckpointWrite (ostream & ost, FlatArray<T> a)
+  {
+    size_t size = a.Size()*sizeof(T);
+    if (size)
+      ost.write (reinterpret_cast<const char*> (&a[0]), size);
+    char zeros[16] = { 0 };
+    ost.write (zeros, CheckpointAlign(size)-size);
+  }
+
+
+  /*
+    Read access to a checkpoint file, memory mapped or by reading.
+  */
+  class CheckpointFile
+  {
+    string name;
+    ifstream ist;
+    const char * mapped = nullptr;
+    size_t size = 0;
+#ifndef WIN32
+    int fd = -1;
+#endif
+
+  public:
+    CheckpointFile (const string & aname, bool memory_map)
+      : name(aname)
+    {
+#ifndef WIN32
+      if (memory_map)
+        {
+          fd = open (name.c_str(), O_RDONLY);
+          if (fd == -1)
+            throw Exception ("LoadCheckpoint: cannot open file " + name);
+          struct stat st;
+          fstat (fd, &st);
+          size = st.st_size;
+          void * ptr = mmap (nullptr, max2(size, size_t(1)), PROT_READ, MAP_PRIVATE, fd, 0);
+          if (ptr == MAP_FAILED)
+            {
+              close (fd);
+              throw Exception ("LoadCheckpoint: mmap failed for " + name);
+            }
+          mapped = static_cast<const char*> (ptr);
+          return;
+        }
+#endif
+      ist.open (name, ios::binary);
+      if (!ist)
+        throw Exception ("LoadCheckpoint: cannot open file " + name);
+      ist.seekg (0, ios::end);
+      size = ist.tellg();
+    }
+
+    ~CheckpointFile ()
+    {
+#ifndef WIN32
+      if (mapped)
+        {
+          munmap (const_cast<char*>(mapped), max2(size, size_t(1)));
+          close (fd);
+        }
+#endif
+    }
+
+    /// n values at offset, in the mapped memory or read into buffer
+    template <typename T>
+    FlatArray<T> Get (size_t offset, size_t n, Array<T> & buffer)
+    {
+      if (offset + n*sizeof(T) > size)
+        throw Exception ("LoadCheckpoint: file " + name + " is truncated");
+      if (mapped)
+        return FlatArray<T> (n, (T*)(mapped+offset));
+      buffer.SetSize (n);
+      ist.seekg (offset);
+      if (n)
+        ist.read (reinterpret_cast<char*> (&buffer[0]), n*sizeof(T));
+      return buffer;
+    }
+  };
+
+
+  template <class SCAL>
+  void S_GridFunction<SCAL> :: SaveCheckpoint (const string & filename) const
+  {
+    static Timer t("GridFunction::SaveCheckpoint"); RegionTimer reg(t);
+    const FESpace & fes = *GetFESpace();
+    int id = MyMPI_GetId(), ntasks = MyMPI_GetNTasks();
+    int dim = fes.GetDimension();
+
+    for (int comp = 0; comp < GetMultiDim(); comp++)
+      GetVector(comp).Cumulate();
+
+    CheckpointHeader header;
+    memset (&header, 0, sizeof(header));
+    strncpy (header.magic, "NGSCKPT", 8);
+    header.version = checkpoint_version;
+    header.iscomplex = is_same<SCAL,Complex>::value;
+    header.dim = dim;
+    header.order = fes.GetOrder();
+    header.multidim = GetMultiDim();
+    header.nchunks = ntasks;
+    header.ndof = fes.GetNDofGlobal();
+    header.meshhash = CheckpointMeshHash (*ma);
+    strncpy (header.spacetype, fes.GetClassName().c_str(), sizeof(header.spacetype)-1);
+
+    Array<Vec<1,int>> keys1; Array<Vec<2,int>> keys2;
+    Array<Vec<4,int>> keys4; Array<Vec<8,int>> keys8;
+    Array<int> nodes[4];
+    Vec<3> pmin(1e99), pmax(-1e99);
+    CheckpointNodes (*ma, fes, NT_VERTEX, true, keys1, nodes[0], pmin, pmax);
+    CheckpointNodes (*ma, fes, NT_EDGE, true, keys2, nodes[1], pmin, pmax);
+    CheckpointNodes (*ma, fes, NT_FACE, true, keys4, nodes[2], pmin, pmax);
+    CheckpointNodes (*ma, fes, NT_CELL, true, keys8, nodes[3], pmin, pmax);
+    for (int k = 0; k < 3; k++)
+      {
+        header.pmin[k] = pmin(k);
+        header.pmax[k] = pmax(k);
+      }
+
+    // values of node i of type nt start at first[nt][i]
+    Array<int> ndofs[4];
+    Array<size_t> first[4];
+    size_t ndata = 0;
+    Array<DofId> dnums;
+    for (int nt = 0; nt < 4; nt++)
+      {
+        header.nnodes[nt] = nodes[nt].Size();
+        ndofs[nt].SetSize (nodes[nt].Size());
+        first[nt].SetSize (nodes[nt].Size());
+        for (size_t i = 0; i < nodes[nt].Size(); i++)
+          {
+            fes.GetDofNrs (NodeId(NODE_TYPE(nt), nodes[nt][i]), dnums);
+            ndofs[nt][i] = dnums.Size()*dim;
+            first[nt][i] = ndata;
+            ndata += ndofs[nt][i];
+          }
+      }
+    header.ndata = ndata;
+
+    Array<SCAL> values(GetMultiDim()*ndata);
+    for (int nt = 0; nt < 4; nt++)
+      ParallelForRange (nodes[nt].Size(), [&] (IntRange r)
+        {
+          Array<DofId> dnums;
+          for (auto i : r)
+            {
+              fes.GetDofNrs (NodeId(NODE_TYPE(nt), nodes[nt][i]), dnums);
+              for (int comp = 0; comp < GetMultiDim(); comp++)
+                GetElementVector (comp, dnums,
+                                  FlatVector<SCAL> (ndofs[nt][i], &values[comp*ndata+first[nt][i]]));
+            }
+        });
+
+    string name = CheckpointChunkName (filename, id, ntasks);
+    ofstream ost(name, ios::binary);
+    if (!ost)
+      throw Exception ("SaveCheckpoint: cannot open file " + name);
+    CheckpointWrite (ost, FlatArray<CheckpointHeader> (1, &header));
+    CheckpointWrite<Vec<1,int>> (ost, keys1); CheckpointWrite<int> (ost, ndofs[0]);
+    CheckpointWrite<Vec<2,int>> (ost, keys2); CheckpointWrite<int> (ost, ndofs[1]);
+    CheckpointWrite<Vec<4,int>> (ost, keys4); CheckpointWrite<int> (ost, ndofs[2]);
+    CheckpointWrite<Vec<8,int>> (ost, keys8); CheckpointWrite<int> (ost, ndofs[3]);
+    CheckpointWrite<SCAL> (ost, values);
+    if (!ost)
+      throw Exception ("SaveCheckpoint: writing to " + name + " failed");
+  }
+
+
+  struct CheckpointMatch
+  {
+    NODE_TYPE nt;
+    int node;       // own node number
+    size_t first;   // first value in the file
+    int ndof;
+  };
+
+  /*
+    Finds the own nodes of type nt in the file, the keys of the file and
+    the own keys are sorted. first is the first value of these nodes in
+    the file.
+  */
+  template <int N>
+  static void MatchCheckpointNodes (const FESpace & fes, NODE_TYPE nt,
+                                    CheckpointFile & file, size_t & offset, size_t nnodes,
+                                    size_t & first,
+                                    FlatArray<Vec<N,int>> keys, FlatArray<int> nodes,
+                                    Array<CheckpointMatch> & matches)
+  {
+    Array<Vec<N,int>> keybuf;
+    Array<int> ndofbuf;
+    FlatArray<Vec<N,int>> fkeys = file.Get (offset, nnodes, keybuf);
+    offset += CheckpointAlign (nnodes*sizeof(Vec<N,int>));
+    FlatArray<int> fndofs = file.Get (offset, nnodes, ndofbuf);
+    offset += CheckpointAlign (nnodes*sizeof(int));
+
+    Array<DofId> dnums;
+    for (size_t i = 0, j = 0; j < nnodes; j++)
+      {
+        while (i < keys.Size() && MyLess<N> (keys[i], fkeys[j])) i++;
+        if (i < keys.Size() && !MyLess<N> (fkeys[j], keys[i]))
+          {
+            fes.GetDofNrs (NodeId(nt, nodes[i]), dnums);
+            if (dnums.Size()*fes.GetDimension() != fndofs[j])
+              throw Exception ("LoadCheckpoint: number of dofs of a node doesn't match");
+            matches.Append (CheckpointMatch { nt, nodes[i], first, fndofs[j] });
+            i++;
+          }
+        first += fndofs[j];
+      }
+  }
+
+
+  template <class SCAL>
+  void S_GridFunction<SCAL> :: LoadCheckpoint (const string & filename, bool memory_map)
+  {
+    static Timer t("GridFunction::LoadCheckpoint"); RegionTimer reg(t);
+    const FESpace & fes = *GetFESpace();
+
+    Array<Vec<1,int>> keys1; Array<Vec<2,int>> keys2;
+    Array<Vec<4,int>> keys4; Array<Vec<8,int>> keys8;
+    Array<int> nodes[4];
+    Vec<3> pmin(1e99), pmax(-1e99);
+    CheckpointNodes (*ma, fes, NT_VERTEX, false, keys1, nodes[0], pmin, pmax);
+    CheckpointNodes (*ma, fes, NT_EDGE, false, keys2, nodes[1], pmin, pmax);
+    CheckpointNodes (*ma, fes, NT_FACE, false, keys4, nodes[2], pmin, pmax);
+    CheckpointNodes (*ma, fes, NT_CELL, false, keys8, nodes[3], pmin, pmax);
+    size_t meshhash = CheckpointMeshHash (*ma);
+
+    // a single file, or one file per rank of the run that saved it
+    string name0 = filename;
+    if (!ifstream(name0))
+      name0 = CheckpointChunkName (filename, 0, 2);
+
+    size_t nfound = 0;
+    int nchunks = 1;
+    for (int chunk = 0; chunk < nchunks; chunk++)
+      {
+        CheckpointFile file(chunk == 0 ? name0 : CheckpointChunkName (filename, chunk, nchunks),
+                            memory_map);
+        Array<CheckpointHeader> hbuf;
+        CheckpointHeader header = file.Get (0, 1, hbuf)[0];
+
+        if (strncmp (header.magic, "NGSCKPT", 8) != 0 || header.version != checkpoint_version)
+          throw Exception ("LoadCheckpoint: " + filename + " is not a checkpoint file of this version");
+        if (header.iscomplex != int(is_same<SCAL,Complex>::value) ||
+            header.dim != fes.GetDimension() || header.order != fes.GetOrder() ||
+            header.ndof != fes.GetNDofGlobal() ||
+            string(header.spacetype) != fes.GetClassName())
+          throw Exception (string("LoadCheckpoint: checkpoint is for a different space, ")
+                           + header.spacetype + " of order " + ToString(header.order)
+                           + " with " + ToString(header.ndof) + " dofs");
+        if (header.multidim != GetMultiDim())
+          throw Exception ("LoadCheckpoint: checkpoint has multidim = " + ToString(header.multidim));
+        if (header.meshhash != meshhash)
+          throw Exception ("LoadCheckpoint: checkpoint is for a different mesh");
+        nchunks = header.nchunks;
+
+        // coordinates in the file are the same as here, no tolerance needed
+        bool disjoint = false;
+        for (int k = 0; k < 3; k++)
+          if (header.pmin[k] > pmax(k) || header.pmax[k] < pmin(k))
+            disjoint = true;
+        if (disjoint) continue;
+
+        Array<CheckpointMatch> matches;
+        size_t offset = CheckpointAlign (sizeof(CheckpointHeader));
+        size_t first = 0;
+        MatchCheckpointNodes<1> (fes, NT_VERTEX, file, offset, header.nnodes[0], first, keys1, nodes[0], matches);
+        MatchCheckpointNodes<2> (fes, NT_EDGE, file, offset, header.nnodes[1], first, keys2, nodes[1], matches);
+        MatchCheckpointNodes<4> (fes, NT_FACE, file, offset, header.nnodes[2], first, keys4, nodes[2], matches);
+        MatchCheckpointNodes<8> (fes, NT_CELL, file, offset, header.nnodes[3], first, keys8, nodes[3], matches);
+        if (matches.Size() == 0) continue;
+        nfound += matches.Size();
+
+        // values of own nodes only, one access per run of consecutive nodes
+        Array<size_t> pos(matches.Size()+1);
+        pos[0] = 0;
+        for (size_t k = 0; k < matches.Size(); k++)
+          pos[k+1] = pos[k] + matches[k].ndof;
+        size_t nown = pos[matches.Size()];
+
+        Array<SCAL> values(GetMultiDim()*nown), valbuf;
+        for (int comp = 0; comp < GetMultiDim(); comp++)
+          for (size_t k = 0; k < matches.Size(); )
+            {
+              size_t k2 = k+1;
+              while (k2 < matches.Size() &&
+                     matches[k2].first == matches[k2-1].first + matches[k2-1].ndof)
+                k2++;
+              FlatArray<SCAL> run =
+                file.Get (offset + (comp*header.ndata+matches[k].first)*sizeof(SCAL),
+                          pos[k2]-pos[k], valbuf);
+              for (size_t l = 0; l < run.Size(); l++)
+                values[comp*nown+pos[k]+l] = run[l];
+              k = k2;
+            }
+
+        ParallelForRange (matches.Size(), [&] (IntRange r)
+          {
+            Array<DofId> dnums;
+            for (auto k : r)
+              {
+                auto & match = matches[k];
+                fes.GetDofNrs (NodeId(match.nt, match.node), dnums);
+                for (int comp = 0; comp < GetMultiDim(); comp++)
+                  {
+                    Vector<SCAL> elvec(match.ndof);
+                    elvec = FlatVector<SCAL> (match.ndof, &values[comp*nown+pos[k]]);
+                    SetElementVector (comp, dnums, elvec);
+                  }
+              }
+          });
+      }
+
+    if (nfound != nodes[0].Size()+nodes[1].Size()+nodes[2].Size()+nodes[3].Size())
+      throw Exception ("LoadCheckpoint: checkpoint doesn't contain all nodes");
+
+    for (int comp = 0; comp < GetMultiDim(); comp++)
+      GetVector(comp).SetParallelStatus (CUMULATED);
+  }
+
+
+
 
 
   template <class SCAL>
@@ -1162,7 +1635,7 @@ namespace ngcomp
         IntegrationPoint rip;
         int elnr2 = ma->FindElementOfPoint 
           // (static_cast<const DimMappedIntegrationPoint<2>&> (ip).GetPoint(),
-          (ip.GetPoint(), rip, true);  // buildtree not yet threadsafe (maybe now ?)
+          (ip.GetPoint(), rip, true);
         if (elnr2 == -1)
           {
             result = 0;
@@ -1226,7 +1699,7 @@ namespace ngcomp
     if (!ip.GetTransformation().BelongsToMesh (ma.get()))
       {
         IntegrationPoint rip;
-        int elnr = ma->FindElementOfPoint(ip.GetPoint(), rip, true); // buildtree not yet threadsafe (maybe now ?)
+        int elnr = ma->FindElementOfPoint(ip.GetPoint(), rip, true);
         if (elnr == -1)
           {
             result = 0;
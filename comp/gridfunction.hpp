@@ -250,6 +250,18 @@ namespace ngcomp
 
     virtual void Load (istream & ist) = 0;
     virtual void Save (ostream & ost) const = 0;
+
+    /**
+       Binary checkpoint of all multidim vectors with a header describing
+       space and mesh. Every MPI rank writes its own file filename.rank,
+       a sequential run the file filename.
+     */
+    virtual void SaveCheckpoint (const string & filename) const = 0;
+    /**
+       Loads a checkpoint, also when saved with a different number of
+       ranks. With memory_map, the files are mapped instead of read.
+     */
+    virtual void LoadCheckpoint (const string & filename, bool memory_map = false) = 0;
   };
 
 
@@ -279,6 +291,9 @@ namespace ngcomp
     virtual void Load (istream & ist);
     virtual void Save (ostream & ost) const;
 
+    virtual void SaveCheckpoint (const string & filename) const;
+    virtual void LoadCheckpoint (const string & filename, bool memory_map = false);
+
   private:
     template <int N, NODE_TYPE NT> void LoadNodeType (istream & ist);
 
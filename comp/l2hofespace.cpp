@@ -242,6 +242,7 @@ namespace ngcomp
 
   void L2HighOrderFESpace :: UpdateDofTables()
   {
+    inverse_mass = nullptr;
     ndof = all_dofs_together ? 0 : nel;
     first_element_dof.SetSize(nel+1);
     for (int i = 0; i < nel; i++)
@@ -617,13 +618,127 @@ namespace ngcomp
     GetDofNrs (elnr, dnums); 
   }
 
+  shared_ptr<Table<double>> L2HighOrderFESpace :: GetInverseMass (LocalHeap & clh) const
+  {
+    static mutex inverse_mass_mutex;
+    lock_guard<mutex> guard(inverse_mass_mutex);
+    size_t geom_timestamp = ma->GetGeometryTimeStamp();
+    if (inverse_mass && inverse_mass->Size() == ma->GetNE(VOL) &&
+        inverse_mass_timestamp == geom_timestamp)
+      return inverse_mass;
+
+    static Timer t("L2HOFESpace - inverse mass"); RegionTimer reg(t);
+    size_t ne = ma->GetNE(VOL);
+
+    // a single measure for elements with constant Jacobian, the Cholesky factors otherwise
+    Array<int> size(ne);
+    Array<double> measure(ne);
+    ParallelForRange (ne, [&] (IntRange r)
+                      {
+                        LocalHeap lh = clh.Split();
+                        for (size_t i : r)
+                          {
+                            HeapReset hr(lh);
+                            ElementId ei(VOL, i);
+                            const FiniteElement & fel = GetFE (ei, lh);
+                            const ElementTransformation & trafo = ma->GetTrafo (ei, lh);
+                            ELEMENT_TYPE et = fel.ElementType();
+                            int nd = fel.GetNDof();
+
+                            IntegrationRule ir(et, 0);
+                            measure[i] = trafo(ir[0], lh).GetMeasure();
+                            bool affine = !trafo.IsCurvedElement() &&
+                              (et == ET_SEGM || et == ET_TRIG || et == ET_TET);
+                            if (!affine)
+                              {
+                                IntegrationRule irm(et, 2*fel.Order()+2);
+                                auto & mir = trafo(irm, lh);
+                                affine = true;
+                                for (size_t j : Range(irm))
+                                  if (fabs (mir[j].GetMeasure()-measure[i]) > 1e-12 * fabs(measure[i]))
+                                    affine = false;
+                              }
+                            size[i] = affine ? nd : FlatCholeskyFactors<double>::RequiredMem(nd);
+                          }
+                      });
+
+    auto inv = make_shared<Table<double>> (size);
+    ParallelForRange (ne, [&] (IntRange r)
+                      {
+                        LocalHeap lh = clh.Split();
+                        for (size_t i : r)
+                          {
+                            HeapReset hr(lh);
+                            ElementId ei(VOL, i);
+                            auto & fel = static_cast<const BaseScalarFiniteElement&> (GetFE (ei, lh));
+                            int nd = fel.GetNDof();
+                            if (nd == 0) continue;
+                            if (size[i] == nd)
+                              {
+                                FlatVector<double> diag_mass(nd, lh);
+                                fel.GetDiagMassMatrix (diag_mass);
+                                for (int j = 0; j < nd; j++)
+                                  (*inv)[i][j] = 1.0 / (measure[i] * diag_mass(j));
+                                continue;
+                              }
+
+                            const ElementTransformation & trafo = ma->GetTrafo (ei, lh);
+                            IntegrationRule ir(fel.ElementType(), 2*fel.Order()+2);
+                            auto & mir = trafo(ir, lh);
+                            FlatMatrix<double> shapes(ir.Size(), nd, lh);
+                            FlatMatrix<double> wshapes(ir.Size(), nd, lh);
+                            for (size_t j : Range(ir))
+                              {
+                                fel.CalcShape (ir[j], shapes.Row(j));
+                                wshapes.Row(j) = mir[j].GetWeight() * shapes.Row(j);
+                              }
+                            FlatMatrix<double> mass(nd, nd, lh);
+                            mass = Trans(shapes) * wshapes;
+                            FlatCholeskyFactors<double> factors(mass, &(*inv)[i][0]);
+                          }
+                      });
+
+    inverse_mass = inv;
+    inverse_mass_timestamp = geom_timestamp;
+    return inverse_mass;
+  }
+
+  template <typename SCAL>
+  void L2HighOrderFESpace :: ApplyInverseMass (const Table<double> & inverse_mass,
+                                               size_t elnr, SliceMatrix<SCAL> elx)
+  {
+    FlatArray<double> minv = inverse_mass[elnr];
+    size_t nd = elx.Height();
+    // the factors of a 1x1 matrix are its inverse diagonal, too
+    if (minv.Size() == nd)
+      {
+        for (size_t i = 0; i < nd; i++)
+          elx.Row(i) *= minv[i];
+        return;
+      }
+    FlatCholeskyFactors<double> fact(nd, &minv[0]);
+    for (size_t j = 0; j < elx.Width(); j++)
+      fact.Mult (elx.Col(j), elx.Col(j));
+  }
+
+  template NGS_DLL_HEADER void L2HighOrderFESpace ::
+  ApplyInverseMass<double> (const Table<double> & inverse_mass, size_t elnr, SliceMatrix<double> elx);
+  template NGS_DLL_HEADER void L2HighOrderFESpace ::
+  ApplyInverseMass<Complex> (const Table<double> & inverse_mass, size_t elnr, SliceMatrix<Complex> elx);
+
+
   void L2HighOrderFESpace :: SolveM (CoefficientFunction * rho, BaseVector & vec,
                                      LocalHeap & lh) const
   {
     static Timer t("SolveM"); RegionTimer reg(t);
+
+    bool weighted = rho && !rho->ElementwiseConstant();
+    shared_ptr<Table<double>> minv;
+    if (!weighted)
+      minv = GetInverseMass (lh);
     
     IterateElements (*this, VOL, lh,
-                     [&rho, &vec,this] (FESpace::Element el, LocalHeap & lh)
+                     [&rho, &vec, &minv, weighted, this] (FESpace::Element el, LocalHeap & lh)
                      {
                        auto & fel = static_cast<const BaseScalarFiniteElement&>(el.GetFE());
                        const ElementTransformation & trafo = el.GetTrafo();
@@ -635,41 +750,35 @@ namespace ngcomp
                        vec.GetIndirect(dnums, elx);
 		       auto melx = elx.AsMatrix(fel.GetNDof(),dimension);
 
-                       FlatVector<double> diag_mass(fel.GetNDof(), lh);
-                       fel.GetDiagMassMatrix (diag_mass);
-
-                       bool curved = trafo.IsCurvedElement();
-                       if (rho && !rho->ElementwiseConstant()) curved = true;
-                       
-                       if (!curved)
+                       if (!weighted)
                          {
-                           IntegrationRule ir(fel.ElementType(), 0);
-                           BaseMappedIntegrationRule & mir = trafo(ir, lh);
-                           double jac = mir[0].GetMeasure();
-                           if (rho) jac *= rho->Evaluate(mir[0]);
-                           diag_mass *= jac;
-                           for (int i = 0; i < melx.Height(); i++)
-                             melx.Row(i) /= diag_mass(i);
+                           // exact inverse, cached for non-affine elements
+                           ApplyInverseMass<double> (*minv, el.Nr(), melx);
+                           if (rho)
+                             {
+                               IntegrationRule ir(fel.ElementType(), 0);
+                               melx /= rho->Evaluate (trafo(ir[0], lh));
+                             }
                          }
                        else
                          {
+                           // approximate inverse of the weighted mass matrix
+                           FlatVector<double> diag_mass(fel.GetNDof(), lh);
+                           fel.GetDiagMassMatrix (diag_mass);
+
                            SIMD_IntegrationRule ir(fel.ElementType(), 2*fel.Order());
                            auto & mir = trafo(ir, lh);
                            FlatVector<SIMD<double>> pntvals(ir.Size(), lh);
                            FlatMatrix<SIMD<double>> rhovals(1, ir.Size(), lh);
-                           if (rho) rho->Evaluate (mir, rhovals);
+                           rho->Evaluate (mir, rhovals);
                            
                            for (int i = 0; i < melx.Height(); i++)
                              melx.Row(i) /= diag_mass(i);
                            for (int comp = 0; comp < dimension; comp++)
                              {
                                fel.Evaluate (ir, melx.Col(comp), pntvals);
-                               if (rho)
-                                 for (size_t i = 0; i < ir.Size(); i++)
-                                   pntvals(i) *= ir[i].Weight() / (mir[i].GetMeasure() * rhovals(0,i));
-                               else
-                                 for (size_t i = 0; i < ir.Size(); i++)
-                                   pntvals(i) *= ir[i].Weight() / mir[i].GetMeasure();
+                               for (size_t i = 0; i < ir.Size(); i++)
+                                 pntvals(i) *= ir[i].Weight() / (mir[i].GetMeasure() * rhovals(0,i));
                                
                                melx.Col(comp) = 0.0;
                                fel.AddTrans (ir, pntvals, melx.Col(comp));
@@ -685,7 +794,6 @@ namespace ngcomp
 
 
 
-
   template <int D, typename FEL = ScalarFiniteElement<D-1> >
   class DiffOpSurfaceGradient : public DiffOp<DiffOpSurfaceGradient<D, FEL> >
   {
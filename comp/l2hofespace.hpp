@@ -33,6 +33,9 @@ namespace ngcomp
     Array<DofId> first_element_dof;
     bool all_dofs_together;
     COUPLING_TYPE lowest_order_ct;
+    /// inverse diagonal of element mass matrices, or their Cholesky factors
+    mutable shared_ptr<Table<double>> inverse_mass;
+    mutable size_t inverse_mass_timestamp = 0;
   public:
 
     L2HighOrderFESpace (shared_ptr<MeshAccess> ama, const Flags & flags, bool parseflags=false);
@@ -97,6 +100,21 @@ namespace ngcomp
     virtual void SolveM (CoefficientFunction * rho, BaseVector & vec,
                          LocalHeap & lh) const override;
 
+    /**
+       The inverse mass matrices of all elements, recomputed if the mesh
+       or the space changed. With the orthogonal basis the mass matrix
+       is diagonal on elements with constant Jacobian determinant, the
+       other elements store the Cholesky factors (FlatCholeskyFactors)
+       of their mass matrix. The returned table stays valid when the
+       space computes a new one.
+     */
+    shared_ptr<Table<double>> GetInverseMass (LocalHeap & lh) const;
+
+    /// elx = M^{-1} elx, one row per element dof, one column per component
+    template <typename SCAL>
+    static void ApplyInverseMass (const Table<double> & inverse_mass,
+                                  size_t elnr, SliceMatrix<SCAL> elx);
+
 
   protected:
 
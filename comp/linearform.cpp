@@ -346,7 +346,24 @@ namespace ngcomp
 		  if(parts[j]->DefinedOn(i))
 		    domains.Append(i);
 	      }
-	    
+
+	    // locate all curve points in parallel
+	    auto tree = ma->GetElementSearchTree(VOL);
+	    const Array<int> * pdomains = domains.Size() ? &domains : nullptr;
+	    Array<int> curveels(parts[j]->NumCurvePoints());
+	    Array<IntegrationPoint> curveips(parts[j]->NumCurvePoints());
+	    ParallelForRange (curveels.Size(), [&] (IntRange r)
+	      {
+		LocalHeapMem<100000> slh("curvepoints");
+		for (int i : r)
+		  {
+		    Vec<3> p = 0.0;
+		    const FlatVector<double> & cp = parts[j]->CurvePoint(i);
+		    for (int k = 0; k < min2 (int(cp.Size()), 3); k++)
+		      p(k) = cp(k);
+		    curveels[i] = tree->Find (p, curveips[i], slh, ma->GetPointSearchTolerance(), pdomains);
+		  }
+	      });
 	    
 	    for(int nc = 0; nc < parts[j]->GetNumCurveParts(); nc++)
 	      {
@@ -363,11 +380,8 @@ namespace ngcomp
 		      }
 		    
 		    FlatVector<TSCAL> elvec;
-		    IntegrationPoint ip;
-		    if(domains.Size() > 0)
-		      element = ma->FindElementOfPoint(parts[j]->CurvePoint(i),ip,true,&domains);
-		    else
-		      element = ma->FindElementOfPoint(parts[j]->CurvePoint(i),ip,true);
+		    IntegrationPoint ip = curveips[i];
+		    element = curveels[i];
 		    if(element < 0)
 		      throw Exception("element for curvepoint not found");
 		    
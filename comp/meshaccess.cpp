@@ -1302,6 +1302,26 @@ namespace ngcomp
 
 
   
+    void MeshAccess :: SetDeformation (shared_ptr<GridFunction> def)
+    {
+      deformation = def;
+      timestamp = NGS_Object::GetNextTimeStamp();
+    }
+
+    size_t MeshAccess :: GetGeometryTimeStamp () const
+    {
+      if (!deformation) return timestamp;
+      size_t sum = deformation->GetVector().CheckSum();
+      static mutex deformation_mutex;
+      lock_guard<mutex> guard(deformation_mutex);
+      if (sum != deformation_checksum || deformation_timestamp == 0)
+        {
+          deformation_checksum = sum;
+          deformation_timestamp = NGS_Object::GetNextTimeStamp();
+        }
+      return max2 (timestamp, deformation_timestamp);
+    }
+
     void MeshAccess :: SetPML (const shared_ptr<PML_Transformation> & pml_trafo, int _domnr)
     {
       if (_domnr>=nregions[VOL])
@@ -1309,6 +1329,7 @@ namespace ngcomp
       if (pml_trafo->GetDimension()!=dim)
         throw Exception("MeshAccess::SetPML: dimension of PML = "+ToString(pml_trafo->GetDimension())+" does not fit mesh dimension!");
       pml_trafos[_domnr] = pml_trafo; 
+      timestamp = NGS_Object::GetNextTimeStamp();
     }
     
     void MeshAccess :: UnSetPML (int _domnr)
@@ -1316,6 +1337,7 @@ namespace ngcomp
       if (_domnr>=nregions[VOL])
         throw Exception("MeshAccess::UnSetPML: was not able to unset PML, domain index too high!");
       pml_trafos[_domnr] = nullptr; 
+      timestamp = NGS_Object::GetNextTimeStamp();
     }
     Array<shared_ptr<PML_Transformation>> & MeshAccess :: GetPMLTrafos()
     { return pml_trafos; }
@@ -1664,6 +1686,29 @@ namespace ngcomp
     return FindElementOfPoint(point,ip,build_searchtree,&dummy);
   }
 
+  shared_ptr<ElementSearchTree> MeshAccess :: GetElementSearchTree (VorB vb) const
+  {
+    if (vb != VOL && vb != BND)
+      throw Exception ("GetElementSearchTree: only VOL or BND elements");
+
+    size_t geom_timestamp = GetGeometryTimeStamp();
+    auto valid = [&] (const shared_ptr<ElementSearchTree> & tree)
+      { return tree && &tree->GetMesh() == this && tree->GetTimeStamp() == geom_timestamp; };
+
+    auto tree = atomic_load (&searchtrees[vb]);
+    if (valid (tree)) return tree;
+
+    static mutex searchtree_mutex;
+    lock_guard<mutex> guard(searchtree_mutex);
+    tree = atomic_load (&searchtrees[vb]);
+    if (!valid (tree))
+      {
+        tree = make_shared<ElementSearchTree> (*this, vb, geom_timestamp);
+        atomic_store (&searchtrees[vb], tree);
+      }
+    return tree;
+  }
+
   int MeshAccess :: FindElementOfPoint (FlatVector<double> point,
 					IntegrationPoint & ip,
 					bool build_searchtree,
@@ -1672,33 +1717,12 @@ namespace ngcomp
     static Timer t("FindElementOfPonit");
     RegionTimer reg(t);
 
-
-    if (indices != NULL)
-      {
-        switch (dim)
-          {
-          case 1:
-            return mesh.FindElementOfPoint<1> (&point(0), &ip(0), build_searchtree, 
-                                               &(*indices)[0],indices->Size());
-          case 2:
-            return mesh.FindElementOfPoint<2> (&point(0), &ip(0), build_searchtree, 
-                                               &(*indices)[0],indices->Size());
-          case 3:
-            return mesh.FindElementOfPoint<3> (&point(0), &ip(0), build_searchtree,
-                                               &(*indices)[0],indices->Size());
-          }
-      }
-    else
-      {  
-        switch (dim)
-          {
-          case 1: return mesh.FindElementOfPoint<1> (&point(0), &ip(0), build_searchtree, NULL, 0);
-          case 2: return mesh.FindElementOfPoint<2> (&point(0), &ip(0), build_searchtree, NULL, 0);
-          case 3: return mesh.FindElementOfPoint<3> (&point(0), &ip(0), build_searchtree, NULL, 0);
-          }
-      }
-
-    return -1;
+    Vec<3> p = 0.0;
+    for (int i = 0; i < min2 (int(point.Size()), 3); i++)
+      p(i) = point(i);
+    LocalHeapMem<100000> lh("FindElementOfPoint");
+    const Array<int> * hindices = (indices && indices->Size()) ? indices : nullptr;
+    return GetElementSearchTree(VOL)->Find (p, ip, lh, pointsearch_tol, hindices);
   }
 
 
@@ -1719,24 +1743,13 @@ namespace ngcomp
   {
     static Timer t("FindSurfaceElementOfPonit");
     RegionTimer reg(t);
-    int elnr;
-
-    if(indices != NULL && indices->Size()>0)
-      {
-	// int * dummy = new int[indices->Size()];
-	// for(int i=0; i<indices->Size(); i++) dummy[i] = (*indices)[i]+1;
-	// elnr = Ng_FindSurfaceElementOfPoint (&point(0), lami, build_searchtree,dummy,indices->Size());
-	// delete [] dummy;
-        elnr = mesh.FindElementOfPoint<2> (&point(0), &ip(0), build_searchtree,
-                                           &(*indices)[0],indices->Size());
-      }
-    else
-      {  
-	// elnr = Ng_FindSurfaceElementOfPoint (&point(0), lami, build_searchtree);
-        elnr = mesh.FindElementOfPoint<2> (&point(0), &ip(0), build_searchtree, NULL, 0);        
-      }
 
-    return elnr;
+    Vec<3> p = 0.0;
+    for (int i = 0; i < min2 (int(point.Size()), 3); i++)
+      p(i) = point(i);
+    LocalHeapMem<100000> lh("FindSurfaceElementOfPoint");
+    const Array<int> * hindices = (indices && indices->Size()) ? indices : nullptr;
+    return GetElementSearchTree(BND)->Find (p, ip, lh, pointsearch_tol, hindices);
   }
 
 
@@ -25,6 +25,7 @@ namespace ngcomp
   
   class MeshAccess;
   class Ngs_Element;
+  class ElementSearchTree;
   
 
   class Ngs_Element : public netgen::Ng_Element
@@ -231,6 +232,9 @@ namespace ngcomp
     
     /// for ALE
     shared_ptr<GridFunction> deformation;  
+    /// checksum of the deformation vector, and the timestamp of its last change
+    mutable size_t deformation_checksum = 0;
+    mutable size_t deformation_timestamp = 0;
 
     /// pml trafos per sub-domain
     Array<shared_ptr <PML_Transformation>> pml_trafos;
@@ -243,6 +247,11 @@ namespace ngcomp
                                                                make_shared<Array<Array<INT<2>>>>(),
                                                                make_shared<Array<Array<INT<2>>>>()};
 
+    /// point location for VOL and BND elements, built on demand
+    mutable shared_ptr<ElementSearchTree> searchtrees[2];
+    /// relative distance for points outside of all elements, 0 for exact search
+    double pointsearch_tol = 0;
+
     ///
     MPI_Comm mesh_comm;
   public:
@@ -623,6 +632,13 @@ namespace ngcomp
     }
 
     auto GetTimeStamp() const { return timestamp; }
+
+    /**
+       Timestamp of the geometry: the mesh timestamp, or a new one after
+       the values of the deformation were changed in place (ALE). Costs
+       one pass over the deformation vector, for caches of geometric data.
+     */
+    size_t GetGeometryTimeStamp() const;
     
     void SetRefinementFlag (ElementId id, bool ref)
     {
@@ -634,10 +650,8 @@ namespace ngcomp
 
     void Refine ();
     void Curve (int order);
-    void SetDeformation (shared_ptr<GridFunction> def = nullptr)
-    {
-      deformation = def;
-    }
+    /// changes the geometry, increases the timestamp
+    void SetDeformation (shared_ptr<GridFunction> def = nullptr);
 
     const shared_ptr<GridFunction> & GetDeformation () const
     {
@@ -1003,6 +1017,23 @@ namespace ngcomp
 
 
     
+    /**
+       The search tree for VOL or BND elements. It is built in parallel
+       on first use and after changes of the mesh, searching is thread
+       safe.
+     */
+    shared_ptr<ElementSearchTree> GetElementSearchTree (VorB vb) const;
+
+    /**
+       Points outside of all elements, but closer than tol times the
+       element size, are located in the closest element (e.g. points
+       on curved boundaries). The default 0 finds only points inside
+       of elements.
+     */
+    void SetPointSearchTolerance (double tol) { pointsearch_tol = tol; }
+    double GetPointSearchTolerance () const { return pointsearch_tol; }
+
+    /// thread safe, build_searchtree is not used anymore
     int FindElementOfPoint (FlatVector<double> point,
 			    IntegrationPoint & ip, 
 			    bool build_searchtree,
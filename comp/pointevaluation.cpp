@@ -0,0 +1,128 @@
+/*********************************************************************/
+/* File:   pointevaluation.cpp                                       */
+/* Date:   Oct. 2026                                                 */
+/*********************************************************************/
+
+#include <comp.hpp>
+
+namespace ngcomp
+{
+
+  MeshPoints :: MeshPoints (shared_ptr<MeshAccess> ama, SliceMatrix<double> points, VorB avb)
+    : ma(ama), vb(avb), elnrs(points.Height()), ips(points.Height())
+  {
+    static Timer t("MeshPoints - locate");
+    RegionTimer reg(t);
+
+    if (vb != VOL && vb != BND)
+      throw Exception ("MeshPoints: only VOL or BND elements");
+    int dim = ma->GetDimension();
+    if (points.Width() < dim)
+      throw Exception ("MeshPoints: need "+ToString(dim)+" coordinates per point");
+
+    size_t n = points.Height();
+    auto tree = ma->GetElementSearchTree (vb);
+    double tol = ma->GetPointSearchTolerance();
+    ParallelForRange (n, [&] (IntRange r)
+                      {
+                        LocalHeapMem<100000> lh("MeshPoints - locate");
+                        for (size_t i : r)
+                          {
+                            Vec<3> p = 0.0;
+                            for (int j = 0; j < dim; j++)
+                              p(j) = points(i,j);
+                            elnrs[i] = tree->Find (p, ips[i], lh, tol);
+                          }
+                      });
+
+    TableCreator<int> creator(ma->GetNE(vb));
+    for ( ; !creator.Done(); creator++)
+      ParallelFor (n, [&] (size_t i)
+                   {
+                     if (elnrs[i] >= 0)
+                       creator.Add (elnrs[i], i);
+                   });
+    elpoints = creator.MoveTable();
+
+    nfound = 0;
+    for (int el : elnrs)
+      if (el >= 0) nfound++;
+  }
+
+
+  static inline double GetLane (SIMD<double> a, int i) { return a[i]; }
+  static inline Complex GetLane (SIMD<Complex> a, int i) { return Complex (a.real()[i], a.imag()[i]); }
+
+  template <typename SCAL>
+  void MeshPoints :: Evaluate (const CoefficientFunction & cf, SliceMatrix<SCAL> values,
+                               LocalHeap & clh) const
+  {
+    static Timer t("MeshPoints - evaluate");
+    RegionTimer reg(t);
+
+    int dim = cf.Dimension();
+    if (values.Height() != Size() || values.Width() != dim)
+      throw Exception ("MeshPoints::Evaluate: values must be "+ToString(Size())+" x "+ToString(dim));
+
+    ParallelFor (Size(), [&] (size_t i)
+                 {
+                   if (elnrs[i] < 0)
+                     values.Row(i) = SCAL(0.0);
+                 });
+
+    bool use_simd = true;
+    constexpr int SW = SIMD<double>::Size();
+
+    ParallelForRange
+      (elpoints.Size(), [&] (IntRange r)
+       {
+         LocalHeap lh = clh.Split();
+         for (size_t elnr : r)
+           {
+             FlatArray<int> pts = elpoints[elnr];
+             if (pts.Size() == 0) continue;
+             HeapReset hr(lh);
+
+             auto & trafo = ma->GetTrafo (ElementId(vb, elnr), lh);
+             IntegrationRule ir(pts.Size(), lh);
+             for (size_t j : Range(pts))
+               ir[j] = ips[pts[j]];
+             ir.SetDim (ElementTopology::GetSpaceDim (trafo.GetElementType()));
+
+             bool this_simd = use_simd;
+             if (this_simd)
+               {
+                 try
+                   {
+                     SIMD_IntegrationRule simd_ir(ir, lh);
+                     auto & mir = trafo(simd_ir, lh);
+                     FlatMatrix<SIMD<SCAL>> simd_values(dim, simd_ir.Size(), lh);
+                     cf.Evaluate (mir, simd_values);
+                     for (size_t j : Range(pts))
+                       for (int k = 0; k < dim; k++)
+                         values(pts[j], k) = GetLane (simd_values(k, j/SW), j%SW);
+                   }
+                 catch (ExceptionNOSIMD e)
+                   {
+                     this_simd = false;
+                     use_simd = false;
+                   }
+               }
+             if (!this_simd)
+               {
+                 auto & mir = trafo(ir, lh);
+                 FlatMatrix<SCAL> hvalues(ir.Size(), dim, lh);
+                 cf.Evaluate (mir, hvalues);
+                 for (size_t j : Range(pts))
+                   values.Row(pts[j]) = hvalues.Row(j);
+               }
+           }
+       });
+  }
+
+  template NGS_DLL_HEADER void MeshPoints ::
+  Evaluate<double> (const CoefficientFunction & cf, SliceMatrix<double> values, LocalHeap & lh) const;
+  template NGS_DLL_HEADER void MeshPoints ::
+  Evaluate<Complex> (const CoefficientFunction & cf, SliceMatrix<Complex> values, LocalHeap & lh) const;
+
+}
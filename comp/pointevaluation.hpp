@@ -0,0 +1,55 @@
+#ifndef FILE_POINTEVALUATION
+#define FILE_POINTEVALUATION
+
+/*********************************************************************/
+/* File:   pointevaluation.hpp                                       */
+/* Date:   Oct. 2026                                                 */
+/*********************************************************************/
+
+namespace ngcomp
+{
+
+  /**
+     Many points located in the mesh, grouped by element.
+
+     The points are located in parallel. Coefficient functions are
+     evaluated element by element, with one (SIMD) integration rule
+     for all points of an element. The locations can be reused for
+     many evaluations, e.g. for the same probe points in every time
+     step, as long as the mesh does not change.
+   */
+  class NGS_DLL_HEADER MeshPoints
+  {
+    shared_ptr<MeshAccess> ma;
+    VorB vb;
+    /// element number, or -1 for points outside the mesh
+    Array<int> elnrs;
+    /// reference coordinates in the element
+    Array<IntegrationPoint> ips;
+    /// the points in every element
+    Table<int> elpoints;
+    size_t nfound;
+
+  public:
+    /// the rows of points are the coordinates, VOL or BND elements
+    MeshPoints (shared_ptr<MeshAccess> ama, SliceMatrix<double> points, VorB avb = VOL);
+
+    size_t Size () const { return elnrs.Size(); }
+    /// number of points inside the mesh
+    size_t GetNumFound () const { return nfound; }
+    VorB GetVorB () const { return vb; }
+    FlatArray<int> GetElementNumbers () const { return elnrs; }
+    FlatArray<IntegrationPoint> GetReferencePoints () const { return ips; }
+
+    /**
+       One row of values per point, one column per component of cf.
+       Rows of points outside the mesh are set to zero.
+     */
+    template <typename SCAL>
+    void Evaluate (const CoefficientFunction & cf, SliceMatrix<SCAL> values,
+                   LocalHeap & lh) const;
+  };
+
+}
+
+#endif
@@ -378,6 +378,76 @@ namespace ngcomp
 
 
 
+  /*
+    Projection into an L2HighOrderFESpace. Elements don't share dofs,
+    the inverse element mass matrices are diagonal (affine elements)
+    or cached by the space.
+  */
+  template <class SCAL>
+  static void SetValuesL2 (shared_ptr<CoefficientFunction> coef,
+                           S_GridFunction<SCAL> & u,
+                           const L2HighOrderFESpace & fes,
+                           const Region * reg,
+                           DifferentialOperator * diffop,
+                           LocalHeap & clh)
+  {
+    static Timer t("timer setvalues - L2"); RegionTimer r(t);
+
+    int dim = fes.GetDimension();
+    int dimflux = diffop->Dim();
+    auto minv = fes.GetInverseMass (clh);
+    bool use_simd = true;
+
+    IterateElements
+      (fes, VOL, clh,
+       [&] (FESpace::Element ei, LocalHeap & lh)
+       {
+         if (reg && !reg->Mask().Test(ei.GetIndex())) return;
+
+         const FiniteElement & fel = ei.GetFE();
+         const ElementTransformation & eltrans = ei.GetTrafo();
+         int nd = fel.GetNDof();
+         FlatVector<SCAL> elflux(nd * dim, lh);
+         elflux = SCAL(0.0);
+
+         bool this_simd = use_simd;
+         if (this_simd)
+           {
+             try
+               {
+                 SIMD_IntegrationRule ir(fel.ElementType(), 2*fel.Order());
+                 auto & mir = eltrans(ir, lh);
+                 FlatMatrix<SIMD<SCAL>> mfluxi(dimflux, ir.Size(), lh);
+                 coef->Evaluate (mir, mfluxi);
+                 for (size_t j : Range(ir))
+                   mfluxi.Col(j) *= mir[j].GetWeight();
+                 diffop -> AddTrans (fel, mir, mfluxi, elflux);
+               }
+             catch (ExceptionNOSIMD e)
+               {
+                 this_simd = false;
+                 use_simd = false;
+                 elflux = SCAL(0.0);
+                 cout << IM(4) << "Warning: switching to std evalution in SetValues since: " << e.What() << endl;
+               }
+           }
+         if (!this_simd)
+           {
+             IntegrationRule ir(fel.ElementType(), 2*fel.Order());
+             auto & mir = eltrans(ir, lh);
+             FlatMatrix<SCAL> mfluxi(ir.Size(), dimflux, lh);
+             coef->Evaluate (mir, mfluxi);
+             for (size_t j : Range(ir))
+               mfluxi.Row(j) *= mir[j].GetWeight();
+             diffop -> ApplyTrans (fel, mir, mfluxi, elflux, lh);
+           }
+
+         L2HighOrderFESpace::ApplyInverseMass<SCAL> (*minv, ei.Nr(), elflux.AsMatrix(nd, dim));
+         u.SetElementVector (ei.GetDofs(), elflux);
+       });
+  }
+
+
   template <class SCAL>
   void SetValues (shared_ptr<CoefficientFunction> coef,
 		  GridFunction & bu,
@@ -422,6 +492,19 @@ namespace ngcomp
     if (coef -> Dimension() != dimflux)
       throw Exception(string("Error in SetValues: gridfunction-dim = ") + ToString(dimflux) +
                       ", but coefficient-dim = " + ToString(coef->Dimension()));
+
+    auto l2fes = dynamic_pointer_cast<L2HighOrderFESpace> (fes);
+    if (l2fes && vb == VOL && diffop == fes->GetEvaluator(VOL).get())
+      {
+        u.GetVector() = 0.0;
+        SetValuesL2 (coef, u, *l2fes, reg, diffop, clh);
+#ifdef PARALLEL
+        u.GetVector().SetParallelStatus(CUMULATED);
+#endif
+        ma->PopStatus ();
+        return;
+      }
+
     Array<int> cnti(fes->GetNDof());
     cnti = 0;
 
@@ -644,6 +727,247 @@ namespace ngcomp
 
 
 
+  shared_ptr<SparseMatrix<double>>
+  CreateTransferMatrix (shared_ptr<FESpace> source, shared_ptr<FESpace> target,
+                        int intorder, LocalHeap & clh)
+  {
+    static Timer t("TransferMatrix");
+    static Timer tlocate("TransferMatrix - locate");
+    static Timer tgraph("TransferMatrix - graph");
+    static Timer tfill("TransferMatrix - fill");
+    RegionTimer reg(t);
+
+    if (source->IsComplex() || target->IsComplex())
+      throw Exception ("TransferMatrix: only real spaces");
+    if (source->GetDimension() != 1 || target->GetDimension() != 1)
+      throw Exception ("TransferMatrix: spaces of dimension > 1 are not supported");
+
+    auto sma = source->GetMeshAccess();
+    auto tma = target->GetMeshAccess();
+    if (sma->GetDimension() != tma->GetDimension())
+      throw Exception ("TransferMatrix: meshes of different dimension");
+
+    auto sdiffop = source->GetEvaluator(VOL);
+    auto tdiffop = target->GetEvaluator(VOL);
+    if (!sdiffop || !tdiffop)
+      throw Exception ("TransferMatrix: space has no evaluator");
+    if (sdiffop->Dim() != tdiffop->Dim())
+      throw Exception ("TransferMatrix: evaluators of source and target have different dimension");
+    int dimflux = tdiffop->Dim();
+    int dim = tma->GetDimension();
+    size_t ne = tma->GetNE(VOL);
+
+    auto GetOrder = [&] (const FiniteElement & fel)
+      { return (intorder >= 0) ? intorder : 2*fel.Order(); };
+
+    // source element and reference point of every target integration point
+    tlocate.Start();
+    Array<int> nips(ne);
+    ParallelForRange (ne, [&] (IntRange r)
+                      {
+                        LocalHeap lh = clh.Split();
+                        for (size_t i : r)
+                          {
+                            HeapReset hr(lh);
+                            ElementId ei(VOL, i);
+                            nips[i] = 0;
+                            if (!target->DefinedOn (ei)) continue;
+                            const FiniteElement & fel = target->GetFE (ei, lh);
+                            IntegrationRule ir(fel.ElementType(), GetOrder(fel));
+                            nips[i] = ir.Size();
+                          }
+                      });
+
+    Table<int> srcel(nips);
+    Table<IntegrationPoint> srcip(nips);
+    auto tree = sma->GetElementSearchTree (VOL);
+    double tol = sma->GetPointSearchTolerance();
+    ParallelForRange (ne, [&] (IntRange r)
+                      {
+                        LocalHeap lh = clh.Split();
+                        for (size_t i : r)
+                          {
+                            if (nips[i] == 0) continue;
+                            HeapReset hr(lh);
+                            ElementId ei(VOL, i);
+                            const FiniteElement & fel = target->GetFE (ei, lh);
+                            auto & trafo = tma->GetTrafo (ei, lh);
+                            IntegrationRule ir(fel.ElementType(), GetOrder(fel));
+                            auto & mir = trafo(ir, lh);
+                            for (size_t j : Range(ir))
+                              {
+                                Vec<3> p = 0.0;
+                                for (int k = 0; k < dim; k++)
+                                  p(k) = mir[j].GetPoint()(k);
+                                srcel[i][j] = tree->Find (p, srcip[i][j], lh, tol);
+                              }
+                          }
+                      });
+    tlocate.Stop();
+
+    // target dofs, and the source dofs coupling with a target element
+    tgraph.Start();
+    TableCreator<int> rcreator(ne), ccreator(ne);
+    for ( ; !rcreator.Done(); rcreator++, ccreator++)
+      ParallelForRange (ne, [&] (IntRange r)
+                        {
+                          Array<DofId> dnums;
+                          Array<int> els, cols;
+                          for (size_t i : r)
+                            {
+                              if (nips[i] == 0) continue;
+                              target->GetDofNrs (ElementId(VOL, i), dnums);
+                              for (auto d : dnums)
+                                rcreator.Add (i, d);
+
+                              els.SetSize0();
+                              for (int el : srcel[i])
+                                if (el != -1 && !els.Contains(el))
+                                  els.Append (el);
+                              cols.SetSize0();
+                              for (int el : els)
+                                {
+                                  source->GetDofNrs (ElementId(VOL, el), dnums);
+                                  for (auto d : dnums)
+                                    if (d != -1) cols.Append (d);
+                                }
+                              QuickSort (cols);
+                              for (size_t j : Range(cols))
+                                if (j == 0 || cols[j] != cols[j-1])
+                                  ccreator.Add (i, cols[j]);
+                            }
+                        });
+    Table<int> rowdofs = rcreator.MoveTable();
+    Table<int> coldofs = ccreator.MoveTable();
+
+    size_t ndof = target->GetNDof();
+    TableCreator<int> dcreator(ndof);
+    for ( ; !dcreator.Done(); dcreator++)
+      ParallelFor (ne, [&] (size_t i)
+                   {
+                     for (auto d : rowdofs[i])
+                       if (d != -1) dcreator.Add (d, i);
+                   });
+    Table<int> dof2el = dcreator.MoveTable();
+
+    // a row couples with the source dofs of all elements of the target dof
+    auto RowCols = [&] (size_t d, Array<int> & cols)
+      {
+        cols.SetSize0();
+        for (int el : dof2el[d])
+          cols.Append (coldofs[el]);
+        QuickSort (cols);
+        size_t n = 0;
+        for (size_t j : Range(cols))
+          if (j == 0 || cols[j] != cols[j-1])
+            cols[n++] = cols[j];
+        cols.SetSize (n);
+      };
+
+    Array<int> elsperrow(ndof);
+    ParallelForRange (ndof, [&] (IntRange r)
+                      {
+                        Array<int> cols;
+                        for (size_t d : r)
+                          {
+                            RowCols (d, cols);
+                            elsperrow[d] = cols.Size();
+                          }
+                      });
+
+    auto mat = make_shared<SparseMatrix<double>> (elsperrow, source->GetNDof());
+    ParallelForRange (ndof, [&] (IntRange r)
+                      {
+                        Array<int> cols;
+                        for (size_t d : r)
+                          {
+                            RowCols (d, cols);
+                            for (int c : cols)
+                              mat->CreatePosition (d, c);
+                          }
+                      });
+    mat->AsVector() = 0.0;
+    tgraph.Stop();
+
+    /*
+      Element-wise L2 projection as in SetValues, with the source
+      function as coefficient:  P_T = M_T^{-1} sum_q w_q B_T(x_q)^T B_S(x_q),
+      averaged over the elements sharing a target dof.
+    */
+    tfill.Start();
+    ParallelForRange (ne, [&] (IntRange r)
+                      {
+                        LocalHeap lh = clh.Split();
+                        Array<DofId> sdnums;
+                        for (size_t i : r)
+                          {
+                            if (nips[i] == 0) continue;
+                            HeapReset hr(lh);
+                            ElementId ei(VOL, i);
+                            const FiniteElement & fel = target->GetFE (ei, lh);
+                            auto & trafo = tma->GetTrafo (ei, lh);
+                            IntegrationRule ir(fel.ElementType(), GetOrder(fel));
+                            auto & mir = trafo(ir, lh);
+
+                            FlatArray<int> tdofs = rowdofs[i];
+                            FlatArray<int> cols = coldofs[i];
+                            int ndt = fel.GetNDof();
+
+                            FlatMatrix<double> mass(ndt, ndt, lh);
+                            FlatMatrix<double> rhs(ndt, cols.Size(), lh);
+                            FlatMatrix<double,ColMajor> bt(dimflux, ndt, lh);
+                            FlatMatrix<double,ColMajor> wbt(dimflux, ndt, lh);
+                            mass = 0.0;
+                            rhs = 0.0;
+
+                            for (size_t j : Range(ir))
+                              {
+                                HeapReset hr2(lh);
+                                tdiffop->CalcMatrix (fel, mir[j], bt, lh);
+                                wbt = mir[j].GetWeight() * bt;
+                                mass += Trans(wbt) * bt;
+
+                                int el = srcel[i][j];
+                                if (el == -1) continue;
+                                ElementId sei(VOL, el);
+                                const FiniteElement & sfel = source->GetFE (sei, lh);
+                                auto & strafo = sma->GetTrafo (sei, lh);
+                                source->GetDofNrs (sei, sdnums);
+                                int nds = sfel.GetNDof();
+
+                                FlatMatrix<double,ColMajor> bs(dimflux, nds, lh);
+                                sdiffop->CalcMatrix (sfel, strafo(srcip[i][j], lh), bs, lh);
+                                FlatMatrix<double> rs(ndt, nds, lh);
+                                rs = Trans(wbt) * bs;
+                                source->TransformMat (sei, rs, TRANSFORM_MAT_RIGHT);
+
+                                for (int k = 0; k < nds; k++)
+                                  if (sdnums[k] != -1)
+                                    {
+                                      rhs.Col(cols.Pos(sdnums[k])) += rs.Col(k);
+                                    }
+                              }
+
+                            target->TransformMat (ei, mass, TRANSFORM_MAT_LEFT_RIGHT);
+                            target->TransformMat (ei, rhs, TRANSFORM_MAT_LEFT);
+                            CalcInverse (mass);
+                            FlatMatrix<double> elmat(ndt, cols.Size(), lh);
+                            elmat = mass * rhs;
+
+                            for (int k = 0; k < ndt; k++)
+                              if (tdofs[k] != -1)
+                                elmat.Row(k) *= 1.0 / dof2el[tdofs[k]].Size();
+
+                            mat->AddElementMatrix (tdofs, cols, elmat, true);
+                          }
+                      });
+    tfill.Stop();
+
+    return mat;
+  }
+
+
+
 
   template <class SCAL>
   void CalcError (const S_GridFunction<SCAL> & u,
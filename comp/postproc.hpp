@@ -48,7 +48,19 @@ namespace ngcomp
 		  const Region & region, 
 		  DifferentialOperator * diffop,   // NULL is FESpace evaluator
 		  LocalHeap & clh);
-  
+
+  /**
+     The matrix of SetValues with a GridFunction of the source space as
+     coefficient, for source and target on different meshes. The target
+     integration points are located once in the source mesh, the transfer
+     of a field is then one matrix-vector product.
+     intorder < 0 uses the integration order of SetValues.
+   */
+  extern NGS_DLL_HEADER
+  shared_ptr<SparseMatrix<double>>
+  CreateTransferMatrix (shared_ptr<FESpace> source, shared_ptr<FESpace> target,
+                        int intorder, LocalHeap & clh);
+
 
 
   template <class SCAL>
@@ -1279,6 +1279,20 @@ used_idnrs : list of int = None
                LoadBin(in, d);
          },
          py::arg("filename"), py::arg("parallel")=false)         
+    .def("SaveCheckpoint", [](GF & self, string filename)
+         {
+           py::gil_scoped_release release;
+           self.SaveCheckpoint (filename);
+         },
+         py::arg("filename"),
+         "binary checkpoint of all vectors, one file filename.rank per MPI rank")
+    .def("LoadCheckpoint", [](GF & self, string filename, bool mmap)
+         {
+           py::gil_scoped_release release;
+           self.LoadCheckpoint (filename, mmap);
+         },
+         py::arg("filename"), py::arg("mmap")=false,
+         "load a checkpoint written by SaveCheckpoint, also with a different number of MPI ranks")
          
     .def("Set", 
          [](shared_ptr<GF> self, spCF cf,
@@ -1588,13 +1602,26 @@ check_unused : bool
                      "  BilinearForm will not allocate memory for assembling.\n"
                      "  optimization feature for (nonlinear) problems where the\n"
                      "  form is only applied but never assembled.",
+                     py::arg("precompute") = "bool = False\n"
+                     "  With nonassemble, prepare symbolic integrators on quads and hexes\n"
+                     "  for matrix-free application by sum factorization. Applies to\n"
+                     "  forms built from values and gradients of scalar spaces.",
                      py::arg("project") = "bool = False\n"
                      "  When calling bf.Assemble, all saved coarse matrices from\n"
                      "  mesh refinements are updated as well using a Galerkin projection\n"
                      "  of the matrix on the finest grid. This is needed to use the multigrid\n"
                      "  preconditioner with a changing bilinearform.",
 		     py::arg("nonsym_storage") = "bool = False\n"
-		     " The full matrix is stored, even if the symmetric flag is set."
+		     " The full matrix is stored, even if the symmetric flag is set.",
+                     py::arg("taskgraph") = "bool = False\n"
+                     "  Assemble element chunks along a dependency graph of dof-conflicts\n"
+                     "  instead of color by color. Avoids the synchronization after every\n"
+                     "  color, useful for meshes needing many colors.",
+                     py::arg("cache_elmats") = "bool = False\n"
+                     "  Keep the element matrices of integrators marked by\n"
+                     "  SetCacheElementMatrix for later assemblies. The cache is\n"
+                     "  cleared if the mesh, its deformation, the space or the\n"
+                     "  cached integrators change."
                      );
                 })
 
@@ -2063,8 +2090,51 @@ flags : dict
     .def_property_readonly ("preconditioners", [](shared_ptr<PDE> self) { return py::cast(self->GetPreconditionerTable()); })
     .def_property_readonly ("numprocs", [](shared_ptr<PDE> self) { return py::cast(self->GetNumProcTable()); })
     ;
-  
-  m.def("Integrate", 
+
+  m.def("TransferMatrix",
+        [](shared_ptr<FESpace> source, shared_ptr<FESpace> target, int intorder)
+        -> shared_ptr<BaseMatrix>
+        {
+          return CreateTransferMatrix (source, target, intorder, glh);
+        },
+        py::arg("source"), py::arg("target"), py::arg("intorder")=-1,
+        "Matrix of GridFunction.Set from a GridFunction on the source space to the target space.\n"
+        "The meshes may be different, points of the target mesh outside of the source mesh get zero.\n"
+        "Apply it with target.vec.data = mat * source.vec");
+
+  py::class_<DGConvectionOperator, shared_ptr<DGConvectionOperator>, BaseMatrix>
+    (m, "DGConvectionOperator", docu_string(R"raw_string(
+Upwind DG operator for linear transport in an L2 space, the same as the
+BilinearForm with the terms
+
+    -u*b*grad(v)
+    bn*IfPos(bn, u, u.Other(bnd=0))*v, element_boundary=True
+
+The geometry is precomputed in the constructor, applying the operator
+needs no element matrices or shape function evaluations. Periodic
+facets are connected, the operator can be applied concurrently.
+
+Parameters
+
+space : ngsolve.FESpace
+  an L2 space
+
+wind : ngsolve.CoefficientFunction
+  the vector field b
+
+bonus_intorder : int
+  additional integration order
+)raw_string"))
+    .def(py::init([](shared_ptr<FESpace> fes, spCF wind, int bonus_intorder)
+                  {
+                    return make_shared<DGConvectionOperator> (fes, wind, bonus_intorder);
+                  }),
+         py::arg("space"), py::arg("wind"), py::arg("bonus_intorder")=0)
+    .def_property_readonly("nclasses", &DGConvectionOperator::GetNClasses,
+                           "number of element classes sharing shape functions")
+    ;
+
+  m.def("Integrate",
         [](spCF cf,
            shared_ptr<MeshAccess> ma, 
            VorB vb, int order, py::object definedon,
@@ -2676,7 +2746,8 @@ flags : dict
 
    py::class_<BaseVTKOutput, shared_ptr<BaseVTKOutput>>(m, "VTKOutput")
     .def(py::init([] (shared_ptr<MeshAccess> ma, py::list coefs_list,
-                      py::list names_list, string filename, int subdivision, int only_element)
+                      py::list names_list, string filename, int subdivision, int only_element,
+                      string format, bool compress)
          -> shared_ptr<BaseVTKOutput>
          {
            Array<shared_ptr<CoefficientFunction> > coefs
@@ -2685,9 +2756,11 @@ flags : dict
              = makeCArray<string> (names_list);
            shared_ptr<BaseVTKOutput> ret;
            if (ma->GetDimension() == 2)
-             ret = make_shared<VTKOutput<2>> (ma, coefs, names, filename, subdivision, only_element);
+             ret = make_shared<VTKOutput<2>> (ma, coefs, names, filename, subdivision, only_element,
+                                              format, compress);
            else
-             ret = make_shared<VTKOutput<3>> (ma, coefs, names, filename, subdivision, only_element);
+             ret = make_shared<VTKOutput<3>> (ma, coefs, names, filename, subdivision, only_element,
+                                              format, compress);
            return ret;
          }),
          py::arg("ma"),
@@ -2695,8 +2768,22 @@ flags : dict
          py::arg("names") = py::list(),
          py::arg("filename") = "vtkout",
          py::arg("subdivision") = 0,
-         py::arg("only_element") = -1
-         )
+         py::arg("only_element") = -1,
+         py::arg("format") = "legacy",
+         py::arg("compress") = false,
+         docu_string(R"raw_string(
+Output of coefficient functions on subdivided elements for ParaView.
+
+format: 'legacy'
+  ASCII .vtk file
+
+format: 'vtu'
+  XML file with appended binary data. With MPI every rank writes
+  filename_rank.vtu, and rank 0 the collection filename.pvtu.
+
+compress: bool
+  zlib compression of the binary data (vtu only)
+)raw_string"))
      .def("Do", [](shared_ptr<BaseVTKOutput> self)
           { 
             self->Do(glh);
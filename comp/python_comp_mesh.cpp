@@ -3,6 +3,7 @@
 #include <regex>
 
 #include "../ngstd/python_ngstd.hpp"
+#include <pybind11/numpy.h>
 #include <comp.hpp>
 using namespace ngcomp;
 
@@ -229,6 +230,51 @@ void ExportNgcompMesh (py::module &m)
   
   
   typedef PML_Transformation PML;
+
+  py::class_<MeshPoints, shared_ptr<MeshPoints>>
+    (m, "MeshPoints", docu_string(R"raw_string(
+Many points located in a mesh, returned by mesh(x,y,z) for arrays of
+coordinates. The locations are computed once and can be used for many
+evaluations, as long as the mesh does not change.
+)raw_string"))
+    .def("__len__", &MeshPoints::Size)
+    .def_property_readonly("found", &MeshPoints::GetNumFound,
+                           "number of points inside the mesh")
+    .def_property_readonly("elementnumbers", [](shared_ptr<MeshPoints> self)
+                           {
+                             auto elnrs = self->GetElementNumbers();
+                             py::array_t<int> res(elnrs.Size());
+                             for (size_t i = 0; i < elnrs.Size(); i++)
+                               res.mutable_data()[i] = elnrs[i];
+                             return res;
+                           }, "element of every point, -1 for points outside the mesh")
+    .def("Evaluate", [](shared_ptr<MeshPoints> self, shared_ptr<CoefficientFunction> cf) -> py::object
+         {
+           size_t n = self->Size();
+           int dim = cf->Dimension();
+           vector<size_t> shape { n };
+           if (dim > 1) shape.push_back (dim);
+
+           LocalHeap lh(10000000 * TaskManager::GetNumThreads(), "MeshPoints::Evaluate", true);
+           if (cf->IsComplex())
+             {
+               py::array_t<Complex> res(shape);
+               FlatMatrix<Complex> values(n, dim, res.mutable_data());
+               py::gil_scoped_release release;
+               self->Evaluate (*cf, values, lh);
+               return move(res);
+             }
+           py::array_t<double> res(shape);
+           FlatMatrix<double> values(n, dim, res.mutable_data());
+           py::gil_scoped_release release;
+           self->Evaluate (*cf, values, lh);
+           return move(res);
+         }, py::arg("cf"), docu_string(R"raw_string(
+Evaluates the CoefficientFunction in all points, element by element.
+Returns a numpy array of shape (n,) or (n, cf.dim), zero for points
+outside the mesh.
+)raw_string"))
+    ;
   
   py::class_<MeshAccess, shared_ptr<MeshAccess>>(m, "Mesh", docu_string(R"raw_string(
 NGSolve interface to the Netgen mesh. Provides access and functionality
@@ -589,6 +635,29 @@ mesh (netgen.Mesh): a mesh generated from Netgen
          py::arg("VOL_or_BND") = VOL,
 	 docu_string("Get a MappedIntegrationPoint in the point (x,y,z) on the matching volume (VorB=VOL, default) or surface (VorB=BND) element. BBND elements aren't supported"))
 
+    .def("__call__",
+         [](shared_ptr<MeshAccess> ma, py::array_t<double> x, py::object y, py::object z, VorB vb)
+          {
+            size_t n = x.size();
+            Matrix<> points(n, 3);
+            points = 0.0;
+            py::object coords[3] = { x, y, z };
+            for (int j = 0; j < 3; j++)
+              {
+                if (coords[j].is_none()) continue;
+                auto c = py::array_t<double, py::array::c_style | py::array::forcecast>::ensure (coords[j]);
+                if (!c || size_t(c.size()) != n)
+                  throw Exception ("coordinate arrays must have the same size");
+                for (size_t i = 0; i < n; i++)
+                  points(i,j) = c.data()[i];
+              }
+            py::gil_scoped_release release;
+            return make_shared<MeshPoints> (ma, points, vb);
+          },
+         py::arg("x"), py::arg("y") = py::none(), py::arg("z") = py::none(),
+         py::arg("VOL_or_BND") = VOL,
+	 docu_string("Locate the points with coordinates in the arrays x, y, z in parallel, for evaluation with MeshPoints.Evaluate"))
+
     .def("Contains",
          [](MeshAccess & ma, double x, double y, double z) 
           {
@@ -599,6 +668,9 @@ mesh (netgen.Mesh): a mesh generated from Netgen
          py::arg("x") = 0.0, py::arg("y") = 0.0, py::arg("z") = 0.0
 	 ,"Check if the point (x,y,z) is in the meshed domain (is inside a volume element)")
 
+    .def("SetPointSearchTolerance", &MeshAccess::SetPointSearchTolerance, py::arg("tol"),
+         "points outside of all elements, but closer than tol times the element size, are located in the closest element (e.g. on curved boundaries), default 0: only points inside of elements are found")
+
     ;
   
   
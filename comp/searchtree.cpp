@@ -0,0 +1,400 @@
+/*********************************************************************/
+/* File:   searchtree.cpp                                            */
+/* Date:   Oct. 2026                                                 */
+/*********************************************************************/
+
+#include <comp.hpp>
+
+namespace ngcomp
+{
+
+  static void ClampToReference (ELEMENT_TYPE et, IntegrationPoint & ip)
+  {
+    auto clamp01 = [] (double & x) { x = min2 (max2 (x, 0.0), 1.0); };
+    switch (et)
+      {
+      case ET_SEGM:
+        clamp01 (ip(0));
+        break;
+      case ET_QUAD:
+        clamp01 (ip(0)); clamp01 (ip(1));
+        break;
+      case ET_HEX:
+        clamp01 (ip(0)); clamp01 (ip(1)); clamp01 (ip(2));
+        break;
+      case ET_TRIG: case ET_TET: case ET_PRISM:
+        {
+          int n = (et == ET_TET) ? 3 : 2;
+          double sum = 0;
+          for (int i = 0; i < n; i++)
+            {
+              ip(i) = max2 (ip(i), 0.0);
+              sum += ip(i);
+            }
+          if (sum > 1)
+            for (int i = 0; i < n; i++)
+              ip(i) /= sum;
+          if (et == ET_PRISM) clamp01 (ip(2));
+          break;
+        }
+      case ET_PYRAMID:
+        clamp01 (ip(2));
+        for (int i = 0; i < 2; i++)
+          ip(i) = min2 (max2 (ip(i), 0.0), 1-ip(2));
+        break;
+      default:
+        break;
+      }
+  }
+
+
+  double ProjectToElement (const ElementTransformation & trafo,
+                           Vec<3> point, IntegrationPoint & ip)
+  {
+    ELEMENT_TYPE et = trafo.GetElementType();
+    int dimr = ElementTopology::GetSpaceDim (et);
+    int dims = trafo.SpaceDim();
+
+    // start in the center of the reference element
+    const POINT3D * verts = ElementTopology::GetVertices (et);
+    int nv = ElementTopology::GetNVertices (et);
+    Vec<3> xi = 0.0;
+    for (int i = 0; i < nv; i++)
+      for (int k = 0; k < 3; k++)
+        xi(k) += verts[i][k] / nv;
+    ip = IntegrationPoint (xi(0), xi(1), xi(2), 0);
+
+    double memx[3], memjac[9];
+    FlatVector<> x(dims, memx);
+    FlatMatrix<> jac(dims, dimr, memjac);
+    double dist = 0;
+    double change = 1;
+
+    for (int it = 0; it < 20; it++)
+      {
+        trafo.CalcPointJacobian (ip, x, jac);
+        Vec<3> r = 0.0;
+        for (int k = 0; k < dims; k++)
+          r(k) = point(k) - x(k);
+        dist = L2Norm (r);
+        if (dimr == 0 || change < 1e-12) break;
+
+        // Gauss-Newton step  J^T J d = J^T r
+        Vec<3> d = 0.0;
+        Vec<3> jtr = 0.0;
+        for (int i = 0; i < dimr; i++)
+          for (int k = 0; k < dims; k++)
+            jtr(i) += jac(k,i) * r(k);
+        switch (dimr)
+          {
+          case 1:
+            {
+              double jtj = 0;
+              for (int k = 0; k < dims; k++)
+                jtj += sqr (jac(k,0));
+              if (jtj > 0) d(0) = jtr(0) / jtj;
+              break;
+            }
+          case 2:
+            {
+              Mat<2,2> jtj = 0.0;
+              for (int i = 0; i < 2; i++)
+                for (int j = 0; j < 2; j++)
+                  for (int k = 0; k < dims; k++)
+                    jtj(i,j) += jac(k,i) * jac(k,j);
+              if (Det (jtj) != 0)
+                {
+                  Vec<2> h = Inv(jtj) * Vec<2> (jtr(0), jtr(1));
+                  d(0) = h(0); d(1) = h(1);
+                }
+              break;
+            }
+          case 3:
+            {
+              Mat<3,3> jtj = 0.0;
+              for (int i = 0; i < 3; i++)
+                for (int j = 0; j < 3; j++)
+                  for (int k = 0; k < dims; k++)
+                    jtj(i,j) += jac(k,i) * jac(k,j);
+              if (Det (jtj) != 0)
+                d = Inv(jtj) * jtr;
+              break;
+            }
+          }
+
+        Vec<3> old (ip(0), ip(1), ip(2));
+        for (int i = 0; i < dimr; i++)
+          ip(i) += d(i);
+        ClampToReference (et, ip);
+        change = 0;
+        for (int i = 0; i < dimr; i++)
+          change += sqr (ip(i) - old(i));
+        change = sqrt (change);
+      }
+    return dist;
+  }
+
+
+  /*
+    The box of the element from its mapped vertices. For curved
+    elements additional points are mapped, and the box is enlarged.
+    With a deformation also straight elements may be curved.
+  */
+  static void ElementBox (const ElementTransformation & trafo, bool deformed,
+                          Vec<3> & pmin, Vec<3> & pmax)
+  {
+    ELEMENT_TYPE et = trafo.GetElementType();
+    int dims = trafo.SpaceDim();
+    pmin = numeric_limits<double>::max();
+    pmax = -numeric_limits<double>::max();
+
+    double memx[3];
+    FlatVector<> x(dims, memx);
+    auto add = [&] (const IntegrationPoint & ip)
+      {
+        trafo.CalcPoint (ip, x);
+        for (int k = 0; k < dims; k++)
+          {
+            pmin(k) = min2 (pmin(k), x(k));
+            pmax(k) = max2 (pmax(k), x(k));
+          }
+      };
+
+    const POINT3D * verts = ElementTopology::GetVertices (et);
+    for (int i = 0; i < ElementTopology::GetNVertices (et); i++)
+      add (IntegrationPoint (verts[i][0], verts[i][1], verts[i][2], 0));
+    bool curved = deformed || trafo.IsCurvedElement();
+    if (curved)
+      {
+        IntegrationRule ir(et, 4);
+        for (auto & ip : ir)
+          add (ip);
+      }
+    for (int k = dims; k < 3; k++)
+      pmin(k) = pmax(k) = 0;
+
+    double size = L2Norm (pmax-pmin);
+    double eps = curved ? 0.1*size : 1e-6*size;
+    for (int k = 0; k < 3; k++)
+      {
+        pmin(k) -= eps;
+        pmax(k) += eps;
+      }
+  }
+
+  static bool BoxContains (const Vec<3> & pmin, const Vec<3> & pmax, const Vec<3> & p)
+  {
+    for (int k = 0; k < 3; k++)
+      if (p(k) < pmin(k) || p(k) > pmax(k)) return false;
+    return true;
+  }
+
+  static double BoxDistance (const Vec<3> & pmin, const Vec<3> & pmax, const Vec<3> & p)
+  {
+    double sum = 0;
+    for (int k = 0; k < 3; k++)
+      {
+        double d = max2 (pmin(k)-p(k), p(k)-pmax(k));
+        if (d > 0) sum += d*d;
+      }
+    return sqrt (sum);
+  }
+
+  /// position of the point on the Morton space filling curve
+  static size_t MortonCode (Vec<3> p, Vec<3> pmin, Vec<3> pmax)
+  {
+    size_t code = 0;
+    size_t coords[3];
+    for (int k = 0; k < 3; k++)
+      {
+        double len = pmax(k) - pmin(k);
+        double rel = (len > 0) ? (p(k)-pmin(k)) / len : 0;
+        coords[k] = min2 (size_t (rel * (1 << 21)), size_t ((1 << 21) - 1));
+      }
+    for (int bit = 20; bit >= 0; bit--)
+      for (int k = 0; k < 3; k++)
+        code = (code << 1) | ((coords[k] >> bit) & 1);
+    return code;
+  }
+
+
+  ElementSearchTree :: ElementSearchTree (const MeshAccess & ama, VorB avb, size_t atimestamp)
+    : ma(ama), vb(avb), timestamp(atimestamp)
+  {
+    static Timer t("ElementSearchTree - build");
+    RegionTimer reg(t);
+
+    size_t ne = ma.GetNE(vb);
+    bool deformed = ma.GetDeformation() != nullptr;
+    Array<Vec<3>> emin(ne), emax(ne);
+    ParallelForRange (ne, [&] (IntRange r)
+                      {
+                        LocalHeapMem<100000> lh("ElementSearchTree - box");
+                        for (auto i : r)
+                          {
+                            HeapReset hr(lh);
+                            auto & trafo = ma.GetTrafo (ElementId(vb, i), lh);
+                            ElementBox (trafo, deformed, emin[i], emax[i]);
+                          }
+                      });
+
+    Vec<3> gmin = numeric_limits<double>::max();
+    Vec<3> gmax = -numeric_limits<double>::max();
+    for (size_t i = 0; i < ne; i++)
+      for (int k = 0; k < 3; k++)
+        {
+          gmin(k) = min2 (gmin(k), emin[i](k));
+          gmax(k) = max2 (gmax(k), emax[i](k));
+        }
+
+    Array<size_t> codes(ne);
+    elorder.SetSize (ne);
+    ParallelFor (ne, [&] (size_t i)
+                 {
+                   codes[i] = MortonCode (0.5 * (emin[i]+emax[i]), gmin, gmax);
+                   elorder[i] = i;
+                 });
+    QuickSortI (codes, elorder);
+
+    elmin.SetSize (ne);
+    elmax.SetSize (ne);
+    elsize.SetSize (ne);
+    ParallelFor (ne, [&] (size_t k)
+                 {
+                   elmin[k] = emin[elorder[k]];
+                   elmax[k] = emax[elorder[k]];
+                   elsize[k] = L2Norm (elmax[k]-elmin[k]);
+                 });
+
+    // balanced binary tree over ranges of the sorted elements,
+    // children are stored after their parents
+    const int leafsize = 8;
+    nodes.SetAllocSize (2*(ne/leafsize+1));
+    nodes.Append (Node { gmin, gmax, 0, 0, int(ne), -1 });
+    for (size_t i = 0; i < nodes.Size(); i++)
+      {
+        int first = nodes[i].first, next = nodes[i].next;
+        if (next-first <= leafsize) continue;
+        int mid = (first+next) / 2;
+        nodes[i].child = nodes.Size();
+        nodes.Append (Node { gmin, gmax, 0, first, mid, -1 });
+        nodes.Append (Node { gmin, gmax, 0, mid, next, -1 });
+      }
+
+    ParallelFor (nodes.Size(), [&] (size_t i)
+                 {
+                   Node & node = nodes[i];
+                   if (node.child != -1) return;
+                   node.pmin = numeric_limits<double>::max();
+                   node.pmax = -numeric_limits<double>::max();
+                   node.maxsize = 0;
+                   for (int k = node.first; k < node.next; k++)
+                     for (int j = 0; j < 3; j++)
+                       {
+                         node.pmin(j) = min2 (node.pmin(j), elmin[k](j));
+                         node.pmax(j) = max2 (node.pmax(j), elmax[k](j));
+                         node.maxsize = max2 (node.maxsize, elsize[k]);
+                       }
+                 });
+
+    for (size_t i = nodes.Size(); i-- > 0; )
+      {
+        Node & node = nodes[i];
+        if (node.child == -1) continue;
+        const Node & c0 = nodes[node.child];
+        const Node & c1 = nodes[node.child+1];
+        for (int j = 0; j < 3; j++)
+          {
+            node.pmin(j) = min2 (c0.pmin(j), c1.pmin(j));
+            node.pmax(j) = max2 (c0.pmax(j), c1.pmax(j));
+          }
+        node.maxsize = max2 (c0.maxsize, c1.maxsize);
+      }
+  }
+
+
+  bool ElementSearchTree :: InRegions (int elnr, const Array<int> * indices) const
+  {
+    if (!indices) return true;
+    return indices->Contains (ma.GetElIndex (ElementId(vb, elnr)));
+  }
+
+
+  int ElementSearchTree :: Find (Vec<3> point, IntegrationPoint & ip, LocalHeap & lh,
+                                 double reltol, const Array<int> * indices) const
+  {
+    ArrayMem<int,100> stack;
+    stack.Append (0);
+    while (stack.Size())
+      {
+        const Node & node = nodes[stack.Last()];
+        stack.DeleteLast();
+        if (!BoxContains (node.pmin, node.pmax, point)) continue;
+        if (node.child != -1)
+          {
+            stack.Append (node.child);
+            stack.Append (node.child+1);
+            continue;
+          }
+
+        for (int k = node.first; k < node.next; k++)
+          {
+            if (!BoxContains (elmin[k], elmax[k], point)) continue;
+            int elnr = elorder[k];
+            if (!InRegions (elnr, indices)) continue;
+            HeapReset hr(lh);
+            auto & trafo = ma.GetTrafo (ElementId(vb, elnr), lh);
+            if (ProjectToElement (trafo, point, ip) <= 1e-8 * elsize[k])
+              return elnr;
+          }
+      }
+
+    if (reltol > 0)
+      return FindNearest (point, ip, lh, reltol, indices);
+    return -1;
+  }
+
+
+  int ElementSearchTree :: FindNearest (Vec<3> point, IntegrationPoint & ip, LocalHeap & lh,
+                                        double reltol, const Array<int> * indices) const
+  {
+    int best = -1;
+    double bestdist = numeric_limits<double>::max();
+    IntegrationPoint hip;
+
+    ArrayMem<int,100> stack;
+    stack.Append (0);
+    while (stack.Size())
+      {
+        const Node & node = nodes[stack.Last()];
+        stack.DeleteLast();
+        double boxdist = BoxDistance (node.pmin, node.pmax, point);
+        if (boxdist > reltol * node.maxsize || boxdist >= bestdist) continue;
+        if (node.child != -1)
+          {
+            stack.Append (node.child);
+            stack.Append (node.child+1);
+            continue;
+          }
+
+        for (int k = node.first; k < node.next; k++)
+          {
+            double eldist = BoxDistance (elmin[k], elmax[k], point);
+            if (eldist > reltol * elsize[k] || eldist >= bestdist) continue;
+            int elnr = elorder[k];
+            if (!InRegions (elnr, indices)) continue;
+            HeapReset hr(lh);
+            auto & trafo = ma.GetTrafo (ElementId(vb, elnr), lh);
+            double dist = ProjectToElement (trafo, point, hip);
+            if (dist <= reltol * elsize[k] && dist < bestdist)
+              {
+                best = elnr;
+                bestdist = dist;
+                ip = hip;
+              }
+          }
+      }
+    return best;
+  }
+
+}
@@ -0,0 +1,87 @@
+#ifndef FILE_SEARCHTREE
+#define FILE_SEARCHTREE
+
+/*********************************************************************/
+/* File:   searchtree.hpp                                            */
+/* Date:   Oct. 2026                                                 */
+/*********************************************************************/
+
+namespace ngcomp
+{
+
+  /**
+     Distance of the point to the mapped element. Computes the reference
+     coordinates of the point by a Gauss-Newton iteration, restricted to
+     the reference element. ip returns the closest reference point, the
+     distance is zero if the element contains the point. For boundary
+     elements this is the projection onto the surface.
+   */
+  NGS_DLL_HEADER double ProjectToElement (const ElementTransformation & trafo,
+                                          Vec<3> point, IntegrationPoint & ip);
+
+
+  /**
+     Bounding volume hierarchy over the element boxes of a mesh, for
+     point location in volume or boundary elements.
+
+     Elements are sorted along a space filling curve, the element boxes
+     are computed in parallel. The tree is not changed after the
+     construction, so any number of threads can search concurrently
+     without locks. Boxes of curved or deformed elements are enlarged,
+     since they are computed from mapped sample points.
+
+     MeshAccess keeps one tree for VOL and one for BND elements, and
+     rebuilds it when the geometry timestamp changes, also after the
+     deformation was changed in place.
+   */
+  class NGS_DLL_HEADER ElementSearchTree
+  {
+    struct Node
+    {
+      Vec<3> pmin, pmax;
+      /// largest element size in the subtree
+      double maxsize;
+      /// elements elorder[first] ... elorder[next-1]
+      int first, next;
+      /// left child, the right one is child+1. -1 for leaves
+      int child;
+    };
+
+    const MeshAccess & ma;
+    VorB vb;
+    size_t timestamp;
+    Array<Node> nodes;
+    Array<int> elorder;
+    /// element boxes and diameters, in the order of elorder
+    Array<Vec<3>> elmin, elmax;
+    Array<double> elsize;
+
+    bool InRegions (int elnr, const Array<int> * indices) const;
+
+  public:
+    /// atimestamp is the geometry timestamp of the mesh the tree is valid for
+    ElementSearchTree (const MeshAccess & ama, VorB avb, size_t atimestamp);
+
+    const MeshAccess & GetMesh () const { return ma; }
+    VorB GetVorB () const { return vb; }
+    size_t GetTimeStamp () const { return timestamp; }
+
+    /**
+       The element containing the point, -1 if there is none. ip returns
+       the reference coordinates. With reltol > 0, a point outside all
+       elements is assigned to the closest element, if its distance is
+       at most reltol times the element size (e.g. for points on a
+       curved boundary). With indices, only elements in these regions
+       are searched.
+     */
+    int Find (Vec<3> point, IntegrationPoint & ip, LocalHeap & lh,
+              double reltol = 0, const Array<int> * indices = nullptr) const;
+
+    /// the closest element within reltol times its size, or -1
+    int FindNearest (Vec<3> point, IntegrationPoint & ip, LocalHeap & lh,
+                     double reltol, const Array<int> * indices = nullptr) const;
+  };
+
+}
+
+#endif
@@ -5,6 +5,9 @@
 /*********************************************************************/
 
 #include <comp.hpp>
+#ifdef NGS_ZLIB
+#include <zlib.h>
+#endif
 
 namespace ngcomp
 { 
@@ -19,7 +22,9 @@ namespace ngcomp
                 flags.GetStringListFlag ("fieldnames" ),
                 flags.GetStringFlag ("filename","output"),
                 (int) flags.GetNumFlag ( "subdivision", 0),
-                (int) flags.GetNumFlag ( "only_element", -1))
+                (int) flags.GetNumFlag ( "only_element", -1),
+                flags.GetStringFlag ("format", "legacy"),
+                flags.GetDefineFlag ("compress"))
   {;}
 
 
@@ -27,10 +32,21 @@ namespace ngcomp
   VTKOutput<D>::VTKOutput (shared_ptr<MeshAccess> ama,
                            const Array<shared_ptr<CoefficientFunction>> & a_coefs,
                            const Array<string> & a_field_names,
-                           string a_filename, int a_subdivision, int a_only_element)
+                           string a_filename, int a_subdivision, int a_only_element,
+                           string a_format, bool a_compress)
     : ma(ama), coefs(a_coefs), fieldnames(a_field_names),
-      filename(a_filename), subdivision(a_subdivision), only_element(a_only_element)
+      filename(a_filename), subdivision(a_subdivision), only_element(a_only_element),
+      format(a_format), compress(a_compress)
   {
+    if (format != "legacy" && format != "vtu")
+      throw Exception ("VTKOutput: unknown format '"+format+"', use 'legacy' or 'vtu'");
+#ifndef NGS_ZLIB
+    if (compress)
+      {
+        cout << IM(1) << "VTKOutput: compiled without zlib, writing uncompressed data" << endl;
+        compress = false;
+      }
+#endif
     value_field.SetSize(a_coefs.Size());
     for (int i = 0; i < a_coefs.Size(); i++)
       if (fieldnames.Size() > i)
@@ -46,6 +62,7 @@ namespace ngcomp
   {
     points.SetSize(0);
     cells.SetSize(0);
+    celltypes.SetSize(0);
     for (auto field : value_field)
       field->SetSize(0);
   }
@@ -347,42 +364,13 @@ namespace ngcomp
     }
   }
 
-  /// output of cell types (here only simplices)
+  /// output of cell types
   template <int D> 
   void VTKOutput<D>::PrintCellTypes()
   {
     *fileout << "CELL_TYPES " << cells.Size() << endl;
-    int factor = (1<<subdivision)*(1<<subdivision);
-    if (D==3)
-      factor *= (1<<subdivision);
-    for (auto e : ma->Elements(VOL))
-    {
-      switch(ma->GetElType(e))
-      {
-      case ET_TET:
-        for(int i=0; i<factor; i++)
-          *fileout << "10 " << endl; //(void)c;
-        break;
-      case ET_QUAD:
-        for(int i=0; i<factor; i++)
-          *fileout << "9 " << endl;
-        break;
-      case ET_TRIG:
-        for(int i=0; i<factor; i++)
-          *fileout << "5 " << endl;
-        break;
-      case ET_PRISM:
-        for(int i=0; i<factor; i++)
-          *fileout << "13 " << endl;
-        break;
-      case ET_HEX:
-        for(int i=0; i<factor; i++)
-          *fileout << "12 " << endl;
-        break;        
-      default:
-        cout << "VTKOutput Element Type " << ma->GetElType(e) << " not supported!" << endl;
-      }
-    }
+    for (auto type : celltypes)
+      *fileout << int(type) << " " << endl;
     *fileout << "CELL_DATA " << cells.Size() << endl;
     *fileout << "POINT_DATA " << points.Size() << endl;
   }
@@ -406,15 +394,211 @@ namespace ngcomp
   }
     
 
+  static const char * ByteOrder ()
+  {
+    uint16_t one = 1;
+    return *(char*)&one ? "LittleEndian" : "BigEndian";
+  }
+
+  /*
+    One data array of the appended section of a vtu file.
+    Uncompressed:  UInt64 number of bytes, data.
+    Compressed:    UInt64 header (number of blocks, block size, size of
+                   the last block, compressed size of every block),
+                   compressed blocks.
+  */
+  template <typename T>
+  static Array<char> EncodeDataArray (FlatArray<T> data, bool compress)
+  {
+    uint64_t nbytes = data.Size() * sizeof(T);
+    const char * raw = nbytes ? (const char*) &data[0] : nullptr;
+    Array<char> enc;
+
+    if (!compress)
+      {
+        enc.SetSize (sizeof(uint64_t) + nbytes);
+        memcpy (&enc[0], &nbytes, sizeof(uint64_t));
+        if (nbytes)
+          memcpy (&enc[sizeof(uint64_t)], raw, nbytes);
+        return enc;
+      }
+
+#ifdef NGS_ZLIB
+    constexpr size_t bs = 1 << 16;
+    size_t nblocks = (nbytes + bs - 1) / bs;
+    Array<Array<char>> blocks(nblocks);
+    atomic<bool> failed(false);
+    ParallelFor (nblocks, [&] (size_t i)
+                 {
+                   size_t first = i*bs, next = min2 (size_t(nbytes), first+bs);
+                   uLongf clen = compressBound (next-first);
+                   blocks[i].SetSize (clen);
+                   // fastest level, output time matters more than file size
+                   if (compress2 ((Bytef*)&blocks[i][0], &clen, (const Bytef*)raw+first,
+                                  next-first, Z_BEST_SPEED) != Z_OK)
+                     failed = true;
+                   blocks[i].SetSize (clen);
+                 });
+    if (failed)
+      throw Exception ("VTKOutput: zlib compression failed");
+
+    Array<uint64_t> header(3+nblocks);
+    header[0] = nblocks;
+    header[1] = bs;
+    header[2] = nbytes - (nblocks ? (nblocks-1)*bs : 0);
+    size_t size = header.Size()*sizeof(uint64_t);
+    for (size_t i = 0; i < nblocks; i++)
+      {
+        header[3+i] = blocks[i].Size();
+        size += blocks[i].Size();
+      }
+
+    enc.SetSize (size);
+    memcpy (&enc[0], &header[0], header.Size()*sizeof(uint64_t));
+    size_t pos = header.Size()*sizeof(uint64_t);
+    for (auto & block : blocks)
+      {
+        if (block.Size())
+          memcpy (&enc[pos], &block[0], block.Size());
+        pos += block.Size();
+      }
+#endif
+    return enc;
+  }
+
+
+  template <int D>
+  void VTKOutput<D>::WriteVTU (const string & vtuname)
+  {
+    size_t np = points.Size(), nc = cells.Size();
+
+    // the binary data arrays, converted in parallel
+    Array<Array<char>> blocks;
+    {
+      Array<float> coords(3*np);
+      ParallelFor (np, [&] (size_t i)
+                   {
+                     for (int k = 0; k < 3; k++)
+                       coords[3*i+k] = (k < D) ? points[i](k) : 0.0;
+                   });
+      blocks.Append (EncodeDataArray (FlatArray<float>(coords), compress));
+    }
+    {
+      Array<int64_t> offsets(nc);
+      int64_t sum = 0;
+      for (size_t i = 0; i < nc; i++)
+        offsets[i] = (sum += cells[i][0]);
+      Array<int64_t> connectivity(sum);
+      ParallelFor (nc, [&] (size_t i)
+                   {
+                     int nv = cells[i][0];
+                     for (int j = 0; j < nv; j++)
+                       connectivity[offsets[i]-nv+j] = cells[i][j+1];
+                   });
+      blocks.Append (EncodeDataArray (FlatArray<int64_t>(connectivity), compress));
+      blocks.Append (EncodeDataArray (FlatArray<int64_t>(offsets), compress));
+      blocks.Append (EncodeDataArray (FlatArray<unsigned char>(celltypes), compress));
+    }
+    for (auto field : value_field)
+      {
+        Array<float> values(field->Size());
+        ParallelFor (values.Size(), [&] (size_t i) { values[i] = (*field)[i]; });
+        blocks.Append (EncodeDataArray (FlatArray<float>(values), compress));
+      }
+
+    ofstream out(vtuname, ios::binary);
+    if (!out)
+      throw Exception ("VTKOutput: cannot open file " + vtuname);
+
+    out << "<?xml version=\"1.0\"?>\n"
+        << "<VTKFile type=\"UnstructuredGrid\" version=\"1.0\" byte_order=\"" << ByteOrder()
+        << "\" header_type=\"UInt64\"";
+    if (compress)
+      out << " compressor=\"vtkZLibDataCompressor\"";
+    out << ">\n<UnstructuredGrid>\n"
+        << "<Piece NumberOfPoints=\"" << np << "\" NumberOfCells=\"" << nc << "\">\n";
+
+    size_t offset = 0, nr = 0;
+    auto DataArray = [&] (string type, string name, int ncomp)
+      {
+        out << "<DataArray type=\"" << type << "\"";
+        if (name != "")
+          out << " Name=\"" << name << "\"";
+        out << " NumberOfComponents=\"" << ncomp << "\" format=\"appended\" offset=\""
+            << offset << "\"/>\n";
+        offset += blocks[nr++].Size();
+      };
+
+    out << "<Points>\n";
+    DataArray ("Float32", "", 3);
+    out << "</Points>\n<Cells>\n";
+    DataArray ("Int64", "connectivity", 1);
+    DataArray ("Int64", "offsets", 1);
+    DataArray ("UInt8", "types", 1);
+    out << "</Cells>\n<PointData>\n";
+    for (auto field : value_field)
+      DataArray ("Float32", field->Name(), field->Dimension());
+    out << "</PointData>\n</Piece>\n</UnstructuredGrid>\n"
+        << "<AppendedData encoding=\"raw\">\n_";
+    for (auto & block : blocks)
+      out.write (&block[0], block.Size());
+    out << "\n</AppendedData>\n</VTKFile>\n";
+  }
+
+
+  template <int D>
+  void VTKOutput<D>::WritePVTU (const string & pvtuname, const string & piecebase)
+  {
+    // pieces are referenced relative to the pvtu file
+    string base = piecebase.substr (piecebase.find_last_of("/\\")+1);
+
+    ofstream out(pvtuname);
+    if (!out)
+      throw Exception ("VTKOutput: cannot open file " + pvtuname);
+
+    out << "<?xml version=\"1.0\"?>\n"
+        << "<VTKFile type=\"PUnstructuredGrid\" version=\"1.0\" byte_order=\"" << ByteOrder()
+        << "\" header_type=\"UInt64\">\n"
+        << "<PUnstructuredGrid GhostLevel=\"0\">\n"
+        << "<PPoints>\n<PDataArray type=\"Float32\" NumberOfComponents=\"3\"/>\n</PPoints>\n"
+        << "<PPointData>\n";
+    for (auto field : value_field)
+      out << "<PDataArray type=\"Float32\" Name=\"" << field->Name()
+          << "\" NumberOfComponents=\"" << field->Dimension() << "\"/>\n";
+    out << "</PPointData>\n";
+    for (int rank = 0; rank < MyMPI_GetNTasks(); rank++)
+      out << "<Piece Source=\"" << base << "_" << rank << ".vtu\"/>\n";
+    out << "</PUnstructuredGrid>\n</VTKFile>\n";
+  }
+
+
+  /// VTK cell type of the sub-cells of an element
+  static unsigned char VTKCellType (ELEMENT_TYPE eltype)
+  {
+    switch (eltype)
+      {
+      case ET_TRIG:  return 5;
+      case ET_QUAD:  return 9;
+      case ET_TET:   return 10;
+      case ET_HEX:   return 12;
+      case ET_PRISM: return 13;
+      default:
+        throw Exception("VTK output for element-type"+ToString(eltype)+"not supported");
+      }
+  }
+
+
   template <int D> 
   void VTKOutput<D>::Do (LocalHeap & lh, const BitArray * drawelems)
   {
+    static Timer t("VTKOutput::Do"); RegionTimer reg(t);
+    static Timer tevaluate("VTKOutput::Do - evaluate");
+    static Timer twrite("VTKOutput::Do - write");
+
     ostringstream filenamefinal;
     filenamefinal << filename;
     if (output_cnt > 0)
       filenamefinal << "_" << output_cnt;
-    filenamefinal << ".vtk";
-    fileout = make_shared<ofstream>(filenamefinal.str());
     cout << " Writing VTK-Output";
     if (output_cnt > 0)
       cout << " ( " << output_cnt << " )";
@@ -426,101 +610,141 @@ namespace ngcomp
 
     Array<IntegrationPoint> ref_vertices_tet(0), ref_vertices_prism(0), ref_vertices_trig(0), ref_vertices_quad(0), ref_vertices_hex(0);
     Array<INT<ELEMENT_MAXPOINTS+1>> ref_tets(0), ref_prisms(0), ref_trigs(0), ref_quads(0), ref_hexes(0);
-    FlatArray<IntegrationPoint> ref_vertices;
-    FlatArray<INT<ELEMENT_MAXPOINTS+1>> ref_elems;
-    /*
-    if (D==3)
-      FillReferenceData3D(ref_vertices,ref_tets);
-    else
-      FillReferenceData2D(ref_vertices,ref_tets);
-    */
     FillReferenceTet(ref_vertices_tet,ref_tets);
     FillReferencePrism(ref_vertices_prism,ref_prisms);
     FillReferenceQuad(ref_vertices_quad,ref_quads);
     FillReferenceTrig(ref_vertices_trig,ref_trigs);
     FillReferenceHex(ref_vertices_hex,ref_hexes);
-      
-    // header:
-    *fileout << "# vtk DataFile Version 3.0" << endl;
-    *fileout << "vtk output" << endl;
-    *fileout << "ASCII" << endl;
-    *fileout << "DATASET UNSTRUCTURED_GRID" << endl;
+
+    auto GetReference = [&] (ELEMENT_TYPE eltype,
+                             FlatArray<IntegrationPoint> & ref_vertices,
+                             FlatArray<INT<ELEMENT_MAXPOINTS+1>> & ref_elems)
+      {
+        switch(eltype)
+          {
+          case ET_TRIG:
+            ref_vertices.Assign(ref_vertices_trig);
+            ref_elems.Assign(ref_trigs);
+            break;
+          case ET_QUAD:
+            ref_vertices.Assign(ref_vertices_quad);
+            ref_elems.Assign(ref_quads);
+            break;
+          case ET_TET:
+            ref_vertices.Assign(ref_vertices_tet);
+            ref_elems.Assign(ref_tets);
+            break;
+          case ET_HEX:
+            ref_vertices.Assign(ref_vertices_hex);
+            ref_elems.Assign(ref_hexes);
+            break;        
+          case ET_PRISM:
+            ref_vertices.Assign(ref_vertices_prism);
+            ref_elems.Assign(ref_prisms);
+            break;
+          default:
+            throw Exception("VTK output for element-type"+ToString(eltype)+"not supported");
+          }
+      };
 
     int ne = ma->GetNE();
 
     IntRange range = only_element >= 0 ? IntRange(only_element,only_element+1) : IntRange(ne);
-    
-    for ( int elnr : range)
-    {
-      if (drawelems && !(drawelems->Test(elnr)))
-          continue;
-      
-      HeapReset hr(lh);
-
-      ElementId ei(VOL, elnr);
-      ElementTransformation & eltrans = ma->GetTrafo (ei, lh);
-      ELEMENT_TYPE eltype = ma->GetElType(ei);
 
-      switch(eltype)
+    // first points and first cells of the elements, then every element
+    // is evaluated and filled in independently
+    Array<size_t> firstpoint(ne+1), firstcell(ne+1);
+    firstpoint = 0;
+    firstcell = 0;
+    for ( int elnr : range)
       {
-      case ET_TRIG:
-        ref_vertices.Assign(ref_vertices_trig);
-        ref_elems.Assign(ref_trigs);
-        break;
-      case ET_QUAD:
-        ref_vertices.Assign(ref_vertices_quad);
-        ref_elems.Assign(ref_quads);
-        break;
-      case ET_TET:
-        ref_vertices.Assign(ref_vertices_tet);
-        ref_elems.Assign(ref_tets);
-        break;
-      case ET_HEX:
-        ref_vertices.Assign(ref_vertices_hex);
-        ref_elems.Assign(ref_hexes);
-        break;        
-      case ET_PRISM:
-        ref_vertices.Assign(ref_vertices_prism);
-        ref_elems.Assign(ref_prisms);
-        break;
-      default:
-        throw Exception("VTK output for element-type"+ToString(eltype)+"not supported");
+        if (drawelems && !(drawelems->Test(elnr)))
+          continue;
+        FlatArray<IntegrationPoint> ref_vertices;
+        FlatArray<INT<ELEMENT_MAXPOINTS+1>> ref_elems;
+        GetReference (ma->GetElType(ElementId(VOL, elnr)), ref_vertices, ref_elems);
+        firstpoint[elnr+1] = ref_vertices.Size();
+        firstcell[elnr+1] = ref_elems.Size();
       }
-
-      int offset = points.Size();
-      for ( auto ip : ref_vertices)
+    for (int i = 0; i < ne; i++)
       {
-        MappedIntegrationPoint<D,D> mip(ip, eltrans);
-        points.Append(mip.GetPoint());
+        firstpoint[i+1] += firstpoint[i];
+        firstcell[i+1] += firstcell[i];
       }
-      
-      for (int i = 0; i < coefs.Size(); i++)
+
+    points.SetSize (firstpoint[ne]);
+    cells.SetSize (firstcell[ne]);
+    celltypes.SetSize (firstcell[ne]);
+    for (auto field : value_field)
+      field->SetSize (firstpoint[ne] * field->Dimension());
+
+    tevaluate.Start();
+    ma->IterateElements
+      (VOL, lh, [&] (Ngs_Element el, LocalHeap & lh)
+       {
+         size_t elnr = el.Nr();
+         size_t first = firstpoint[elnr];
+         size_t npts = firstpoint[elnr+1] - first;
+         if (npts == 0) return;
+
+         FlatArray<IntegrationPoint> ref_vertices;
+         FlatArray<INT<ELEMENT_MAXPOINTS+1>> ref_elems;
+         GetReference (el.GetType(), ref_vertices, ref_elems);
+
+         IntegrationRule ir(ref_vertices.Size(), &ref_vertices[0]);
+         ElementTransformation & eltrans = ma->GetTrafo (el, lh);
+         BaseMappedIntegrationRule & mir = eltrans(ir, lh);
+
+         auto pts = mir.GetPoints();
+         for (size_t j = 0; j < npts; j++)
+           for (int k = 0; k < D; k++)
+             points[first+j](k) = pts(j,k);
+
+         for (int i = 0; i < coefs.Size(); i++)
+           {
+             int dim = coefs[i]->Dimension();
+             FlatMatrix<> values(npts, dim, &(*value_field[i])[first*dim]);
+             coefs[i]->Evaluate (mir, values);
+           }
+
+         unsigned char type = VTKCellType (el.GetType());
+         size_t firstc = firstcell[elnr];
+         for (size_t j = 0; j < ref_elems.Size(); j++)
+           {
+             INT<ELEMENT_MAXPOINTS+1> new_elem = ref_elems[j];
+             for (int i = 1; i <= new_elem[0]; ++i)
+               new_elem[i] += first;
+             cells[firstc+j] = new_elem;
+             celltypes[firstc+j] = type;
+           }
+       });
+    tevaluate.Stop();
+
+    RegionTimer regw(twrite);
+    if (format == "legacy")
       {
-        for ( auto ip : ref_vertices)
-        {
-          MappedIntegrationPoint<D,D> mip(ip, eltrans);
-          const int dim = coefs[i]->Dimension();
-          FlatVector<> tmp(dim,lh);
-          coefs[i]->Evaluate(mip,tmp);
-          for (int d = 0; d < dim; ++d)
-            value_field[i]->Append(tmp(d));
-        }
+        fileout = make_shared<ofstream>(filenamefinal.str()+".vtk");
+
+        // header:
+        *fileout << "# vtk DataFile Version 3.0" << endl;
+        *fileout << "vtk output" << endl;
+        *fileout << "ASCII" << endl;
+        *fileout << "DATASET UNSTRUCTURED_GRID" << endl;
+
+        PrintPoints();
+        PrintCells();
+        PrintCellTypes();
+        PrintFieldData();
       }
-      
-      for ( auto elem : ref_elems)
+    else if (MyMPI_GetNTasks() == 1)
+      WriteVTU (filenamefinal.str()+".vtu");
+    else
       {
-        INT<ELEMENT_MAXPOINTS+1> new_elem = elem;
-        for (int i = 1; i <= new_elem[0]; ++i)
-          new_elem[i] += offset;
-        cells.Append(new_elem);
+        // one piece per rank, collected by the pvtu file
+        WriteVTU (filenamefinal.str()+"_"+ToString(MyMPI_GetId())+".vtu");
+        if (MyMPI_GetId() == 0)
+          WritePVTU (filenamefinal.str()+".pvtu", filenamefinal.str());
       }
-
-    }
-
-    PrintPoints();
-    PrintCells();
-    PrintCellTypes();
-    PrintFieldData();
       
     cout << " Done." << endl;
   }    
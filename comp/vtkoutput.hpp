@@ -44,10 +44,15 @@ namespace ngcomp
     string filename;
     int subdivision;
     int only_element = -1;
+    /// "legacy" (ASCII .vtk) or "vtu" (XML with appended binary data)
+    string format = "legacy";
+    /// zlib compression of the binary data blocks (vtu only)
+    bool compress = false;
 
     Array<shared_ptr<ValueField>> value_field;
     Array<Vec<D>> points;
     Array<INT<ELEMENT_MAXPOINTS+1>> cells;
+    Array<unsigned char> celltypes;
 
     int output_cnt = 0;
     
@@ -59,7 +64,8 @@ namespace ngcomp
                const Flags &,shared_ptr<MeshAccess>);
 
     VTKOutput (shared_ptr<MeshAccess>, const Array<shared_ptr<CoefficientFunction>> &,
-               const Array<string> &, string, int, int);
+               const Array<string> &, string, int, int,
+               string aformat = "legacy", bool acompress = false);
     virtual ~VTKOutput() { ; }
     
     void ResetArrays();
@@ -75,6 +81,11 @@ namespace ngcomp
     void PrintCellTypes();
     void PrintFieldData();    
 
+    /// points, cells and fields of this rank as one piece
+    void WriteVTU (const string & vtuname);
+    /// the collection of the pieces of all ranks, written by rank 0
+    void WritePVTU (const string & pvtuname, const string & piecebase);
+
     virtual void Do (LocalHeap & lh, const BitArray * drawelems = 0);
   };
 
@@ -3,11 +3,18 @@
 #include<l2hofe_impl.hpp>
 #include<l2hofefo.hpp>
 #include<regex>
+#ifdef WIN32
+#include <direct.h>
+#include <io.h>
+#include <process.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace ngfem
 {
-    atomic<unsigned> Code::id_counter{0};
-
     void Code::AddLinkFlag(string flag)
     {
         if(std::find(std::begin(link_flags), std::end(link_flags), flag) == std::end(link_flags))
@@ -16,66 +23,260 @@ namespace ngfem
 
     string Code::AddPointer(const void *p)
     {
-        string name = "compiled_code_pointer" + ToString(id_counter++); 
-        top += "extern \"C\" void* " + name + ";\n";
-        stringstream s_ptr;
+        pointers.push_back(const_cast<void*>(p));
+        return "compiled_code_pointers[" + ToString(pointers.size()-1) + "]";
+    }
+
+    namespace
+    {
+      // 64 bit FNV-1a, the same in every run
+      uint64_t HashString (const string & str, uint64_t hash = 14695981039346656037ull)
+      {
+        for (unsigned char c : str)
+          {
+            hash ^= c;
+            hash *= 1099511628211ull;
+          }
+        return hash;
+      }
+
+      bool FileExists (const string & filename)
+      {
+        ifstream f(filename);
+        return f.good();
+      }
+
+      void MakeDirectories (const string & path)
+      {
+        size_t pos = 0;
+        do
+          {
+            pos = path.find_first_of ("/\\", pos+1);
+            string dir = path.substr (0, pos);
+#ifdef WIN32
+            _mkdir (dir.c_str());
+#else
+            mkdir (dir.c_str(), 0755);
+#endif
+          }
+        while (pos != string::npos);
+      }
+
+      int ProcessId ()
+      {
 #ifdef WIN32
-        s_ptr << "0x";
+        return _getpid();
+#else
+        return getpid();
 #endif
-        s_ptr << std::hex << p;
-        pointer += "void *" + name + " = reinterpret_cast<void*>(" + s_ptr.str() + ");\n";
-        return name;
+      }
+
+      // name, size and modification time of the installed headers,
+      // the generated code is compiled against them
+      string HeaderStamp ()
+      {
+        std::vector<string> entries;
+#ifdef NGSOLVE_HEADER_DIR
+        string dir = NGSOLVE_HEADER_DIR;
+#ifdef WIN32
+        _finddata_t data;
+        auto handle = _findfirst ((dir+"\\*").c_str(), &data);
+        if (handle != -1)
+          {
+            do
+              if (!(data.attrib & _A_SUBDIR))
+                entries.push_back (string(data.name) + " " + ToString(data.size) + " " + ToString(data.time_write));
+            while (_findnext (handle, &data) == 0);
+            _findclose (handle);
+          }
+#else
+        if (DIR * d = opendir (dir.c_str()))
+          {
+            while (auto entry = readdir (d))
+              {
+                string name = entry->d_name;
+                struct stat st;
+                if (stat ((dir+"/"+name).c_str(), &st) == 0 && S_ISREG(st.st_mode))
+                  entries.push_back (name + " " + ToString(st.st_size) + " " + ToString(st.st_mtime));
+              }
+            closedir (d);
+          }
+#endif
+#endif
+        sort (entries.begin(), entries.end());
+        string stamp;
+        for (auto & entry : entries)
+          stamp += entry + "\n";
+        return stamp;
+      }
+
+      void RemoveFiles (const std::vector<string> & files)
+      {
+        for (auto & file : files)
+          remove (file.c_str());
+      }
+    }
+
+    string GetCodeCacheDirectory()
+    {
+      if (auto dir = getenv ("NGSOLVE_CACHE_DIR"))
+        return dir;
+#ifdef WIN32
+      if (auto dir = getenv ("LOCALAPPDATA"))
+        return string(dir) + "\\ngsolve\\compiled_code";
+#else
+      if (auto dir = getenv ("XDG_CACHE_HOME"))
+        return string(dir) + "/ngsolve/compiled_code";
+      if (auto dir = getenv ("HOME"))
+        return string(dir) + "/.cache/ngsolve/compiled_code";
+#endif
+      return "ngsolve_compiled_code";
     }
 
     unique_ptr<SharedLibrary> CompileCode(const std::vector<string> &codes, const std::vector<string> &link_flags )
     {
-      static int counter = 0;
+      static atomic<int> counter{0};
       static ngstd::Timer tcompile("CompiledCF::Compile");
       static ngstd::Timer tlink("CompiledCF::Link");
-      string object_files;
-      int i = 0;
-      string prefix = "code" + ToString(counter++);
-      for(string code : codes) {
-        string file_prefix = prefix+"_"+ToString(i++);
-        ofstream codefile(file_prefix+".cpp");
-        codefile << code;
-        codefile.close();
-        cout << IM(3) << "compiling..." << endl;
-        tcompile.Start();
+
+      // the library depends on the installed headers and the compiler,
+      // a reinstall without a rebuild of this file changes the stamp
+      static string abi = [] ()
+        {
+          string abi = ngsolve_version + " " + __DATE__ + " " + __TIME__;
+#ifdef __VERSION__
+          abi += string(" ") + __VERSION__;
+#endif
+          return abi + "\n" + HeaderStamp();
+        } ();
+      uint64_t hash = HashString (abi);
+      for (auto & code : codes)
+        hash = HashString (code, HashString ("\n// next file\n", hash));
+      for (auto & flag : link_flags)
+        hash = HashString (" " + flag, hash);
+
+      stringstream key;
+      key << "code_" << std::hex << std::setw(16) << std::setfill('0') << hash;
+      string dir = GetCodeCacheDirectory();
 #ifdef WIN32
-        string scompile = "cmd /C \"ngscxx.bat " + file_prefix + ".cpp\"";
-        object_files += file_prefix+".obj ";
+      string libname = dir + "\\" + key.str() + ".dll";
 #else
-        string scompile = "ngscxx -c " + file_prefix + ".cpp -o " + file_prefix + ".o";
-        object_files += file_prefix+".o ";
+      string libname = dir + "/" + key.str() + ".so";
 #endif
-        int err = system(scompile.c_str());
-        if (err) throw Exception ("problem calling compiler");
-        tcompile.Stop();
-      }
 
-      cout << IM(3) << "linking..." << endl;
-      tlink.Start();
+      if (FileExists (libname))
+        cout << IM(3) << "load compiled code from " << libname << endl;
+      else
+        {
+          MakeDirectories (dir);
+          // private file names, other processes may compile the same code
+          string prefix = dir + "/tmp_" + key.str() + "_" + ToString(ProcessId()) + "_" + ToString(counter++);
+          string object_files;
+          std::vector<string> tmp_files;
+          int i = 0;
+          for(string code : codes) {
+            string file_prefix = prefix+"_"+ToString(i++);
+            ofstream codefile(file_prefix+".cpp");
+            codefile << code;
+            codefile.close();
+            tmp_files.push_back (file_prefix+".cpp");
+            cout << IM(3) << "compiling..." << endl;
+            tcompile.Start();
 #ifdef WIN32
-        string slink = "cmd /C \"ngsld.bat /OUT:" + prefix+".dll " + object_files + "\"";
+            string scompile = "cmd /C \"ngscxx.bat \"" + file_prefix + ".cpp\"\"";
+            object_files += "\"" + file_prefix+".obj\" ";
+            tmp_files.push_back (file_prefix+".obj");
 #else
-        string slink = "ngsld -shared " + object_files + " -o " + prefix + ".so -lngstd -lngbla -lngfem";
-        for (auto flag : link_flags)
-            slink += " "+flag;
+            string scompile = "ngscxx -c \"" + file_prefix + ".cpp\" -o \"" + file_prefix + ".o\"";
+            object_files += "\"" + file_prefix+".o\" ";
+            tmp_files.push_back (file_prefix+".o");
 #endif
-      int err = system(slink.c_str());
-      if (err) throw Exception ("problem calling linker");      
-      tlink.Stop();
-      cout << IM(3) << "done" << endl;
-      auto library = make_unique<SharedLibrary>();
+            int err = system(scompile.c_str());
+            tcompile.Stop();
+            if (err)
+              {
+                RemoveFiles (tmp_files);
+                throw Exception ("problem calling compiler");
+              }
+          }
+
+          cout << IM(3) << "linking..." << endl;
+          tlink.Start();
 #ifdef WIN32
-      library->Load(prefix+".dll");
+          string tmp_lib = prefix + ".dll";
+          string slink = "cmd /C \"ngsld.bat /OUT:\"" + tmp_lib + "\" " + object_files + "\"";
 #else
-      library->Load("./"+prefix+".so");
+          string tmp_lib = prefix + ".so";
+          string slink = "ngsld -shared " + object_files + " -o \"" + tmp_lib + "\" -lngstd -lngbla -lngfem";
+          for (auto flag : link_flags)
+              slink += " "+flag;
 #endif
+          int err = system(slink.c_str());
+          tlink.Stop();
+          RemoveFiles (tmp_files);
+          if (err)
+            {
+              remove (tmp_lib.c_str());
+              throw Exception ("problem calling linker");
+            }
+
+          // atomic, concurrent jobs write identical libraries
+          if (rename (tmp_lib.c_str(), libname.c_str()))
+            {
+              remove (tmp_lib.c_str());
+              if (!FileExists (libname))
+                throw Exception ("could not store compiled code in " + libname);
+            }
+          cout << IM(3) << "done" << endl;
+        }
+
+      auto library = make_unique<SharedLibrary>();
+      library->Load(libname);
       return library;
     }
 
+    string GenerateElementMatrixKernelCode (size_t n1, size_t n2, size_t d1, size_t d2,
+                                            size_t nip, bool diagonal, bool symmetric)
+    {
+      stringstream s;
+      s << "#include <fem.hpp>\n"
+           "using namespace ngfem;\n"
+           "extern \"C\" {\n"
+           "void ElementMatrixKernel (const SIMD<double> * __restrict b1,\n"
+           "                          const SIMD<double> * __restrict dmat,\n"
+           "                          const SIMD<double> * __restrict b2,\n"
+           "                          double * __restrict elmat, size_t dist)\n"
+           "{\n"
+           "  constexpr size_t N1 = " << n1 << ", N2 = " << n2 << ";\n"
+           "  constexpr size_t D1 = " << d1 << ", D2 = " << d2 << ", NIP = " << nip << ";\n"
+           "  for (size_t i = 0; i < N1; i++)\n"
+           "    {\n"
+           "      // D * B1 for trial dof i\n"
+           "      SIMD<double> db[D2*NIP];\n"
+           "      for (size_t l = 0; l < D2; l++)\n"
+           "        for (size_t ip = 0; ip < NIP; ip++)\n";
+      if (diagonal)
+        s << "          db[l*NIP+ip] = dmat[l*NIP+ip] * b1[(i*D1+l)*NIP+ip];\n";
+      else
+        s << "          {\n"
+             "            SIMD<double> sum(0.0);\n"
+             "            for (size_t k = 0; k < D1; k++)\n"
+             "              sum = FMA (dmat[(k*D2+l)*NIP+ip], b1[(i*D1+k)*NIP+ip], sum);\n"
+             "            db[l*NIP+ip] = sum;\n"
+             "          }\n";
+      s << "      for (size_t j = " << (symmetric ? "i" : "0") << "; j < N2; j++)\n"
+           "        {\n"
+           "          SIMD<double> sum(0.0);\n"
+           "          for (size_t l = 0; l < D2*NIP; l++)\n"
+           "            sum = FMA (b2[j*D2*NIP+l], db[l], sum);\n"
+           "          elmat[j*dist+i] += HSum(sum);\n"
+           "        }\n"
+           "    }\n"
+           "}\n"
+           "}\n";
+      return s.str();
+    }
+
     namespace detail {
         // T_CalcShape is protected, thus we have to derive
         template <ELEMENT_TYPE ET, typename BASE>
@@ -45,13 +45,15 @@ namespace ngfem
     int deriv;
     std::vector<string> link_flags;
 
-    string pointer;
+    /// passed to the compiled function as compiled_code_pointers,
+    /// addresses don't appear in the code, so it can be cached
+    std::vector<void*> pointers;
 
+    /// returns an expression for the pointer inside the compiled function
     string AddPointer(const void *p );
 
     void AddLinkFlag(string flag);
 
-    static atomic<unsigned> id_counter;
     static string Map( string code, std::map<string,string> variables ) {
       for ( auto mapping : variables ) {
         string oldStr = '{'+mapping.first+'}';
@@ -174,7 +176,30 @@ namespace ngfem
     }
   }
 
+  /// directory of compiled libraries, NGSOLVE_CACHE_DIR or the user cache directory
+  string GetCodeCacheDirectory();
+
+  /**
+     Compiles and links the codes to a shared library.
+     The library is stored in the cache directory under a hash of codes,
+     link flags, NGSolve version and compiler, and is loaded from there
+     if the same code is compiled again, also by other processes.
+   */
   unique_ptr<SharedLibrary> CompileCode(const std::vector<string> &codes, const std::vector<string> &libraries );
+
+  /**
+     Element matrix kernel of a symbolic bilinear form integrator with
+     all sizes fixed at compile time:
+
+       elmat(j,i) += sum_{ip,k,l} b2(j*d2+l,ip) dmat(k*d2+l,ip) b1(i*d1+k,ip)
+
+     for n1 trial and n2 test dofs, nip SIMD integration points.
+     A diagonal dmat is given by its d1 = d2 diagonal rows, with
+     symmetric only the lower triangle is computed.
+     The function is ElementMatrixKernel (b1, dmat, b2, elmat, dist).
+   */
+  string GenerateElementMatrixKernelCode (size_t n1, size_t n2, size_t d1, size_t d2,
+                                          size_t nip, bool diagonal, bool symmetric);
   namespace detail {
       string GenerateL2ElementCode(int order);
   }
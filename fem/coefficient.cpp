@@ -11,6 +11,7 @@
 #include <fem.hpp>
 #include <../ngstd/evalfunc.hpp>
 #include <algorithm>
+#include <unordered_map>
 
 namespace ngstd
 {
@@ -3586,15 +3587,15 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
   // ///////////////////////////// Compiled CF /////////////////////////
   class CompiledCoefficientFunction : public CoefficientFunction, public std::enable_shared_from_this<CompiledCoefficientFunction>
   {
-    typedef void (*lib_function)(const ngfem::BaseMappedIntegrationRule &, ngbla::BareSliceMatrix<double>);
-    typedef void (*lib_function_simd)(const ngfem::SIMD_BaseMappedIntegrationRule &, BareSliceMatrix<SIMD<double>>);
-    typedef void (*lib_function_deriv)(const ngfem::BaseMappedIntegrationRule &, ngbla::BareSliceMatrix<AutoDiff<1,double>>);
-    typedef void (*lib_function_simd_deriv)(const ngfem::SIMD_BaseMappedIntegrationRule &, BareSliceMatrix<AutoDiff<1,SIMD<double>>>);
-    typedef void (*lib_function_dderiv)(const ngfem::BaseMappedIntegrationRule &, ngbla::BareSliceMatrix<AutoDiffDiff<1,double>>);
-    typedef void (*lib_function_simd_dderiv)(const ngfem::SIMD_BaseMappedIntegrationRule &, BareSliceMatrix<AutoDiffDiff<1,SIMD<double>>>);
+    typedef void (*lib_function)(const ngfem::BaseMappedIntegrationRule &, ngbla::BareSliceMatrix<double>, void * const *);
+    typedef void (*lib_function_simd)(const ngfem::SIMD_BaseMappedIntegrationRule &, BareSliceMatrix<SIMD<double>>, void * const *);
+    typedef void (*lib_function_deriv)(const ngfem::BaseMappedIntegrationRule &, ngbla::BareSliceMatrix<AutoDiff<1,double>>, void * const *);
+    typedef void (*lib_function_simd_deriv)(const ngfem::SIMD_BaseMappedIntegrationRule &, BareSliceMatrix<AutoDiff<1,SIMD<double>>>, void * const *);
+    typedef void (*lib_function_dderiv)(const ngfem::BaseMappedIntegrationRule &, ngbla::BareSliceMatrix<AutoDiffDiff<1,double>>, void * const *);
+    typedef void (*lib_function_simd_dderiv)(const ngfem::SIMD_BaseMappedIntegrationRule &, BareSliceMatrix<AutoDiffDiff<1,SIMD<double>>>, void * const *);
 
-    typedef void (*lib_function_complex)(const ngfem::BaseMappedIntegrationRule &, ngbla::BareSliceMatrix<Complex>);
-    typedef void (*lib_function_simd_complex)(const ngfem::SIMD_BaseMappedIntegrationRule &, BareSliceMatrix<SIMD<Complex>>);
+    typedef void (*lib_function_complex)(const ngfem::BaseMappedIntegrationRule &, ngbla::BareSliceMatrix<Complex>, void * const *);
+    typedef void (*lib_function_simd_complex)(const ngfem::SIMD_BaseMappedIntegrationRule &, BareSliceMatrix<SIMD<Complex>>, void * const *);
 
     shared_ptr<CoefficientFunction> cf;
     Array<CoefficientFunction*> steps;
@@ -3605,6 +3606,8 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
     Array<bool> is_complex;
     // Array<Timer*> timers;
     unique_ptr<SharedLibrary> library;
+    /// addresses used by the compiled code
+    std::vector<void*> compiled_pointers;
     lib_function compiled_function = nullptr;
     lib_function_simd compiled_function_simd = nullptr;
     lib_function_deriv compiled_function_deriv = nullptr;
@@ -3615,15 +3618,21 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
     lib_function_complex compiled_function_complex = nullptr;
     lib_function_simd_complex compiled_function_simd_complex = nullptr;
 
+    /// constants computed by Optimize
+    Array<shared_ptr<CoefficientFunction>> folded_constants;
+    /// steps of the tree, and how many Optimize removed
+    size_t nsteps_tree = 0, nduplicates = 0, nfolded = 0, nsimplified = 0;
+
   public:
     CompiledCoefficientFunction (shared_ptr<CoefficientFunction> acf)
       : CoefficientFunction(acf->Dimension(), acf->IsComplex()), cf(acf) // , compiled_function(nullptr), compiled_function_simd(nullptr)
     {
       SetDimensions (cf->Dimensions());
+      std::unordered_map<CoefficientFunction*, int> steppos;
       cf -> TraverseTree
         ([&] (CoefficientFunction & stepcf)
          {
-           if (!steps.Contains(&stepcf))
+           if (steppos.emplace (&stepcf, steps.Size()).second)
              {
                steps.Append (&stepcf);
                // timers.Append (new Timer(string("CompiledCF")+typeid(stepcf).name()));
@@ -3645,26 +3654,199 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
       cf -> TraverseTree
         ([&] (CoefficientFunction & stepcf)
          {
-           int mypos = steps.Pos (&stepcf);
+           int mypos = steppos[&stepcf];
            if (!inputs[mypos].Size())
              {
                Array<shared_ptr<CoefficientFunction>> in = stepcf.InputCoefficientFunctions();
                max_inputsize = max2(in.Size(), max_inputsize);
                for (auto incf : in)
-                 inputs.Add (mypos, steps.Pos(incf.get()));
+                 inputs.Add (mypos, steppos[incf.get()]);
              }
          });
       cout << IM(3) << "inputs = " << endl << inputs << endl;
 
+      Optimize();
+    }
+
+    virtual string GetDescription () const override
+    {
+      return "compiled, " + ToString(steps.Size()) + " steps (" + ToString(nsteps_tree)
+        + " in tree, " + ToString(nduplicates) + " duplicates, " + ToString(nfolded)
+        + " constants folded, " + ToString(nsimplified) + " trivial operations removed)";
+    }
+
+  private:
+    static bool IsConstant (CoefficientFunction * cf, double & val)
+    {
+      auto ccf = dynamic_cast<ConstantCoefficientFunction*> (cf);
+      if (!ccf) return false;
+      val = ccf->EvaluateConst();
+      return true;
+    }
+
+    /// two steps are the same if they generate the same code from the same inputs
+    static string StepKey (CoefficientFunction * step, FlatArray<int> in, int index)
+    {
+      stringstream key;
+      key << typeid(*step).name() << (step->IsComplex() ? " complex" : " real");
+      for (int d : step->Dimensions()) key << " " << d;
+      key << " inputs";
+      for (int i : in) key << " " << i;
+      try
+        {
+          Code code;
+          code.is_simd = false;
+          code.deriv = 0;
+          step->GenerateCode (code, in, index);
+          key << "\n" << code.top << code.header << code.body;
+          for (auto p : code.pointers) key << " " << p;
+        }
+      catch (const std::exception & e)
+        {
+          // no code, only identical objects are the same
+          key << " " << step;
+        }
+      return key.str();
+    }
+
+    /**
+       Removes steps computing the same as an earlier step (common
+       subexpressions built separately), evaluates operations on
+       constants, and removes x+0, x-0, x*1 and x/1.  The last step is
+       kept, it writes the result.
+    */
+    void Optimize ()
+    {
+      static Timer t("CompiledCF::Optimize"); RegionTimer reg(t);
+      size_t n = steps.Size();
+      nsteps_tree = n;
+
+      // mapped integration point for evaluating constants
+      Matrix<> pmat(2,1);
+      pmat(0,0) = 0; pmat(1,0) = 1;
+      FE_ElementTransformation<1,1> trafo(ET_SEGM, pmat);
+      IntegrationPoint ip(0.5);
+      MappedIntegrationPoint<1,1> mip(ip, trafo);
+
+      Array<int> map(n);
+      Array<CoefficientFunction*> new_steps;
+      Array<int> new_dim;
+      Array<bool> new_complex;
+      Array<int> in_first(1), in_flat;
+      in_first[0] = 0;
+      std::unordered_map<string,int> known;
+
+      for (size_t i = 0; i < n; i++)
+        {
+          CoefficientFunction * step = steps[i];
+          Array<int> in;
+          for (int j : inputs[i])
+            in.Append (map[j]);
+          bool last = (i == n-1);
+
+          if (!last && !step->IsComplex())
+            {
+              int alias = -1;
+              double c0, c1;
+              if (in.Size() == 2)
+                {
+                  bool k0 = IsConstant (new_steps[in[0]], c0);
+                  bool k1 = IsConstant (new_steps[in[1]], c1);
+                  switch (step->GetType())
+                    {
+                    case CF_Type_add:
+                      if (k1 && c1 == 0) alias = in[0];
+                      else if (k0 && c0 == 0) alias = in[1];
+                      break;
+                    case CF_Type_sub:
+                      if (k1 && c1 == 0) alias = in[0];
+                      break;
+                    case CF_Type_mult:
+                      if (k1 && c1 == 1) alias = in[0];
+                      else if (k0 && c0 == 1) alias = in[1];
+                      break;
+                    case CF_Type_div:
+                      if (k1 && c1 == 1) alias = in[0];
+                      break;
+                    default:
+                      break;
+                    }
+                }
+              if (alias >= 0)
+                {
+                  map[i] = alias;
+                  nsimplified++;
+                  continue;
+                }
+
+              bool foldable = false;
+              switch (step->GetType())
+                {
+                case CF_Type_unary_op: case CF_Type_binary_op: case CF_Type_scale:
+                case CF_Type_add: case CF_Type_sub: case CF_Type_mult: case CF_Type_div:
+                  foldable = in.Size() > 0 && step->Dimension() == 1;
+                  break;
+                default:
+                  break;
+                }
+              for (int j : in)
+                if (!IsConstant (new_steps[j], c0))
+                  foldable = false;
+              if (foldable)
+                {
+                  auto cc = make_shared<ConstantCoefficientFunction> (step->Evaluate(mip));
+                  folded_constants.Append (cc);
+                  step = cc.get();
+                  in.SetSize0();
+                  nfolded++;
+                }
+            }
+
+          string key = StepKey (step, in, n);
+          auto pos = known.find (key);
+          if (!last && pos != known.end())
+            {
+              map[i] = pos->second;
+              nduplicates++;
+              continue;
+            }
+
+          map[i] = new_steps.Size();
+          known[key] = map[i];
+          new_steps.Append (step);
+          new_dim.Append (step->Dimension());
+          new_complex.Append (step->IsComplex());
+          in_flat.Append (in);
+          in_first.Append (in_flat.Size());
+        }
+
+      steps = std::move(new_steps);
+      dim = std::move(new_dim);
+      is_complex = std::move(new_complex);
+      inputs = DynamicTable<int> (steps.Size());
+      max_inputsize = 0;
+      for (size_t i = 0; i < steps.Size(); i++)
+        {
+          for (int j = in_first[i]; j < in_first[i+1]; j++)
+            inputs.Add (i, in_flat[j]);
+          max_inputsize = max2 (size_t(in_first[i+1]-in_first[i]), max_inputsize);
+        }
+      totdim = 0;
+      for (int d : dim) totdim += d;
+
+      cout << IM(3) << "Compiled CF: " << n << " steps, removed "
+           << nduplicates << " duplicates, " << nfolded << " constants folded, "
+           << nsimplified << " trivial operations" << endl;
     }
 
+  public:
     void RealCompile(int maxderiv, bool wait)
     {
         std::vector<string> link_flags;
         if(cf->IsComplex())
             maxderiv = 0;
         stringstream s;
-        string pointer_code;
+        std::vector<void*> pointers;
         string top_code = ""
              "#include<fem.hpp>\n"
              "using namespace ngfem;\n"
@@ -3679,12 +3861,14 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
             Code code;
             code.is_simd = simd;
             code.deriv = deriv;
+            // one table of pointers for all functions
+            code.pointers = std::move(pointers);
             for (auto i : Range(steps)) {
               cout << IM(3) << "step " << i << ": " << typeid(*steps[i]).name() << endl;
               steps[i]->GenerateCode(code, inputs[i],i);
             }
 
-            pointer_code += code.pointer;
+            pointers = std::move(code.pointers);
             top_code += code.top;
 
             // set results
@@ -3738,11 +3922,11 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
             // Function parameters
             if (simd)
               {
-                s << "(SIMD_BaseMappedIntegrationRule & mir, BareSliceMatrix<" << res_type << "> results";
+                s << "(SIMD_BaseMappedIntegrationRule & mir, BareSliceMatrix<" << res_type << "> results, void * const * compiled_code_pointers";
               }
             else
               {
-                s << "(BaseMappedIntegrationRule & mir, BareSliceMatrix<" << res_type << "> results";
+                s << "(BaseMappedIntegrationRule & mir, BareSliceMatrix<" << res_type << "> results, void * const * compiled_code_pointers";
                 /*
                 string param_type = simd ? "BareSliceMatrix<SIMD<"+scal_type+">> " : "FlatMatrix<"+scal_type+"> ";
                 if (simd && deriv == 0) param_type = "BareSliceMatrix<SIMD<"+scal_type+">> ";
@@ -3769,15 +3953,11 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
         string file_code = top_code + s.str();
         std::vector<string> codes;
         codes.push_back(file_code);
-        if(pointer_code.size()) {
-          pointer_code = "extern \"C\" {\n" + pointer_code;
-          pointer_code += "}\n";
-          codes.push_back(pointer_code);
-        }
 
         auto self = shared_from_this();
-        auto compile_func = [self, codes, link_flags, maxderiv] () {
+        auto compile_func = [self, codes, link_flags, maxderiv, pointers] () {
               self->library = CompileCode( codes, link_flags );
+              self->compiled_pointers = pointers;
               if(self->cf->IsComplex())
               {
                   self->compiled_function_simd_complex = self->library->GetFunction<lib_function_simd_complex>("CompiledEvaluateSIMD");
@@ -3920,7 +4100,7 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
     {
       if(compiled_function)
       {
-        compiled_function(ir,values);
+        compiled_function(ir, values, compiled_pointers.data());
         return;
       }
 
@@ -3972,7 +4152,7 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
     {
       if(compiled_function_deriv)
         {
-          compiled_function_deriv(ir, values);
+          compiled_function_deriv(ir, values, compiled_pointers.data());
           return;
         }
 
@@ -4011,7 +4191,7 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
     {
       if(compiled_function_dderiv)
       {
-        compiled_function_dderiv(ir, values);
+        compiled_function_dderiv(ir, values, compiled_pointers.data());
         return;
       }
 
@@ -4050,7 +4230,7 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
     {
       if(compiled_function_simd_deriv)
         {
-          compiled_function_simd_deriv(ir, values);
+          compiled_function_simd_deriv(ir, values, compiled_pointers.data());
           return;
         }
 
@@ -4091,7 +4271,7 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
     {
       if(compiled_function_simd_dderiv)
       {
-        compiled_function_simd_dderiv(ir, values);
+        compiled_function_simd_dderiv(ir, values, compiled_pointers.data());
         return;
       }
       
@@ -4131,7 +4311,7 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
     {
       if(compiled_function_simd)
       {
-        compiled_function_simd(ir, values);
+        compiled_function_simd(ir, values, compiled_pointers.data());
         return;
       }
 
@@ -4172,7 +4352,7 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
     {
       if(compiled_function_complex)
       {
-          compiled_function_complex(ir,values);
+          compiled_function_complex(ir, values, compiled_pointers.data());
           return;
       }
       else
@@ -4185,7 +4365,7 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
     {
       if(compiled_function_simd_complex)
       {
-        compiled_function_simd_complex(ir,values);
+        compiled_function_simd_complex(ir, values, compiled_pointers.data());
         return;
       }
       else
@@ -80,6 +80,7 @@ namespace ngfem
 #include "hcurl_equations.hpp"
 #include "hdiv_equations.hpp"
 #include "elasticity_equations.hpp"
+#include "sumfactorization.hpp"
 #include "symbolicintegrator.hpp"
 #include "tensorproductintegrator.hpp"
 // #include "pml.hpp" 
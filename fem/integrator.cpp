@@ -28,6 +28,13 @@ namespace ngfem
     name = "Integrator";
   }
 
+  void Integrator :: SetCacheElementMatrix (bool ac)
+  {
+    static atomic<size_t> version(0);
+    cache_elmat = ac;
+    cache_elmat_version = ++version;
+  }
+
   ///
   Integrator :: ~Integrator() 
   {
@@ -41,6 +41,10 @@ namespace ngfem
     /// plane element and constant coefficients 
     bool const_coef;
 
+    /// element matrices may be cached by the bilinear form
+    bool cache_elmat = false;
+    size_t cache_elmat_version = 0;
+
     ///
     string name;
 
@@ -191,6 +195,18 @@ namespace ngfem
     void SetConstantCoefficient (bool acc = 1)
     { const_coef = acc; }
 
+    /**
+       The element matrices don't change between assemblies, a bilinear
+       form with the flag cache_elmats keeps them. Every call gets a new
+       version, so calling it again after changing the coefficients
+       recomputes the cached matrices.
+     */
+    void SetCacheElementMatrix (bool ac = true);
+    /// element matrices may be cached
+    bool CacheElementMatrix () const { return cache_elmat; }
+    /// changes with every call of SetCacheElementMatrix
+    size_t CacheElementMatrixVersion () const { return cache_elmat_version; }
+
     /// dimension of element
     virtual int DimElement () const { return -1; }
 
@@ -433,6 +449,10 @@ namespace ngfem
     PrecomputeData (const FiniteElement & fel, 
 		    const ElementTransformation & eltrans, 
 		    LocalHeap & lh) const { return 0; }
+
+    /// frees data obtained from PrecomputeData
+    virtual void
+    DeletePrecomputedData (void * data) const { ; }
   
 
     virtual void 
@@ -1543,6 +1543,33 @@ void NGS_DLL_HEADER ExportNgfem(py::module &m) {
            self -> SetIntegrationRule(et,ir);
            return self;
          })
+    .def("SetCacheElementMatrix", [] (shared_ptr<BFI> self, bool cache)
+         {
+           self -> SetCacheElementMatrix(cache);
+           return self;
+         }, py::arg("cache")=true,
+         "The element matrices do not change between assemblies, they are cached if the bilinear form\n"
+         "is created with the flag 'cache_elmats'. Call it again after changing the coefficients.")
+    .def("Compile", [] (shared_ptr<BFI> self, bool compile)
+         {
+           auto sbfi = dynamic_pointer_cast<SymbolicBilinearFormIntegrator> (self);
+           if (!sbfi)
+             throw Exception ("Compile is only available for symbolic integrators");
+           sbfi -> SetCompileKernels(compile);
+           return self;
+         }, py::arg("compile")=true,
+         "Real element matrices are computed by kernels compiled for the number of dofs and integration points of the element. Needs a C++ compiler at runtime, like CoefficientFunction.Compile(realcompile=True).")
+    .def_property_readonly("kernel_calls", [] (shared_ptr<BFI> self)
+         {
+           auto sbfi = dynamic_pointer_cast<SymbolicBilinearFormIntegrator> (self);
+           if (!sbfi)
+             throw Exception ("kernel_calls is only available for symbolic integrators");
+           py::dict res;
+           res["compiled"] = sbfi->GetCompiledKernelCalls();
+           res["generic"] = sbfi->GetGenericKernelCalls();
+           return res;
+         },
+         "Number of element matrix contributions computed by compiled kernels and by the generic evaluation, counted after Compile()")
     .def("CalcElementMatrix",
          [] (shared_ptr<BFI> self,
              const FiniteElement & fe, const ElementTransformation &trafo,
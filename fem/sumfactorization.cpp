@@ -0,0 +1,275 @@
+/*********************************************************************/
+/* File:   sumfactorization.cpp                                      */
+/* Date:   Oct. 2026                                                 */
+/*********************************************************************/
+
+/*
+   Sum-factorized evaluation on tensor-product elements
+*/
+
+#include <fem.hpp>
+
+namespace ngfem
+{
+
+  unique_ptr<SumFactorizedElement>
+  SumFactorizedElement :: Create (const FiniteElement & fel, const IntegrationRule & ir1d,
+                                  LocalHeap & lh)
+  {
+    HeapReset hr(lh);
+
+    auto et = fel.ElementType();
+    if (et != ET_QUAD && et != ET_HEX) return nullptr;
+    auto sfel = dynamic_cast<const BaseScalarFiniteElement*> (&fel);
+    if (!sfel) return nullptr;
+
+    // derivatives of the 1D factors are exact if they are interpolated
+    int n = ir1d.Size();
+    if (n < fel.Order()+1) return nullptr;
+
+    unique_ptr<SumFactorizedElement> sfe(new SumFactorizedElement);
+    sfe->dim = (et == ET_QUAD) ? 2 : 3;
+    sfe->ndof = fel.GetNDof();
+    sfe->xi1d.SetSize (n);
+    sfe->w1d.SetSize (n);
+    for (int i = 0; i < n; i++)
+      {
+        sfe->xi1d[i] = ir1d[i](0);
+        sfe->w1d[i] = ir1d[i].Weight();
+      }
+    for (int d = 0; d < 3; d++)
+      sfe->nq[d] = (d < sfe->dim) ? n : 1;
+
+    int ndof = sfe->ndof;
+    int * nq = sfe->nq;
+    IntegrationRule & ir = sfe->GetIntegrationRule (lh);
+    FlatMatrix<> shape(ndof, ir.Size(), lh);
+    sfel->CalcShape (ir, shape);
+
+    auto index = [nq] (int i, int j, int k) { return (size_t(i)*nq[1]+j)*nq[2]+k; };
+
+    // differentiation matrix of the Lagrange interpolation in the 1D points
+    Matrix<> dmat(n,n);
+    Vector<> bw(n);
+    for (int j = 0; j < n; j++)
+      {
+        double prod = 1;
+        for (int k = 0; k < n; k++)
+          if (k != j) prod *= sfe->xi1d[j]-sfe->xi1d[k];
+        bw(j) = 1.0/prod;
+      }
+    for (int i = 0; i < n; i++)
+      {
+        double sum = 0;
+        for (int j = 0; j < n; j++)
+          if (i != j)
+            {
+              dmat(i,j) = bw(j)/bw(i) / (sfe->xi1d[i]-sfe->xi1d[j]);
+              sum += dmat(i,j);
+            }
+        dmat(i,i) = -sum;
+      }
+
+    // distinct 1D factors, nq[d] values each
+    Array<double> fac1d[3];
+    sfe->factors.SetSize (ndof);
+    sfe->scale.SetSize (ndof);
+
+    for (int dof = 0; dof < ndof; dof++)
+      {
+        auto row = shape.Row(dof);
+        size_t imax = 0;
+        for (size_t l = 0; l < row.Size(); l++)
+          if (fabs(row(l)) > fabs(row(imax))) imax = l;
+        double pivot = row(imax);
+        if (pivot == 0) return nullptr;
+
+        int piv[3] = { int(imax / (nq[1]*nq[2])), int(imax / nq[2] % nq[1]), int(imax % nq[2]) };
+
+        Vector<> f[3];
+        for (int d = 0; d < 3; d++)
+          {
+            f[d].SetSize (nq[d]);
+            for (int l = 0; l < nq[d]; l++)
+              {
+                int ijk[3] = { piv[0], piv[1], piv[2] };
+                ijk[d] = l;
+                f[d](l) = row(index(ijk[0], ijk[1], ijk[2]));
+              }
+          }
+        f[1] /= pivot;
+        f[2] /= pivot;
+
+        // a product of 1D functions ?
+        for (int i = 0; i < nq[0]; i++)
+          for (int j = 0; j < nq[1]; j++)
+            for (int k = 0; k < nq[2]; k++)
+              if (fabs (row(index(i,j,k)) - f[0](i)*f[1](j)*f[2](k)) > 1e-10 * fabs(pivot))
+                return nullptr;
+
+        // normalized factors, identical ones are stored once
+        double s = 1;
+        for (int d = 0; d < 3; d++)
+          {
+            int m = 0;
+            for (int l = 0; l < nq[d]; l++)
+              if (fabs(f[d](l)) > fabs(f[d](m)) + 1e-12) m = l;
+            double sd = f[d](m);
+            f[d] /= sd;
+            s *= sd;
+
+            int nf = fac1d[d].Size() / nq[d];
+            int nr = -1;
+            for (int l = 0; l < nf; l++)
+              if (L2Norm (FlatVector<> (nq[d], &fac1d[d][l*nq[d]]) - f[d]) < 1e-10 * sqrt(double(nq[d])))
+                { nr = l; break; }
+            if (nr == -1)
+              {
+                nr = nf;
+                for (int l = 0; l < nq[d]; l++)
+                  fac1d[d].Append (f[d](l));
+              }
+            sfe->factors[dof][d] = nr;
+          }
+        sfe->scale[dof] = s;
+      }
+
+    for (int d = 0; d < 3; d++)
+      {
+        int nf = fac1d[d].Size() / nq[d];
+        sfe->shape1d[d].SetSize (nq[d], nf);
+        for (int l = 0; l < nf; l++)
+          sfe->shape1d[d].Col(l) = FlatVector<> (nq[d], &fac1d[d][l*nq[d]]);
+        sfe->dshape1d[d].SetSize (nq[d], nf);
+        if (d < sfe->dim)
+          sfe->dshape1d[d] = dmat * sfe->shape1d[d];
+        else
+          sfe->dshape1d[d] = 0.0;
+      }
+    return sfe;
+  }
+
+
+  IntegrationRule & SumFactorizedElement :: GetIntegrationRule (LocalHeap & lh) const
+  {
+    IntegrationRule & ir = *new (lh) IntegrationRule (GetNIP(), lh);
+    ir.SetDim (dim);
+    size_t ii = 0;
+    for (int i = 0; i < nq[0]; i++)
+      for (int j = 0; j < nq[1]; j++)
+        for (int k = 0; k < nq[2]; k++, ii++)
+          {
+            if (dim == 2)
+              ir[ii] = IntegrationPoint (xi1d[i], xi1d[j], 0, w1d[i]*w1d[j]);
+            else
+              ir[ii] = IntegrationPoint (xi1d[i], xi1d[j], xi1d[k], w1d[i]*w1d[j]*w1d[k]);
+            ir[ii].SetNr (ii);
+          }
+    return ir;
+  }
+
+
+  /*
+    coefficients C[a][b][c] of products of 1D factors a,b,c
+    z-direction:  A[a][b][k]   = sum_c C[a][b][c] S2(k,c)
+    y-direction:  AA[a][j][k]  = sum_b S1(j,b) A[a][b][k]
+    x-direction:  V[i][j][k]   = sum_a S0(i,a) AA[a][j][k]
+    derivatives replace S by dS in one direction
+  */
+  void SumFactorizedElement :: Evaluate (FlatVector<> coefs, SliceMatrix<> values,
+                                         LocalHeap & lh) const
+  {
+    HeapReset hr(lh);
+    bool grad = values.Height() > 1;
+    int nf0 = shape1d[0].Width(), nf1 = shape1d[1].Width(), nf2 = shape1d[2].Width();
+
+    FlatMatrix<> c(nf0*nf1, nf2, lh);
+    c = 0.0;
+    for (int i = 0; i < ndof; i++)
+      c(factors[i][0]*nf1+factors[i][1], factors[i][2]) += scale[i] * coefs(i);
+
+    FlatMatrix<> a(nf0*nf1, nq[2], lh), az(nf0*nf1, nq[2], lh);
+    a = c * Trans(shape1d[2]);
+    if (grad && dim == 3)
+      az = c * Trans(dshape1d[2]);
+
+    size_t njk = size_t(nq[1])*nq[2];
+    FlatMatrix<> aa(nf0, njk, lh), aay(nf0, njk, lh), aaz(nf0, njk, lh);
+    for (int i = 0; i < nf0; i++)
+      {
+        FlatMatrix<> ai(nf1, nq[2], &a(i*nf1,0));
+        FlatMatrix<> aai(nq[1], nq[2], &aa(i,0));
+        aai = shape1d[1] * ai;
+        if (grad)
+          {
+            FlatMatrix<> aayi(nq[1], nq[2], &aay(i,0));
+            aayi = dshape1d[1] * ai;
+            if (dim == 3)
+              {
+                FlatMatrix<> azi(nf1, nq[2], &az(i*nf1,0));
+                FlatMatrix<> aazi(nq[1], nq[2], &aaz(i,0));
+                aazi = shape1d[1] * azi;
+              }
+          }
+      }
+
+    auto row = [&] (int r) { return FlatMatrix<> (nq[0], njk, &values(r,0)); };
+    row(0) = shape1d[0] * aa;
+    if (grad)
+      {
+        row(1) = dshape1d[0] * aa;
+        row(2) = shape1d[0] * aay;
+        if (dim == 3)
+          row(3) = shape1d[0] * aaz;
+      }
+  }
+
+
+  void SumFactorizedElement :: AddTrans (SliceMatrix<> values, FlatVector<> coefs,
+                                         LocalHeap & lh) const
+  {
+    HeapReset hr(lh);
+    bool grad = values.Height() > 1;
+    int nf0 = shape1d[0].Width(), nf1 = shape1d[1].Width(), nf2 = shape1d[2].Width();
+    size_t njk = size_t(nq[1])*nq[2];
+
+    auto row = [&] (int r) { return FlatMatrix<> (nq[0], njk, &values(r,0)); };
+    FlatMatrix<> aa(nf0, njk, lh), aay(nf0, njk, lh), aaz(nf0, njk, lh);
+    aa = Trans(shape1d[0]) * row(0);
+    if (grad)
+      {
+        aa += Trans(dshape1d[0]) * row(1);
+        aay = Trans(shape1d[0]) * row(2);
+        if (dim == 3)
+          aaz = Trans(shape1d[0]) * row(3);
+      }
+
+    FlatMatrix<> a(nf0*nf1, nq[2], lh), az(nf0*nf1, nq[2], lh);
+    for (int i = 0; i < nf0; i++)
+      {
+        FlatMatrix<> ai(nf1, nq[2], &a(i*nf1,0));
+        FlatMatrix<> aai(nq[1], nq[2], &aa(i,0));
+        ai = Trans(shape1d[1]) * aai;
+        if (grad)
+          {
+            FlatMatrix<> aayi(nq[1], nq[2], &aay(i,0));
+            ai += Trans(dshape1d[1]) * aayi;
+            if (dim == 3)
+              {
+                FlatMatrix<> azi(nf1, nq[2], &az(i*nf1,0));
+                FlatMatrix<> aazi(nq[1], nq[2], &aaz(i,0));
+                azi = Trans(shape1d[1]) * aazi;
+              }
+          }
+      }
+
+    FlatMatrix<> c(nf0*nf1, nf2, lh);
+    c = a * shape1d[2];
+    if (grad && dim == 3)
+      c += az * dshape1d[2];
+
+    for (int i = 0; i < ndof; i++)
+      coefs(i) += scale[i] * c(factors[i][0]*nf1+factors[i][1], factors[i][2]);
+  }
+
+}
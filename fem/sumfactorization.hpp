@@ -0,0 +1,60 @@
+#ifndef FILE_SUMFACTORIZATION
+#define FILE_SUMFACTORIZATION
+
+/*********************************************************************/
+/* File:   sumfactorization.hpp                                      */
+/* Date:   Oct. 2026                                                 */
+/*********************************************************************/
+
+namespace ngfem
+{
+
+  /**
+     Sum-factorized evaluation of scalar elements on quads and hexes.
+
+     The shape functions of H1HighOrderFE<ET_QUAD/ET_HEX> are products
+     of 1D functions.  The factors are found numerically by rank-one
+     separation of the shape functions on a tensor-product Gauss rule.
+     Values and reference gradients at all n^D points are then computed
+     direction by direction in O(p^{D+1}) operations, instead of
+     O(p^{2D}) for the full shape matrix.
+
+     Integration points are ordered x slowest, last coordinate fastest.
+  */
+  class NGS_DLL_HEADER SumFactorizedElement
+  {
+    int dim;
+    int ndof;
+    /// 1D Gauss rule
+    Array<double> xi1d, w1d;
+    /// points per direction, z is a dummy direction of size 1 for quads
+    int nq[3];
+    /// 1D factors (row = point, col = factor), and their derivatives
+    Matrix<> shape1d[3], dshape1d[3];
+    /// 1D factors and scaling of every dof
+    Array<INT<3>> factors;
+    Array<double> scale;
+
+    SumFactorizedElement () { ; }
+  public:
+    /// returns nullptr if the element is not of tensor-product type
+    static unique_ptr<SumFactorizedElement> Create (const FiniteElement & fel,
+                                                   const IntegrationRule & ir1d,
+                                                   LocalHeap & lh);
+
+    int Dim() const { return dim; }
+    int GetNDof() const { return ndof; }
+    size_t GetNIP() const { return size_t(nq[0])*nq[1]*nq[2]; }
+
+    /// tensor-product integration rule
+    IntegrationRule & GetIntegrationRule (LocalHeap & lh) const;
+
+    /// row 0: values, rows 1..D: reference gradient; only values if Height() == 1
+    void Evaluate (FlatVector<> coefs, SliceMatrix<> values, LocalHeap & lh) const;
+    /// transpose of Evaluate
+    void AddTrans (SliceMatrix<> values, FlatVector<> coefs, LocalHeap & lh) const;
+  };
+
+}
+
+#endif
@@ -8,6 +8,7 @@
 */
 
 #include <fem.hpp>
+#include <future>
 
 namespace ngfem
 {
@@ -1079,6 +1080,89 @@ namespace ngfem
   {
     ExtendSymmetric (elmat);
   }
+
+
+  typedef void (*lib_elmat_kernel) (const SIMD<double> *, const SIMD<double> *,
+                                    const SIMD<double> *, double *, size_t);
+
+  // compiled kernels are shared by all integrators, nullptr if compilation failed
+  static lib_elmat_kernel GetElementMatrixKernel (size_t n1, size_t n2, size_t d1, size_t d2,
+                                                  size_t nip, bool diagonal, bool symmetric)
+  {
+    static mutex kernels_mutex;
+    static std::map<string, shared_future<lib_elmat_kernel>> kernels;
+    static std::vector<unique_ptr<SharedLibrary>> libraries;
+
+    stringstream key;
+    key << n1 << " " << n2 << " " << d1 << " " << d2 << " " << nip
+        << " " << diagonal << " " << symmetric;
+
+    // the first thread asking for a kernel compiles it, outside of the lock;
+    // threads asking for the same kernel wait for it, all others continue
+    promise<lib_elmat_kernel> compiled;
+    shared_future<lib_elmat_kernel> other;
+    {
+      lock_guard<mutex> guard(kernels_mutex);
+      auto pos = kernels.find (key.str());
+      if (pos != kernels.end())
+        other = pos->second;
+      else
+        kernels[key.str()] = compiled.get_future().share();
+    }
+    if (other.valid())
+      return other.get();
+
+    lib_elmat_kernel kernel = nullptr;
+    unique_ptr<SharedLibrary> library;
+    try
+      {
+        cout << IM(3) << "compile element matrix kernel " << key.str() << endl;
+        std::vector<string> codes
+          { GenerateElementMatrixKernelCode (n1, n2, d1, d2, nip, diagonal, symmetric) };
+        library = CompileCode (codes, std::vector<string>());
+        kernel = library->GetFunction<lib_elmat_kernel> ("ElementMatrixKernel");
+      }
+    catch (const std::exception & e)
+      {
+        cerr << IM(3) << "compiling element matrix kernel failed: " << e.what() << endl
+             << "using generic evaluation" << endl;
+      }
+
+    {
+      lock_guard<mutex> guard(kernels_mutex);
+      if (library)
+        libraries.push_back (move(library));
+    }
+    compiled.set_value (kernel);
+    return kernel;
+  }
+
+  /*
+    Fused D*B1 and B2^T*(D*B1) by a compiled kernel, false if not available.
+    Kernels exist for real shapes, coefficients and element matrices,
+    all other combinations use the generic evaluation.
+  */
+  template <typename TB1, typename TD, typename TB2, typename TELMAT>
+  bool CompiledElementMatrixAdd (TB1 bbmat1, TD dvalues, TB2 bbmat2,
+                                 IntRange r1, IntRange r2, size_t d1, size_t d2,
+                                 bool diagonal, bool symmetric, TELMAT part_elmat)
+  {
+    return false;
+  }
+
+  bool CompiledElementMatrixAdd (FlatMatrix<SIMD<double>> bbmat1, FlatMatrix<SIMD<double>> dvalues,
+                                 FlatMatrix<SIMD<double>> bbmat2,
+                                 IntRange r1, IntRange r2, size_t d1, size_t d2,
+                                 bool diagonal, bool symmetric, SliceMatrix<double> part_elmat)
+  {
+    if (r1.Size() == 0 || r2.Size() == 0) return true;
+    auto kernel = GetElementMatrixKernel (r1.Size(), r2.Size(), d1, d2, dvalues.Width(),
+                                          diagonal, symmetric);
+    if (!kernel) return false;
+    kernel (&bbmat1(r1.First()*d1, 0), &dvalues(0,0), &bbmat2(r2.First()*d2, 0),
+            &part_elmat(0,0), part_elmat.Dist());
+    return true;
+  }
   
 
   /*
@@ -1105,6 +1189,7 @@ namespace ngfem
 
     if (element_vb != VOL)
       {
+        if (compile_kernels) generic_kernel_calls++;
         T_CalcElementMatrixEBAdd<SCAL, SCAL_SHAPES, SCAL_RES> (fel, trafo, elmat, lh);
         return;
       }
@@ -1219,74 +1304,84 @@ namespace ngfem
                           proxy2->Evaluator()->CalcMatrix(fel_test, mir, bbmat2);
                       }
 
-                      if (is_diagonal)
+                      symmetric_so_far &= samediffop && is_diagonal;
+                      bool compiled = compile_kernels &&
+                        CompiledElementMatrixAdd (bbmat1, is_diagonal ? diagproxyvalues : proxyvalues, bbmat2,
+                                                  r1, r2, dim_proxy1, dim_proxy2, is_diagonal,
+                                                  symmetric_so_far, part_elmat);
+                      if (compile_kernels)
+                        (compiled ? compiled_kernel_calls : generic_kernel_calls)++;
+
+                      if (!compiled)
                         {
-                          // NgProfiler::StartThreadTimer (timer_SymbBFIbd, TaskManager::GetThreadId());                      
+                          if (is_diagonal)
+                            {
+                              // NgProfiler::StartThreadTimer (timer_SymbBFIbd, TaskManager::GetThreadId());                      
                           
-                          /*
-                          size_t ii = r1.First()*dim_proxy1;
-                          for (size_t i : r1)
-                            for (size_t j = 0; j < dim_proxy1; j++, ii++)
-                              bdbmat1.Row(ii) = pw_mult(bbmat1.Row(ii), diagproxyvalues.Row(j));
-                          */
+                              /*
+                              size_t ii = r1.First()*dim_proxy1;
+                              for (size_t i : r1)
+                                for (size_t j = 0; j < dim_proxy1; j++, ii++)
+                                  bdbmat1.Row(ii) = pw_mult(bbmat1.Row(ii), diagproxyvalues.Row(j));
+                              */
                           
-                          // size_t sr1 = r1.Size();
-                          for (size_t j = 0; j < dim_proxy1; j++)
-                            {
-                              auto hbbmat1 = bbmat1.RowSlice(j,dim_proxy1).Rows(r1);
-                              auto hbdbmat1 = bdbmat1.RowSlice(j,dim_proxy1).Rows(r1);
-                              
-                              for (size_t k = 0; k < bdbmat1.Width(); k++)
-                                hbdbmat1.Col(k).AddSize(r1.Size()) = diagproxyvalues(j,k) * hbbmat1.Col(k);
-                            }
-                        }
-                      else
-                        {
-                          bdbmat1 = 0.0; 
-                          for (auto i : r1)
-                            for (size_t j = 0; j < dim_proxy2; j++)
-                              for (size_t k = 0; k < dim_proxy1; k++)
+                              // size_t sr1 = r1.Size();
+                              for (size_t j = 0; j < dim_proxy1; j++)
                                 {
-                                  auto res = bdbmat1.Row(i*dim_proxy2+j);
-                                  auto a = bbmat1.Row(i*dim_proxy1+k);
-                                  auto b = proxyvalues.Row(k*dim_proxy2+j);
-                                  res += pw_mult(a,b);
+                                  auto hbbmat1 = bbmat1.RowSlice(j,dim_proxy1).Rows(r1);
+                                  auto hbdbmat1 = bdbmat1.RowSlice(j,dim_proxy1).Rows(r1);
+                              
+                                  for (size_t k = 0; k < bdbmat1.Width(); k++)
+                                    hbdbmat1.Col(k).AddSize(r1.Size()) = diagproxyvalues(j,k) * hbbmat1.Col(k);
                                 }
-                        }
-
-                      // elmat.Rows(r2).Cols(r1) += bbmat2.Rows(r2) * Trans(bdbmat1.Rows(r1));
-                      // AddABt (bbmat2.Rows(r2), bdbmat1.Rows(r1), elmat.Rows(r2).Cols(r1));
+                            }
+                          else
+                            {
+                              bdbmat1 = 0.0; 
+                              for (auto i : r1)
+                                for (size_t j = 0; j < dim_proxy2; j++)
+                                  for (size_t k = 0; k < dim_proxy1; k++)
+                                    {
+                                      auto res = bdbmat1.Row(i*dim_proxy2+j);
+                                      auto a = bbmat1.Row(i*dim_proxy1+k);
+                                      auto b = proxyvalues.Row(k*dim_proxy2+j);
+                                      res += pw_mult(a,b);
+                                    }
+                            }
 
-                      symmetric_so_far &= samediffop && is_diagonal;
-                      /*
-                      if (symmetric_so_far)
-                        AddABtSym (AFlatMatrix<double>(hbbmat2.Rows(r2)),
-                                   AFlatMatrix<double> (hbdbmat1.Rows(r1)), part_elmat);
-                      else
-                        AddABt (AFlatMatrix<double> (hbbmat2.Rows(r2)),
-                                AFlatMatrix<double> (hbdbmat1.Rows(r1)), part_elmat);
-                      */
+                          // elmat.Rows(r2).Cols(r1) += bbmat2.Rows(r2) * Trans(bdbmat1.Rows(r1));
+                          // AddABt (bbmat2.Rows(r2), bdbmat1.Rows(r1), elmat.Rows(r2).Cols(r1));
 
-                      {
-                      if (symmetric_so_far)
-                        {
-                          /*
-                            ThreadRegionTimer regdmult(timer_SymbBFImultsym, TaskManager::GetThreadId());
-                            NgProfiler::AddThreadFlops(timer_SymbBFImultsym, TaskManager::GetThreadId(),
-                            SIMD<double>::Size()*2*r2.Size()*(r1.Size()+1)*hbbmat2.Width() / 2);
-                          */
-                          AddABtSym (hbbmat2.Rows(r2), hbdbmat1.Rows(r1), part_elmat);
-                        }
-                      else
-                        {
                           /*
-                          ThreadRegionTimer regdmult(timer_SymbBFImult, TaskManager::GetThreadId());
-                          NgProfiler::AddThreadFlops(timer_SymbBFImult, TaskManager::GetThreadId(),
-                                                     SIMD<double>::Size()*2*r2.Size()*r1.Size()*hbbmat2.Width());
+                          if (symmetric_so_far)
+                            AddABtSym (AFlatMatrix<double>(hbbmat2.Rows(r2)),
+                                       AFlatMatrix<double> (hbdbmat1.Rows(r1)), part_elmat);
+                          else
+                            AddABt (AFlatMatrix<double> (hbbmat2.Rows(r2)),
+                                    AFlatMatrix<double> (hbdbmat1.Rows(r1)), part_elmat);
                           */
-                          AddABt (hbbmat2.Rows(r2), hbdbmat1.Rows(r1), part_elmat);
+
+                          {
+                          if (symmetric_so_far)
+                            {
+                              /*
+                                ThreadRegionTimer regdmult(timer_SymbBFImultsym, TaskManager::GetThreadId());
+                                NgProfiler::AddThreadFlops(timer_SymbBFImultsym, TaskManager::GetThreadId(),
+                                SIMD<double>::Size()*2*r2.Size()*(r1.Size()+1)*hbbmat2.Width() / 2);
+                              */
+                              AddABtSym (hbbmat2.Rows(r2), hbdbmat1.Rows(r1), part_elmat);
+                            }
+                          else
+                            {
+                              /*
+                              ThreadRegionTimer regdmult(timer_SymbBFImult, TaskManager::GetThreadId());
+                              NgProfiler::AddThreadFlops(timer_SymbBFImult, TaskManager::GetThreadId(),
+                                                         SIMD<double>::Size()*2*r2.Size()*r1.Size()*hbbmat2.Width());
+                              */
+                              AddABt (hbbmat2.Rows(r2), hbdbmat1.Rows(r1), part_elmat);
+                            }
+                          }
                         }
-                      }
                       if (symmetric_so_far)
                         {
                           ExtendSymmetric (part_elmat);
@@ -1320,6 +1415,8 @@ namespace ngfem
         }
     
 
+    if (compile_kernels) generic_kernel_calls++;
+
     // IntegrationRule ir(trafo.GetElementType(), intorder);
     const IntegrationRule& ir = GetIntegrationRule (fel, lh);
     BaseMappedIntegrationRule & mir = trafo(ir, lh);
@@ -2344,6 +2441,24 @@ namespace ngfem
         return;
       }
 
+    if (precomputed && simd_evaluate)
+      try
+        {
+          auto & sfe = *static_cast<const SumFactorizedElement*> (precomputed);
+          if (sfe.Dim() == 2)
+            T_ApplySumFactorized<2> (sfe, fel, trafo, elx, ely, lh);
+          else
+            T_ApplySumFactorized<3> (sfe, fel, trafo, elx, ely, lh);
+          return;
+        }
+      catch (ExceptionNOSIMD e)
+        {
+          cout << IM(4) << e.What() << endl
+               << "switching to scalar evaluation" << endl;
+          simd_evaluate = false;
+          ApplyElementMatrix (fel, trafo, elx, ely, precomputed, lh);
+          return;
+        }
 
     if (simd_evaluate)
       try
@@ -2481,6 +2596,170 @@ namespace ngfem
  
   
   
+  void * SymbolicBilinearFormIntegrator ::
+  PrecomputeData (const FiniteElement & fel, 
+                  const ElementTransformation & trafo, 
+                  LocalHeap & lh) const
+  {
+    if (element_vb != VOL || !simd_evaluate) return nullptr;
+    
+    auto et = fel.ElementType();
+    if (et != ET_QUAD && et != ET_HEX) return nullptr;
+    int dim = ElementTopology::GetSpaceDim(et);
+    if (trafo.SpaceDim() != dim) return nullptr;
+    if (userdefined_intrules[et] || userdefined_simd_intrules[et]) return nullptr;
+    if (typeid(fel) == typeid(const MixedFiniteElement&)) return nullptr;
+
+    // values and gradients of scalar spaces only
+    for (auto proxies : { &trial_proxies, &test_proxies })
+      for (auto proxy : *proxies)
+        {
+          auto diffop = proxy->Evaluator();
+          if (diffop->BlockDim() != 1) return nullptr;
+          string name = diffop->Name();
+          bool is_id = name == "Id" && proxy->Dimension() == 1;
+          bool is_grad = name == "grad" && proxy->Dimension() == dim;
+          if (!is_id && !is_grad) return nullptr;
+        }
+
+    auto sfel = dynamic_cast<const BaseScalarFiniteElement*> (&fel);
+    if (!sfel) return nullptr;
+
+    // the factors depend only on the element type, the order and the vertex
+    // orientation, i.e. on the shape functions, which are compared in a generic point
+    HeapReset hr(lh);
+    IntegrationPoint ip(0.1273, 0.3419, 0.2281);
+    FlatVector<> fingerprint(fel.GetNDof(), lh);
+    sfel->CalcShape (ip, fingerprint);
+
+    auto find = [&] () -> SumFactorizationClass*
+      {
+        for (auto & cls : sumfact_classes)
+          if (cls.et == et && cls.order == fel.Order() &&
+              cls.fingerprint.Size() == fingerprint.Size() &&
+              L2Norm (cls.fingerprint - fingerprint) <= 1e-12 * (1+L2Norm (fingerprint)))
+            return &cls;
+        return nullptr;
+      };
+    {
+      lock_guard<mutex> guard(sumfact_mutex);
+      if (auto cls = find())
+        return cls->sfe.get();
+    }
+
+    // same order as Get_SIMD_IntegrationRule
+    const IntegrationRule & ir1d = SelectIntegrationRule (ET_SEGM, 2*fel.Order()+bonus_intorder);
+    shared_ptr<SumFactorizedElement> sfe = SumFactorizedElement::Create (fel, ir1d, lh);
+
+    // another thread may have created the class meanwhile
+    lock_guard<mutex> guard(sumfact_mutex);
+    if (auto cls = find())
+      return cls->sfe.get();
+    sumfact_classes.Append (SumFactorizationClass { et, fel.Order(), fingerprint, sfe });
+    return sfe.get();
+  }
+
+
+  template <int D>
+  void SymbolicBilinearFormIntegrator ::
+  T_ApplySumFactorized (const SumFactorizedElement & sfe,
+                        const FiniteElement & fel, 
+                        const ElementTransformation & trafo, 
+                        const FlatVector<double> elx, 
+                        FlatVector<double> ely,
+                        LocalHeap & lh) const
+  {
+    static Timer t("symbolicbfi - Apply sum-factorized", 2);
+    size_t tid = TaskManager::GetThreadId();    
+    ThreadRegionTimer reg(t, tid);
+    
+    HeapReset hr(lh);
+    constexpr size_t W = SIMD<double>::Size();
+
+    IntegrationRule & ir = sfe.GetIntegrationRule (lh);
+    SIMD_IntegrationRule & simd_ir = *new (lh) SIMD_IntegrationRule (ir, lh);
+    auto & simd_mir = static_cast<SIMD_MappedIntegrationRule<D,D>&> (trafo(simd_ir, lh));
+    size_t nip = ir.Size();
+    size_t nsimd = simd_ir.Size();
+
+    // values and reference gradients, the padding lanes are zero
+    bool trial_grad = false, test_grad = false;
+    for (auto proxy : trial_proxies)
+      if (proxy->Dimension() > 1) trial_grad = true;
+    for (auto proxy : test_proxies)
+      if (proxy->Dimension() > 1) test_grad = true;
+    
+    FlatMatrix<SIMD<double>> refvals(D+1, nsimd, lh);
+    refvals = SIMD<double>(0.0);
+    SliceMatrix<> hrefvals(D+1, nip, nsimd*W, &refvals(0,0)[0]);
+    sfe.Evaluate (elx, hrefvals.Rows(0, trial_grad ? D+1 : 1), lh);
+
+    ProxyUserData ud(trial_proxies.Size(), gridfunction_cfs.Size(), lh);
+    const_cast<ElementTransformation&>(trafo).userdata = &ud;
+    ud.fel = &fel;
+    for (ProxyFunction * proxy : trial_proxies)
+      ud.AssignMemory (proxy, simd_ir.GetNIP(), proxy->Dimension(), lh);
+    for (CoefficientFunction * cf : gridfunction_cfs)
+      ud.AssignMemory (cf, simd_ir.GetNIP(), cf->Dimension(), lh);
+
+    // physical gradient is J^{-T} times reference gradient
+    for (ProxyFunction * proxy : trial_proxies)
+      {
+        auto mem = ud.GetAMemory (proxy);
+        if (proxy->Dimension() == 1)
+          mem.Row(0) = refvals.Row(0);
+        else
+          for (size_t i = 0; i < nsimd; i++)
+            {
+              auto ijac = simd_mir[i].GetJacobianInverse();
+              for (int k = 0; k < D; k++)
+                {
+                  SIMD<double> sum(0.0);
+                  for (int j = 0; j < D; j++)
+                    sum += ijac(j,k) * refvals(j+1,i);
+                  mem(k,i) = sum;
+                }
+            }
+      }
+
+    FlatMatrix<SIMD<double>> reftrans(D+1, nsimd, lh);
+    reftrans = SIMD<double>(0.0);
+    for (auto proxy : test_proxies)
+      {
+        HeapReset hr(lh);
+        FlatMatrix<SIMD<double>> simd_proxyvalues(proxy->Dimension(), nsimd, lh);
+        for (int k = 0; k < proxy->Dimension(); k++)
+          {
+            ud.testfunction = proxy;
+            ud.test_comp = k;
+            cf -> Evaluate (simd_mir, simd_proxyvalues.Rows(k,k+1));
+          }
+
+        for (size_t i = 0; i < nsimd; i++)
+          {
+            SIMD<double> weight = simd_mir[i].GetWeight();
+            if (proxy->Dimension() == 1)
+              reftrans(0,i) += weight * simd_proxyvalues(0,i);
+            else
+              {
+                auto ijac = simd_mir[i].GetJacobianInverse();
+                for (int j = 0; j < D; j++)
+                  {
+                    SIMD<double> sum(0.0);
+                    for (int k = 0; k < D; k++)
+                      sum += ijac(j,k) * simd_proxyvalues(k,i);
+                    reftrans(j+1,i) += weight * sum;
+                  }
+              }
+          }
+      }
+
+    ely = 0.0;
+    SliceMatrix<> hreftrans(D+1, nip, nsimd*W, &reftrans(0,0)[0]);
+    sfe.AddTrans (hreftrans.Rows(0, test_grad ? D+1 : 1), ely, lh);
+  }
+
+  
   template <typename SCAL, typename SCAL_SHAPES>
   void SymbolicBilinearFormIntegrator ::
   T_ApplyElementMatrixEB (const FiniteElement & fel, 
@@ -588,10 +588,31 @@ public:
 
     int trial_difforder, test_difforder;
     bool is_symmetric;
+    bool compile_kernels = false;
+    /// proxy-pair contractions by compiled kernels and by the generic code, if compile_kernels
+    mutable atomic<size_t> compiled_kernel_calls{0}, generic_kernel_calls{0};
+
+    /// one SumFactorizedElement per element class (type, order, vertex orientation),
+    /// identified by the shape functions in a generic point
+    struct SumFactorizationClass
+    {
+      ELEMENT_TYPE et;
+      int order;
+      Vector<> fingerprint;
+      shared_ptr<SumFactorizedElement> sfe;   // nullptr if not of tensor-product type
+    };
+    mutable Array<SumFactorizationClass> sumfact_classes;
+    mutable mutex sumfact_mutex;
   public:
     NGS_DLL_HEADER SymbolicBilinearFormIntegrator (shared_ptr<CoefficientFunction> acf, VorB avb,
                                                    VorB aelement_boundary);
 
+    /// real element matrices by compiled kernels of fixed size (see GenerateElementMatrixKernelCode)
+    void SetCompileKernels (bool b = true) { compile_kernels = b; }
+    bool CompileKernels () const { return compile_kernels; }
+    size_t GetCompiledKernelCalls () const { return compiled_kernel_calls; }
+    size_t GetGenericKernelCalls () const { return generic_kernel_calls; }
+
     virtual VorB VB() const override { return vb; }
     virtual xbool IsSymmetric() const override { return is_symmetric ? xbool(true) : xbool(maybe); } 
     virtual string Name () const override { return string ("Symbolic BFI"); }
@@ -671,7 +692,20 @@ public:
                                  void * precomputed,
                                  LocalHeap & lh) const;
 
-
+    /// SumFactorizedElement for quads/hexes if all proxies are Id or grad, else nullptr
+    /// the data is owned by the integrator and shared by elements with the same shape functions
+    virtual void *
+    PrecomputeData (const FiniteElement & fel, 
+		    const ElementTransformation & trafo, 
+		    LocalHeap & lh) const override;
+
+    template <int D>
+    void T_ApplySumFactorized (const SumFactorizedElement & sfe,
+                               const FiniteElement & fel, 
+                               const ElementTransformation & trafo, 
+                               const FlatVector<double> elx, 
+                               FlatVector<double> ely,
+                               LocalHeap & lh) const;
   };
 
 
@@ -36,9 +36,16 @@ namespace ngla
 
 
     Matrix<SCAL> matH(m);
-    Array<shared_ptr<BaseVector>> abv(m);
-    for (int i = 0; i < m; i++)
-      abv[i] = a.CreateVector();
+
+    // real sequential vectors: Krylov basis in one block, block Gram-Schmidt
+    bool block = is_same<SCAL,double>::value &&
+      hv.GetParallelStatus() == NOT_PARALLEL && hv.EntrySize() == 1;
+    MultiVector basis(block ? n : 0, block ? m : 0);
+    MultiVector w(block ? n : 0, 1);
+
+    Array<shared_ptr<BaseVector>> abv(block ? 0 : m);
+    for (auto & v : abv)
+      v = a.CreateVector();
 
     auto mat_shift = a.CreateMatrix();
     mat_shift->AsVector() = a.AsVector() - shift*b.AsVector();  
@@ -75,35 +82,52 @@ namespace ngla
 	for (int j = 0; j < n; j++)
 	  matV(i,j) = hv.FV<SCAL>()(j);
 	*/
-	*abv[i] = *hv;
+	if (block)
+	  basis[i] = hv.template FV<double>();
+	else
+	  *abv[i] = *hv;
 
 	*hva = b * *hv;
 	*hvm = *inv * *hva;
 
-	for (int j = 0; j <= i; j++)
+	if (block)
 	  {
-            /*
-            SCAL sum = 0.0;
-	    for (int k = 0; k < n; k++)
-	      sum += hvm.FV<SCAL>()(k) * matV(j,k);
-	    matH(j,i) = sum;
-	    for (int k = 0; k < n; k++)
-	      hvm.FV<SCAL>()(k) -= sum * matV(j,k);
-            */
-            /*
-            SCAL sum = 0.0;
-            FlatVector<SCAL> abvj = abv[j] -> FV<SCAL>();
-            FlatVector<SCAL> fv_hvm = hvm.FV<SCAL>();
-	    for (int k = 0; k < n; k++)
-	      sum += fv_hvm(k) * abvj(k);
-	    matH(j,i) = sum;
-	    for (int k = 0; k < n; k++)
-	      fv_hvm(k) -= sum * abvj(k);
-            */
-
-	    matH(j,i) = S_InnerProduct<SCAL> (*hvm, *abv[j]);
-	    *hvm -= matH(j,i) * *abv[j];
+	    // classical Gram-Schmidt, applied twice
+	    auto prev = basis.Range (IntRange(0, i+1));
+	    w[0] = hvm.template FV<double>();
+	    Matrix<double> h = prev.InnerProduct (w);
+	    w.Add (-1, prev, h);
+	    Matrix<double> h2 = prev.InnerProduct (w);
+	    w.Add (-1, prev, h2);
+	    for (int j = 0; j <= i; j++)
+	      matH(j,i) = h(j,0) + h2(j,0);
+	    hvm.template FV<double>() = w[0];
 	  }
+	else
+          for (int j = 0; j <= i; j++)
+            {
+              /*
+              SCAL sum = 0.0;
+              for (int k = 0; k < n; k++)
+                sum += hvm.FV<SCAL>()(k) * matV(j,k);
+              matH(j,i) = sum;
+              for (int k = 0; k < n; k++)
+                hvm.FV<SCAL>()(k) -= sum * matV(j,k);
+              */
+              /*
+              SCAL sum = 0.0;
+              FlatVector<SCAL> abvj = abv[j] -> FV<SCAL>();
+              FlatVector<SCAL> fv_hvm = hvm.FV<SCAL>();
+              for (int k = 0; k < n; k++)
+                sum += fv_hvm(k) * abvj(k);
+              matH(j,i) = sum;
+              for (int k = 0; k < n; k++)
+                fv_hvm(k) -= sum * abvj(k);
+              */
+
+              matH(j,i) = S_InnerProduct<SCAL> (*hvm, *abv[j]);
+              *hvm -= matH(j,i) * *abv[j];
+            }
 		
 	*hv = *hvm;
 	*hv2 = *hv;
@@ -152,8 +176,15 @@ namespace ngla
               hevecs[i] =  make_shared<VVector<Complex>> (a.Height());
             
 	    *hevecs[i] = 0;
-	    for (int j = 0; j < m; j++)
-	      *hevecs[i] += evecs(i,j) * *abv[j];
+	    if (block)
+	      {
+		FlatVector<Complex> fev = hevecs[i]->FVComplex();
+		for (int j = 0; j < m; j++)
+		  fev += evecs(i,j) * basis[j];
+	      }
+	    else
+	      for (int j = 0; j < m; j++)
+		*hevecs[i] += evecs(i,j) * *abv[j];
 	    // hevecs[i]->FVComplex() = Trans(matV)*evecs.Row(i);
 	  }
       }
@@ -106,6 +106,24 @@ namespace ngla
     y += s * *temp;
   }
 
+  void BaseMatrix :: Mult (const MultiVector & x, MultiVector & y) const
+  {
+    y = 0.0;
+    MultAdd (1, x, y);
+  }
+
+  void BaseMatrix :: MultAdd (double s, const MultiVector & x, MultiVector & y) const
+  {
+    if (x.Num() != y.Num())
+      throw Exception ("BaseMatrix::MultAdd: different number of vectors");
+    for (size_t i = 0; i < x.Num(); i++)
+      {
+        auto xi = x.Vec(i);
+        auto yi = y.Vec(i);
+        MultAdd (s, xi, yi);
+      }
+  }
+
   void BaseMatrix :: MultAdd (Complex s, const BaseVector & x, BaseVector & y) const 
   {
     stringstream err;
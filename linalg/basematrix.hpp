@@ -104,6 +104,11 @@ namespace ngla
     /// y += s Trans(matrix) * x
     virtual void MultTransAdd (Complex s, const BaseVector & x, BaseVector & y) const;
 
+    /// y = matrix * x for all vectors of x
+    virtual void Mult (const MultiVector & x, MultiVector & y) const;
+    /// y += s matrix * x for all vectors of x, default is vector by vector
+    virtual void MultAdd (double s, const MultiVector & x, MultiVector & y) const;
+
 
 
 
@@ -844,6 +844,202 @@ namespace ngla
   }
   
 
+  static bool IsBlockVector (const BaseVector * v)
+  {
+    if (auto av = dynamic_cast<const AutoVector*> (v))
+      v = &**av;
+    return dynamic_cast<const BlockVector*> (v) != nullptr;
+  }
+
+
+  template <class SCAL>
+  void FusedInnerProducts<SCAL> :: 
+  Start (FlatArray<const BaseVector*> a, FlatArray<const BaseVector*> b)
+  {
+    static Timer t("FusedInnerProducts");
+    RegionTimer reg(t);
+
+    Wait();
+    size_t n = a.Size();
+    sums.SetSize (n);
+    sums = SCAL(0.0);
+    if (n == 0) return;
+
+    for (size_t i = 0; i < n; i++)
+      if (IsBlockVector (a[i]) || IsBlockVector (b[i]))
+        {
+          // no flat memory, reduce one by one
+          for (size_t j = 0; j < n; j++)
+            sums[j] = S_InnerProduct<SCAL> (*a[j], *b[j]);
+          return;
+        }
+
+#ifdef PARALLEL
+    bool parallel = false;
+    for (size_t i = 0; i < n; i++)
+      {
+        auto stata = a[i]->GetParallelStatus();
+        auto statb = b[i]->GetParallelStatus();
+        if (stata == NOT_PARALLEL && statb == NOT_PARALLEL) continue;
+        parallel = true;
+        // one distributed and one cumulated vector give the local part
+        if (stata == statb)
+          {
+            if (stata == DISTRIBUTED)
+              a[i]->Cumulate();
+            else
+              a[i]->Distribute();
+          }
+      }
+#endif
+
+    Array<FlatVector<SCAL>> fa(n), fb(n);
+    for (size_t i = 0; i < n; i++)
+      {
+        auto va = a[i]->FV<SCAL>();
+        auto vb = b[i]->FV<SCAL>();
+        fa[i].AssignMemory (va.Size(), va.Data());
+        fb[i].AssignMemory (vb.Size(), vb.Data());
+      }
+    t.AddFlops (n * fa[0].Size());
+
+    // one pass over the vectors for all products
+    constexpr int ntasks = 16;
+    Array<SCAL> parts(ntasks*n);
+    ParallelJob ([&] (TaskInfo ti)
+                 {
+                   auto r = ::Range(fa[0]).Split (ti.task_nr, ti.ntasks);
+                   for (size_t i = 0; i < n; i++)
+                     parts[ti.task_nr*n+i] = ngbla::InnerProduct (fa[i].Range(r), fb[i].Range(r));
+                 }, ntasks);
+    for (int k = 0; k < ntasks; k++)
+      for (size_t i = 0; i < n; i++)
+        sums[i] += parts[k*n+i];
+
+#ifdef PARALLEL
+    if (parallel)
+      {
+        for (size_t i = 0; i < n; i++)
+          if (a[i]->GetParallelStatus() != NOT_PARALLEL)
+            {
+              auto comm = dynamic_cast_ParallelBaseVector(*a[i]).GetParallelDofs()->GetCommunicator();
+              MPI_Iallreduce (MPI_IN_PLACE, sums.Addr(0), n*sizeof(SCAL)/sizeof(double),
+                              MPI_DOUBLE, MPI_SUM, comm, &request);
+              pending = true;
+              break;
+            }
+      }
+#endif
+  }
+
+  template <class SCAL>
+  FlatArray<SCAL> FusedInnerProducts<SCAL> :: Wait ()
+  {
+#ifdef PARALLEL
+    if (pending)
+      {
+        MPI_Wait (&request, MPI_STATUS_IGNORE);
+        pending = false;
+      }
+#endif
+    return sums;
+  }
+
+  template class FusedInnerProducts<double>;
+  template class FusedInnerProducts<Complex>;
+
+
+  template <class SCAL>
+  SCAL FusedVectorUpdate<SCAL> :: Run (const BaseVector * d1, const BaseVector * d2)
+  {
+    static Timer t("FusedVectorUpdate");
+    RegionTimer reg(t);
+
+    size_t n = y.Size();
+    bool flat = true;
+    for (size_t i = 0; i < n; i++)
+      for (const BaseVector * v : { (const BaseVector*)y[i], x[i] })
+        if (IsBlockVector (v) || v->GetParallelStatus() != NOT_PARALLEL)
+          flat = false;
+    if (d1)
+      for (const BaseVector * v : { d1, d2 })
+        if (IsBlockVector (v) || v->GetParallelStatus() != NOT_PARALLEL)
+          flat = false;
+
+    if (!flat)
+      {
+        for (size_t i = 0; i < n; i++)
+          {
+            if (b[i] == SCAL(0.0))
+              y[i]->Set (a[i], *x[i]);
+            else
+              {
+                if (b[i] != SCAL(1.0))
+                  y[i]->Scale (b[i]);
+                y[i]->Add (a[i], *x[i]);
+              }
+          }
+        y.SetSize0(); x.SetSize0(); a.SetSize0(); b.SetSize0();
+        if (!d1) return 0.0;
+        return S_InnerProduct<SCAL> (*d1, *d2);
+      }
+
+    ArrayMem<FlatVector<SCAL>,8> fy(n), fx(n);
+    for (size_t i = 0; i < n; i++)
+      {
+        auto vy = y[i]->FV<SCAL>();
+        auto vx = x[i]->FV<SCAL>();
+        fy[i].AssignMemory (vy.Size(), vy.Data());
+        fx[i].AssignMemory (vx.Size(), vx.Data());
+      }
+    FlatVector<SCAL> fd1, fd2;
+    if (d1)
+      {
+        auto v1 = d1->FV<SCAL>();
+        auto v2 = d2->FV<SCAL>();
+        fd1.AssignMemory (v1.Size(), v1.Data());
+        fd2.AssignMemory (v2.Size(), v2.Data());
+      }
+    size_t size = n ? fy[0].Size() : fd1.Size();
+    t.AddFlops (2*n*size + (d1 ? size : 0));
+
+    constexpr int ntasks = 16;
+    SCAL parts[ntasks];
+    ParallelJob ([&] (TaskInfo ti)
+                 {
+                   auto r = ::Range(size).Split (ti.task_nr, ti.ntasks);
+                   SCAL sum = 0.0;
+                   // blocks stay in L1 cache for all updates and the inner product
+                   constexpr size_t bs = 512;
+                   for (size_t first = r.First(); first < r.Next(); first += bs)
+                     {
+                       IntRange rb(first, min2(first+bs, size_t(r.Next())));
+                       for (size_t i = 0; i < n; i++)
+                         {
+                           auto yi = fy[i].Range(rb);
+                           auto xi = fx[i].Range(rb);
+                           if (b[i] == SCAL(1.0))
+                             yi += a[i] * xi;
+                           else if (b[i] == SCAL(0.0))
+                             yi = a[i] * xi;
+                           else
+                             yi = b[i] * yi + a[i] * xi;
+                         }
+                       if (d1)
+                         sum += ngbla::InnerProduct (fd1.Range(rb), fd2.Range(rb));
+                     }
+                   parts[ti.task_nr] = sum;
+                 }, ntasks);
+
+    y.SetSize0(); x.SetSize0(); a.SetSize0(); b.SetSize0();
+    SCAL sum = 0.0;
+    for (auto part : parts) sum += part;
+    return sum;
+  }
+
+  template class FusedVectorUpdate<double>;
+  template class FusedVectorUpdate<Complex>;
+
   template class S_BaseVector<double>;
   template class S_BaseVector<Complex>;
   
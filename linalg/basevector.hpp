@@ -1015,6 +1015,59 @@ namespace ngla
     return InnerProduct( v2.FVComplex(), Conj(v1.FVComplex()) );
   }
 
+  /**
+     Inner products (a[i], b[i]) of several pairs of vectors with one
+     global reduction. Start computes the local sums in a single pass
+     and starts a non-blocking reduction over the MPI ranks, Wait
+     returns the global values. Work placed between Start and Wait
+     overlaps with the communication.
+  */
+  template <class SCAL>
+  class NGS_DLL_HEADER FusedInnerProducts
+  {
+    Array<SCAL> sums;
+#ifdef PARALLEL
+    MPI_Request request;
+    bool pending = false;
+#endif
+  public:
+    FusedInnerProducts () = default;
+    ~FusedInnerProducts () { Wait(); }
+    ///
+    void Start (FlatArray<const BaseVector*> a, FlatArray<const BaseVector*> b);
+    ///
+    FlatArray<SCAL> Wait ();
+  };
+
+  /**
+     BLAS-1 updates y = b y + a x of several vectors in one threaded
+     sweep over memory, optionally followed by the inner product of
+     updated vectors while they are still in cache. Updates are applied
+     in the order they are added, so a vector may be updated twice.
+     Parallel and block vectors fall back to separate passes.
+
+     FusedVectorUpdate<double>().Add(x, al, p).Add(r, -al, ap).Run(&r, &r);
+  */
+  template <class SCAL>
+  class NGS_DLL_HEADER FusedVectorUpdate
+  {
+    ArrayMem<BaseVector*,8> y;
+    ArrayMem<const BaseVector*,8> x;
+    ArrayMem<SCAL,8> a, b;
+  public:
+    /// y = b * y + a * x
+    FusedVectorUpdate & Add (BaseVector & ay, SCAL aa, const BaseVector & ax, SCAL ab = 1.0)
+    {
+      y.Append (&ay);
+      x.Append (&ax);
+      a.Append (aa);
+      b.Append (ab);
+      return *this;
+    }
+    /// performs the updates, returns (d1, d2) of the new values if d1 is given
+    SCAL Run (const BaseVector * d1 = nullptr, const BaseVector * d2 = nullptr);
+  };
+
   ///
   inline double L2Norm (const BaseVector & v)
   {
@@ -498,6 +498,69 @@ namespace ngla
   }
 
 
+  template <class TM, class TV_ROW, class TV_COL>
+  void BlockJacobiPrecond<TM, TV_ROW, TV_COL> ::
+  ConvertToSinglePrecision ()
+  {
+    if (!is_same<TM,double>::value)
+      BaseBlockJacobiPrecond::ConvertToSinglePrecision();
+    if (invdiag_single.Size()) return;
+
+    bigmem_single.SetSize (bigmem.Size());
+    ParallelForRange (bigmem.Size(), [&] (IntRange r)
+                      {
+                        for (auto i : r)
+                          bigmem_single[i] = TSINGLE(bigmem[i]);
+                      });
+
+    invdiag_single.SetSize (invdiag.Size());
+    size_t totmem = 0;
+    for (auto i : Range(invdiag))
+      {
+        size_t bs = invdiag[i].Height();
+        new ( & invdiag_single[i] ) FlatMatrix<TSINGLE> (bs, bs, bigmem_single.Addr(totmem));
+        totmem += sqr (bs);
+      }
+
+    invdiag.DeleteAll();
+    bigmem.DeleteAll();
+  }
+
+
+  template <class TM, class TV_ROW, class TV_COL>
+  void BlockJacobiPrecond<TM, TV_ROW, TV_COL> ::
+  MultInvDiag (size_t i, FlatVector<TVX> hx, FlatVector<TVX> hy, bool trans) const
+  {
+    if (!invdiag_single.Size())
+      {
+        if (trans)
+          hy = Trans(invdiag[i]) * hx;
+        else
+          hy = invdiag[i] * hx;
+        return;
+      }
+
+    // mixed precision: entries are converted on the fly
+    FlatMatrix<TSINGLE> inv = invdiag_single[i];
+    size_t bs = inv.Height();
+    if (trans)
+      {
+        hy = TVX(0.0);
+        for (size_t k = 0; k < bs; k++)
+          for (size_t j = 0; j < bs; j++)
+            hy(j) += Trans(TM(inv(k,j))) * hx(k);
+      }
+    else
+      for (size_t j = 0; j < bs; j++)
+        {
+          TVX sum(0.0);
+          for (size_t k = 0; k < bs; k++)
+            sum += TM(inv(j,k)) * hx(k);
+          hy(j) = sum;
+        }
+  }
+
+
   
   template <class TM, class TV_ROW, class TV_COL>
   void BlockJacobiPrecond<TM, TV_ROW, TV_COL> ::
@@ -529,7 +592,7 @@ namespace ngla
                  for (int j = 0; j < bs; j++)
                    hx(j) = fx((*blocktable)[i][j]);
                  
-                 hy = invdiag[i] * hx;
+                 MultInvDiag (i, hx, hy);
                  
                  for (int j = 0; j < bs; j++)
                    fy((*blocktable)[i][j]) += s * hy(j);
@@ -539,6 +602,68 @@ namespace ngla
   }
 
 
+  template <class TM, class TV_ROW, class TV_COL>
+  void BlockJacobiPrecond<TM, TV_ROW, TV_COL> ::
+  MultAdd (double s, const MultiVector & x, MultiVector & y) const 
+  {
+    BaseMatrix::MultAdd (s, x, y);
+  }
+
+  template <>
+  void BlockJacobiPrecond<double,double,double> ::
+  MultAdd (double s, const MultiVector & x, MultiVector & y) const 
+  {
+    if (invdiag_single.Size())
+      {
+        BaseMatrix::MultAdd (s, x, y);
+        return;
+      }
+
+    static Timer timer("BlockJacobi::MultAdd (multi-vector)");
+    RegionTimer reg (timer);
+    size_t k = x.Num();
+    if (y.Num() != k)
+      throw Exception ("BlockJacobi::MultAdd: different number of vectors");
+    if (k == 0) return;
+
+    for (int c : Range(block_coloring))        
+      {
+        ParallelForRange
+          (color_balance[c],  [&] (IntRange r) 
+           {
+             Matrix<double> hxmax(maxbs, k);
+             Matrix<double> hymax(maxbs, k);
+             
+             for (int i : block_coloring[c].Range(r))
+               {
+                 FlatArray<int> block = (*blocktable)[i];
+                 size_t bs = block.Size();
+                 if (!bs) continue;
+                 
+                 auto hx = hxmax.Rows(0,bs);
+                 auto hy = hymax.Rows(0,bs);
+                 
+                 for (size_t j = 0; j < k; j++)
+                   {
+                     auto xj = x[j];
+                     for (size_t l = 0; l < bs; l++)
+                       hx(l,j) = xj(block[l]);
+                   }
+
+                 MultMatMat (invdiag[i], hx, hy);
+                 
+                 for (size_t j = 0; j < k; j++)
+                   {
+                     auto yj = y[j];
+                     for (size_t l = 0; l < bs; l++)
+                       yj(block[l]) += s * hy(l,j);
+                   }
+               }
+           });
+      }
+  }
+
+
   template <class TM, class TV_ROW, class TV_COL>
   void BlockJacobiPrecond<TM, TV_ROW, TV_COL> ::
   MultTransAdd (TSCAL s, const BaseVector & x, BaseVector & y) const 
@@ -571,7 +696,7 @@ namespace ngla
                  for (size_t j = 0; j < bs; j++)
                    hx(j) = fx(block[j]);
                  
-                 hy = Trans(invdiag[i]) * hx;
+                 MultInvDiag (i, hx, hy, true);
                  
                  for (size_t j = 0; j < bs; j++)
                    fy(block[j]) += s * hy(j);
@@ -620,7 +745,7 @@ namespace ngla
                        hx(j) = fb(jj) - mat.RowTimesVector (jj, fx);
                      }
                    
-                   hy = (invdiag[i]) * hx;
+                   MultInvDiag (i, hx, hy);
                    fx(block) += hy;
                  }
                
@@ -652,7 +777,7 @@ namespace ngla
                           hx(j) = fb(jj) - mat.RowTimesVector (jj, fx);
                         }
                       
-                      hy = (invdiag[i]) * hx;
+                      MultInvDiag (i, hx, hy);
                       fx(block) += hy;
                     }
                 });
@@ -694,7 +819,7 @@ namespace ngla
                           hx(j) = fb(jj) - mat.RowTimesVector (jj, fx);
                         }
                       
-                      hy = (invdiag[i]) * hx;
+                      MultInvDiag (i, hx, hy);
                       fx(block) += hy;
                     }
                 }
@@ -741,7 +866,7 @@ namespace ngla
                        hx(j) = fb(jj) - mat.RowTimesVector (jj, fx);
                      }
                    
-                   hy = (invdiag[i]) * hx;
+                   MultInvDiag (i, hx, hy);
                    fx(block) += hy;
                  }
              });
@@ -978,6 +1103,28 @@ namespace ngla
 
 
 
+  template <class TM, class TV>
+  void BlockJacobiPrecondSymmetric<TM,TV> :: 
+  ConvertToSinglePrecision ()
+  {
+    if (!is_same<TM,double>::value || lowmem)
+      BaseBlockJacobiPrecond::ConvertToSinglePrecision();
+    if (single_precision) return;
+
+    for (int k = 0; k < NBLOCKS; k++)
+      {
+        data_single[k].SetSize (data[k].Size());
+        ParallelForRange (data[k].Size(), [&] (IntRange r)
+                          {
+                            for (auto i : r)
+                              data_single[k][i] = TSINGLE(data[k][i]);
+                          });
+        data[k].DeleteAll();
+      }
+    single_precision = true;
+  }
+
+
   template <class TM, class TV>
   void BlockJacobiPrecondSymmetric<TM,TV> :: 
   MultAdd (TSCAL s, const BaseVector & x, BaseVector & y) const 
@@ -1002,7 +1149,7 @@ namespace ngla
 	for (int j = 0; j < bs; j++)
 	  hx(j) = fx((*blocktable)[i][j]);
 	
-	InvDiag(i).Mult (hx, hy);
+	MultInvDiag (i, hx, hy);
 
 	for (int j = 0; j < bs; j++)
 	  fy((*blocktable)[i][j]) += s * hy(j);
@@ -1171,7 +1318,7 @@ namespace ngla
     for (int j = 0; j < bs; j++)
       di(j) = y(row[j]) - mat.RowTimesVectorNoDiag (row[j], x);
     if (!lowmem)
-      InvDiag(i).Mult (di, wi);
+      MultInvDiag (i, di, wi);
     else
       {
 	int bw = blockbw[i];
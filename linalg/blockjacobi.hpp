@@ -62,6 +62,12 @@ namespace ngla
     }
 
 
+    /// keep the block inverses in single precision only
+    virtual void ConvertToSinglePrecision ()
+    {
+      throw Exception ("BlockJacobi: single precision not available for this matrix type");
+    }
+
     /// reorders block entries for band-width minimization
     int Reorder (FlatArray<int> block, const MatrixGraph & graph,
 		 FlatArray<int> usedflags,        // in and out: array of -1, size = graph.size
@@ -120,6 +126,14 @@ namespace ngla
     /// the data for the inverses
     Array<TM> bigmem;
 
+    typedef typename std::conditional<std::is_same<TM,double>::value,float,TM>::type TSINGLE;
+    /// single precision inverses, replace invdiag after ConvertToSinglePrecision
+    Array<FlatMatrix<TSINGLE>> invdiag_single;
+    Array<TSINGLE> bigmem_single;
+
+    /// hy = invdiag[i] * hx, or its transpose
+    void MultInvDiag (size_t i, FlatVector<TV_ROW> hx, FlatVector<TV_ROW> hy, bool trans = false) const;
+
   public:
     // typedef typename mat_traits<TM>::TV_ROW TVX;
     typedef TV_ROW TVX;
@@ -149,6 +163,8 @@ namespace ngla
     ///
     virtual void MultTransAdd (TSCAL s, const BaseVector & x, BaseVector & y) const;
 
+    /// blocks are applied to all vectors at once (real scalar matrices)
+    virtual void MultAdd (double s, const MultiVector & x, MultiVector & y) const override;
 
     ///
     virtual void GSSmooth (BaseVector & x, const BaseVector & b,
@@ -180,12 +196,18 @@ namespace ngla
 	  int bs = (*blocktable)[i].Size();
 	  nels += bs*bs;
 	}
-      mu.Append (new MemoryUsageStruct ("BlockJac", nels*sizeof(TM), blocktable->Size()));
+      if (invdiag_single.Size())
+        mu.Append (new MemoryUsageStruct ("BlockJac (single precision)", nels*sizeof(TSINGLE), blocktable->Size()));
+      else
+        mu.Append (new MemoryUsageStruct ("BlockJac", nels*sizeof(TM), blocktable->Size()));
     }
 
-
+    virtual void ConvertToSinglePrecision ();
   };
 
+  template <> void BlockJacobiPrecond<double,double,double> ::
+  MultAdd (double s, const MultiVector & x, MultiVector & y) const;
+
 
 
 
@@ -210,6 +232,11 @@ namespace ngla
     Array<int> blockstart, blocksize, blockbw;
     Array<TM> data[NBLOCKS];
 
+    typedef typename std::conditional<std::is_same<TM,double>::value,float,TM>::type TSINGLE;
+    /// single precision factors, replace data after ConvertToSinglePrecision
+    Array<TSINGLE> data_single[NBLOCKS];
+    bool single_precision = false;
+
 
     bool lowmem;
   public:
@@ -237,6 +264,16 @@ namespace ngla
     }
 
     void ComputeBlockFactor (FlatArray<int> block, int bw, FlatBandCholeskyFactors<TM> & inv) const;
+
+    /// hy = block inverse i * hx, from the double or the single precision factors
+    void MultInvDiag (int i, FlatVector<TVX> hx, FlatVector<TVX> hy) const
+    {
+      if (single_precision)
+        FlatBandCholeskyFactors<TSINGLE> (blocksize[i], blockbw[i],
+                                          const_cast<TSINGLE*>(&data_single[i%NBLOCKS][blockstart[i]])).Mult (hx, hy);
+      else
+        InvDiag(i).Mult (hx, hy);
+    }
   
     ///
     virtual void MultAdd (TSCAL s, const BaseVector & x, BaseVector & y) const;
@@ -296,6 +333,8 @@ namespace ngla
     {
       ;
     }
+
+    virtual void ConvertToSinglePrecision () override;
   
     /*  
 	virtual void MemoryUsage (Array<MemoryUsageStruct*> & mu) const
@@ -77,6 +77,20 @@ namespace ngla
   }
 
 
+  void KrylovSpaceSolver :: Mult (const MultiVector & f, MultiVector & x) const
+  {
+    // vector by vector, without initialize x[i] is the initial guess
+    if (f.Num() != x.Num())
+      throw Exception ("KrylovSpaceSolver::Mult: different number of vectors");
+    for (size_t i = 0; i < f.Num(); i++)
+      {
+        auto fi = f.Vec(i);
+        auto xi = x.Vec(i);
+        Mult (fi, xi);
+      }
+  }
+
+
   template <class SCAL>
   void BruteInnerProduct(const BaseVector & a, const BaseVector & b, Vector<SCAL> & result, const int start = 0)
   {
@@ -611,19 +625,31 @@ namespace ngla
 	    if (kss == 0.0) break;
 	    
 	    al = wd / kss;
-	    u += al * s;
-	    d -= al * w;
+	    FusedVectorUpdate<SCAL> upd;
+	    upd.Add (u, al, s).Add (d, -al, w);
 
 	    if (c)
-	      w = (*c) * d;
+	      {
+		upd.Run();
+		w = (*c) * d;
+		wdn = S_InnerProduct<IPTYPE> (d, w);
+	      }
 	    else
-	      w = d;
-	    wdn = S_InnerProduct<IPTYPE> (d, w);
+	      {
+		// (d,d) computed in the same sweep as the update
+		if (is_same<IPTYPE,SCAL>::value)
+		  wdn = upd.Run (&d, &d);
+		else
+		  {
+		    upd.Run();
+		    wdn = S_InnerProduct<IPTYPE> (d, d);
+		  }
+		w = d;
+	      }
 
 	    be = wdn / wd;
 	    
-	    s *= be;
-	    s += w;
+	    FusedVectorUpdate<SCAL>().Add (s, 1.0, w, be).Run();
 
 	    if (printrates ) cout << IM(1) << n << " " << sqrt (Abs (wdn)) << endl;
 	    if ( sh )
@@ -650,6 +676,344 @@ namespace ngla
 
 
 
+  template <class IPTYPE>
+  void PipelinedCGSolver<IPTYPE> :: Mult (const BaseVector & f, BaseVector & x) const
+  {
+    static Timer timer ("Pipelined CG solver");
+    RegionTimer reg (timer);
+
+    try
+      {
+	// Solve A x = f
+	if(sh)
+	  sh->SetThreadPercentage(0);
+
+        // r residual, u = C r, w = A u
+        // recurrences m = C w, n = A m, and for the search directions
+        auto r = f.CreateVector();
+        auto u = f.CreateVector();
+        auto w = f.CreateVector();
+        auto m = f.CreateVector();
+        auto nv = f.CreateVector();
+        auto z = f.CreateVector();
+        auto q = f.CreateVector();
+        auto s = f.CreateVector();
+        auto p = f.CreateVector();
+
+	if (initialize)
+	  {
+	    x = 0.0;
+	    r = f;
+	  }
+	else
+	  {
+	    r = f - (*a) * x;
+	  }
+
+        if (c)
+          u = (*c) * r;
+        else
+          u = r;
+        w = (*a) * u;
+
+        FusedInnerProducts<SCAL> dots;
+        const BaseVector * dots_a[] = { &r, &w };
+        const BaseVector * dots_b[] = { &u, &u };
+
+	int n = 0;
+	SCAL gamma, gammaold = 0.0, delta, al = 0.0, be;
+	double err = 0, lwstart = 0, lerr = 0;
+
+        while (true)
+          {
+            // (r,u) and (w,u) in one reduction, overlapping C and A
+            dots.Start (FlatArray<const BaseVector*> (2, dots_a),
+                        FlatArray<const BaseVector*> (2, dots_b));
+            if (c)
+              m = (*c) * w;
+            else
+              m = w;
+            nv = (*a) * m;
+            auto ip = dots.Wait();
+            gamma = ip[0];
+            delta = ip[1];
+
+            if (n == 0)
+              {
+                if (printrates) cout << IM(1) << "0 " << sqrt(Abs(gamma)) << endl;
+                if (gamma == 0.0) break;
+
+                if(stop_absolute)
+                  err = prec * prec;
+                else
+                  err = prec * prec * Abs (gamma);
+                lwstart = log(Abs(gamma));
+                lerr = log(err);
+              }
+            else
+              {
+                if (printrates ) cout << IM(1) << n << " " << sqrt (Abs (gamma)) << endl;
+                if ( sh )
+                  sh->SetThreadPercentage(100.*max2(double(n)/double(maxsteps),
+                                                    (lwstart-log(Abs(gamma)))/(lwstart-lerr)));
+              }
+
+            if (n >= maxsteps || Abs(gamma) <= err || (sh && sh->ShouldTerminate()))
+              break;
+            n++;
+
+            if (n == 1)
+              {
+                if (delta == 0.0) break;
+                be = 0.0;
+                al = gamma / delta;
+                z = nv;
+                q = m;
+                s = w;
+                p = u;
+              }
+            else
+              {
+                be = gamma / gammaold;
+                SCAL denom = delta - be * gamma / al;
+                if (denom == 0.0) break;
+                al = gamma / denom;
+                FusedVectorUpdate<SCAL>()
+                  .Add (z, 1.0, nv, be).Add (q, 1.0, m, be)
+                  .Add (s, 1.0, w, be).Add (p, 1.0, u, be).Run();
+              }
+            gammaold = gamma;
+
+            FusedVectorUpdate<SCAL>()
+              .Add (x, al, p).Add (r, -al, s)
+              .Add (u, -al, q).Add (w, -al, z).Run();
+          }
+
+	const_cast<int&> (steps) = n;
+      }
+
+    catch (Exception & e)
+      {
+	e.Append ("in caught in PipelinedCGSolver::Mult\n");
+	throw;
+      }
+    catch (exception & e)
+      {
+	throw Exception(e.what() +
+			string ("\ncaught in PipelinedCGSolver::Mult\n"));
+      }
+  }
+
+
+
+  template <class IPTYPE>
+  void SStepCGSolver<IPTYPE> :: Mult (const BaseVector & f, BaseVector & x) const
+  {
+    static Timer timer ("s-step CG solver");
+    RegionTimer reg (timer);
+
+    try
+      {
+	// Solve A x = f
+	if(sh)
+	  sh->SetThreadPercentage(0);
+
+        auto r = f.CreateVector();
+        // basis v, its image av, search directions p of the last step and new ones
+        Array<shared_ptr<BaseVector>> v(s), av(s), p(s), ap(s), pnew(s), apnew(s);
+        for (int j = 0; j < s; j++)
+          {
+            v[j] = f.CreateVector();
+            av[j] = f.CreateVector();
+            p[j] = f.CreateVector();
+            ap[j] = f.CreateVector();
+            pnew[j] = f.CreateVector();
+            apnew[j] = f.CreateVector();
+          }
+        // number of search directions of the last step, inverse of p^T A p
+        int np = 0;
+        Matrix<SCAL> winv(s, s);
+
+	if (initialize)
+	  {
+	    x = 0.0;
+	    r = f;
+	  }
+	else
+	  {
+	    r = f - (*a) * x;
+	  }
+
+        FusedInnerProducts<SCAL> dots;
+        Array<const BaseVector*> dots_a, dots_b;
+        Matrix<SCAL> g1(s, s), g2(s, s), b(s, s), wk(s, s), ldl(s, s);
+        Vector<SCAL> g(s), gp(s), al(s);
+
+	int n = 0;
+	double err = 0, lwstart = 0, lerr = 0;
+
+        while (true)
+          {
+            // Krylov basis, no inner products
+            if (c)
+              *v[0] = (*c) * r;
+            else
+              *v[0] = r;
+            for (int j = 0; j < s; j++)
+              {
+                *av[j] = (*a) * *v[j];
+                if (j+1 < s)
+                  {
+                    if (c)
+                      *v[j+1] = (*c) * *av[j];
+                    else
+                      *v[j+1] = *av[j];
+                  }
+              }
+
+            // g = v^T r, g1 = v^T A v, g2 = (A p)^T v, gp = p^T r in one reduction
+            dots_a.SetSize0();
+            dots_b.SetSize0();
+            for (int j = 0; j < s; j++)
+              {
+                dots_a.Append (v[j].get());
+                dots_b.Append (&r);
+              }
+            for (int l = 0; l < np; l++)
+              {
+                dots_a.Append (p[l].get());
+                dots_b.Append (&r);
+              }
+            for (int i = 0; i < s; i++)
+              for (int j = 0; j <= i; j++)
+                {
+                  dots_a.Append (v[i].get());
+                  dots_b.Append (av[j].get());
+                }
+            for (int l = 0; l < np; l++)
+              for (int j = 0; j < s; j++)
+                {
+                  dots_a.Append (ap[l].get());
+                  dots_b.Append (v[j].get());
+                }
+            dots.Start (dots_a, dots_b);
+            auto ip = dots.Wait();
+
+            size_t ii = 0;
+            for (int j = 0; j < s; j++)
+              g(j) = ip[ii++];
+            for (int l = 0; l < np; l++)
+              gp(l) = ip[ii++];
+            for (int i = 0; i < s; i++)
+              for (int j = 0; j <= i; j++)
+                g1(i,j) = g1(j,i) = ip[ii++];
+            for (int l = 0; l < np; l++)
+              for (int j = 0; j < s; j++)
+                g2(l,j) = ip[ii++];
+
+            SCAL gamma = g(0);
+            if (n == 0)
+              {
+                if (printrates) cout << IM(1) << "0 " << sqrt(Abs(gamma)) << endl;
+                if (gamma == 0.0) break;
+
+                if(stop_absolute)
+                  err = prec * prec;
+                else
+                  err = prec * prec * Abs (gamma);
+                lwstart = log(Abs(gamma));
+                lerr = log(err);
+              }
+            else
+              {
+                if (printrates ) cout << IM(1) << n << " " << sqrt (Abs (gamma)) << endl;
+                if ( sh )
+                  sh->SetThreadPercentage(100.*max2(double(n)/double(maxsteps),
+                                                    (lwstart-log(Abs(gamma)))/(lwstart-lerr)));
+              }
+
+            if (n >= maxsteps || Abs(gamma) <= err || (sh && sh->ShouldTerminate()))
+              break;
+
+            // A-orthogonalize against the last directions:
+            // p_new = v - p b,  b = (p^T A p)^{-1} (A p)^T v
+            // p_new^T A p_new = g1 - g2^T b,  p_new^T r = g - b^T gp
+            // (gp vanishes in exact arithmetic)
+            for (int i = 0; i < np; i++)
+              for (int j = 0; j < s; j++)
+                {
+                  SCAL sum = 0.0;
+                  for (int l = 0; l < np; l++)
+                    sum += winv(i,l) * g2(l,j);
+                  b(i,j) = sum;
+                }
+            for (int i = 0; i < s; i++)
+              for (int j = 0; j < s; j++)
+                {
+                  SCAL sum = g1(i,j);
+                  for (int l = 0; l < np; l++)
+                    sum -= g2(l,i) * b(l,j);
+                  wk(i,j) = sum;
+                }
+
+            // LDL^T, stop at the first (numerically) dependent direction
+            int keep = 0;
+            for ( ; keep < s; keep++)
+              {
+                int k = keep;
+                for (int j = 0; j <= k; j++)
+                  {
+                    SCAL sum = wk(k,j);
+                    for (int l = 0; l < j; l++)
+                      sum -= ldl(k,l) * ldl(j,l) * ldl(l,l);
+                    ldl(k,j) = (j < k) ? sum / ldl(j,j) : sum;
+                  }
+                if (Abs(ldl(k,k)) <= 1e-8 * Abs(wk(k,k)) || wk(k,k) == 0.0)
+                  break;
+              }
+            if (keep == 0) break;
+
+            Matrix<SCAL> wkinv = wk.Rows(0,keep).Cols(0,keep);
+            CalcInverse (wkinv);
+            for (int j = 0; j < keep; j++)
+              for (int l = 0; l < np; l++)
+                g(j) -= b(l,j) * gp(l);
+            al.Range(0,keep) = wkinv * g.Range(0,keep);
+
+            for (int j = 0; j < keep; j++)
+              {
+                FusedVectorUpdate<SCAL> upd;
+                upd.Add (*pnew[j], 1.0, *v[j], 0.0).Add (*apnew[j], 1.0, *av[j], 0.0);
+                for (int l = 0; l < np; l++)
+                  upd.Add (*pnew[j], -b(l,j), *p[l]).Add (*apnew[j], -b(l,j), *ap[l]);
+                upd.Add (x, al(j), *pnew[j]).Add (r, -al(j), *apnew[j]).Run();
+              }
+
+            p.Swap (pnew);
+            ap.Swap (apnew);
+            np = keep;
+            winv.Rows(0,keep).Cols(0,keep) = wkinv;
+            n += keep;
+          }
+
+	const_cast<int&> (steps) = n;
+      }
+
+    catch (Exception & e)
+      {
+	e.Append ("in caught in SStepCGSolver::Mult\n");
+	throw;
+      }
+    catch (exception & e)
+      {
+	throw Exception(e.what() +
+			string ("\ncaught in SStepCGSolver::Mult\n"));
+      }
+  }
+
+
+
+
   template <class IPTYPE>
   void BiCGStabSolver<IPTYPE> :: Mult (const BaseVector & f, BaseVector & u) const
   {
@@ -704,8 +1068,9 @@ namespace ngla
 	t = (*a) * s_tilde;
 
 	omega = S_InnerProduct<IPTYPE> (t, s) / S_InnerProduct<IPTYPE> (t, t);
-	u += alpha * p_tilde + omega * s_tilde;
-	r = s - omega * t;
+	FusedVectorUpdate<SCAL>()
+	  .Add (u, alpha, p_tilde).Add (u, omega, s_tilde)
+	  .Add (r, 1.0, s, 0.0).Add (r, -omega, t).Run();
 
 	err_i = L2Norm(r);
 	if (printrates) cout << IM(1) << "0 " << err_i << endl;
@@ -725,7 +1090,9 @@ namespace ngla
 	    rho_old = rho_new;
 	    rho_new = S_InnerProduct<IPTYPE>(r_tilde, r);
 	    beta = (rho_new / rho_old ) * ( alpha / omega );
-	    p = r + beta * ( p - omega * v );
+	    // p = r + beta * (p - omega*v), in place
+	    FusedVectorUpdate<SCAL>()
+	      .Add (p, -omega, v).Add (p, 1.0, r, beta).Run();
 
 	    if (c)
 	      p_tilde = (*c) * p;
@@ -734,10 +1101,11 @@ namespace ngla
 	    
 	    v = (*a) * p_tilde;
 	    alpha = rho_new / S_InnerProduct<IPTYPE> (r_tilde, v);
-	    s = r - alpha * v;
+	    FusedVectorUpdate<SCAL>()
+	      .Add (s, 1.0, r, 0.0).Add (s, -alpha, v)
+	      .Add (u, alpha, p_tilde).Run();
 
 	    err_i = L2Norm(s);
-	    u += alpha * p_tilde;
 	    
 	    if ( err_i < err )
 	      {
@@ -752,8 +1120,9 @@ namespace ngla
 	    t = (*a) * s_tilde;
 	    
 	    omega = S_InnerProduct<IPTYPE> (t, s) / S_InnerProduct<IPTYPE> (t, t);
-	    u +=  omega * s_tilde;
-	    r = s - omega * t;
+	    FusedVectorUpdate<SCAL>()
+	      .Add (u, omega, s_tilde)
+	      .Add (r, 1.0, s, 0.0).Add (r, -omega, t).Run();
 
 	    err_i = L2Norm(r);
 
@@ -932,9 +1301,11 @@ namespace ngla
             for (int i = 0; i <= j; i++)
               h2(i,j) = h(i,j) = S_InnerProduct<IPTYPE> (*vi[i], av);
 
-            w = av;
+            FusedVectorUpdate<SCAL> orthogonalize;
+            orthogonalize.Add (w, 1.0, av, 0.0);
             for (int i = 0; i <= j; i++)
-              w -= h(i,j) * (*vi[i]);
+              orthogonalize.Add (w, -h(i,j), *vi[i]);
+            orthogonalize.Run();
 
             v = (1.0 / sqrt (S_InnerProduct<IPTYPE> (w, w))) * w;
             h2(j+1,j) = h(j+1,j) = S_InnerProduct<IPTYPE> (v, av);
@@ -972,8 +1343,10 @@ namespace ngla
             y(i) = sum / h(i,i);
           }
 
+        FusedVectorUpdate<SCAL> update;
         for (int i = 0; i <= j; i++)
-          x += y(i) * *vi[i];
+          update.Add (x, y(i), *vi[i]);
+        update.Run();
 
 	const_cast<int&> (steps) = j;
 	
@@ -1159,11 +1532,9 @@ void QMRSolver<SCAL> :: Mult (const BaseVector & b, BaseVector & x) const
 	      return;                        // return on breakdown
 	    }
 
-	  v = (1.0/rho) * v_tld;
-	  y /= rho;
-
-	  w = (1.0/xi) * w_tld;
-	  z /= xi;
+	  FusedVectorUpdate<SCAL>()
+	    .Add (v, 1.0/rho, v_tld, 0.0).Add (y, 0.0, y, 1.0/rho)
+	    .Add (w, 1.0/xi, w_tld, 0.0).Add (z, 0.0, z, 1.0/xi).Run();
 
 
 	  delta = S_InnerProduct<SCAL> (z, y);
@@ -1191,10 +1562,9 @@ void QMRSolver<SCAL> :: Mult (const BaseVector & b, BaseVector & x) const
 	    {
 	      //  p = y_tld - (xi(0) * delta(0) / ep(0)) * p;
 	      //  q = z_tld - (rho(0) * delta(0) / ep(0)) * q;
-	      p *= (-xi * delta / ep);
-	      p += y_tld;
-	      q *= (-rho * delta / ep);
-	      q += z_tld;
+	      FusedVectorUpdate<SCAL>()
+	        .Add (p, 1.0, y_tld, -xi * delta / ep)
+	        .Add (q, 1.0, z_tld, -rho * delta / ep).Run();
 	    } 
 	  else 
 	    {
@@ -1220,8 +1590,11 @@ void QMRSolver<SCAL> :: Mult (const BaseVector & b, BaseVector & x) const
 	      return;                        // return on breakdown
 	    }
 
-	  v_tld = p_tld;
-	  v_tld -= beta * v;
+	  // both recurrences in one sweep, w_tld does not depend on v_tld
+	  w_tld = Transpose(*a) * q;
+	  FusedVectorUpdate<SCAL>()
+	    .Add (v_tld, 1.0, p_tld, 0.0).Add (v_tld, -beta, v)
+	    .Add (w_tld, -beta, w).Run();
 
 	  if (c)
 	    y = (*c) * v_tld;
@@ -1231,9 +1604,6 @@ void QMRSolver<SCAL> :: Mult (const BaseVector & b, BaseVector & x) const
 
 	  rho_1 = rho;
 	  rho = y.L2Norm();
-
-	  w_tld = Transpose(*a) * q;
-	  w_tld -= beta * w;
 	  
 	  if (c2) 
 	    z = Transpose (*c2) * w_tld;
@@ -1263,19 +1633,15 @@ void QMRSolver<SCAL> :: Mult (const BaseVector & b, BaseVector & x) const
 	    {
 	      // d = eta(0) * p + (theta_1(0) * theta_1(0) * gamma(0) * gamma(0)) * d;
 	      // s = eta(0) * p_tld + (theta_1(0) * theta_1(0) * gamma(0) * gamma(0)) * s;
-	      d *= (theta_1 * theta_1 * gamma * gamma);
-	      d += eta * p;
-	      s *= (theta_1 * theta_1 * gamma * gamma);
-	      s += eta * p_tld;
+	      SCAL fac = theta_1 * theta_1 * gamma * gamma;
+	      FusedVectorUpdate<SCAL>()
+	        .Add (d, eta, p, fac).Add (s, eta, p_tld, fac)
+	        .Add (x, 1.0, d).Add (r, -1.0, s).Run();
 	    } 
 	  else 
-	    {
-	      d = eta * p;
-	      s = eta * p_tld;
-	    }
-	  
-	  x += d;
-	  r -= s;
+	    FusedVectorUpdate<SCAL>()
+	      .Add (d, eta, p, 0.0).Add (s, eta, p_tld, 0.0)
+	      .Add (x, 1.0, d).Add (r, -1.0, s).Run();
 
 	  if ( printrates ) cout << IM(1) << i << " " << r.L2Norm() << endl;
 	  
@@ -1315,10 +1681,328 @@ void QMRSolver<SCAL> :: Mult (const BaseVector & b, BaseVector & x) const
   
  
   
+  // a block of one vector for the block solvers
+  static void SolveSingleVector (const BaseMatrix & solver, bool initialize,
+                                 const BaseVector & f, BaseVector & x)
+  {
+    if (f.IsComplex() || f.EntrySize() != 1 || f.GetParallelStatus() != NOT_PARALLEL)
+      throw Exception ("block Krylov solvers need real, sequential vectors");
+
+    MultiVector fm(f.Size(), 1), xm(f.Size(), 1);
+    fm[0] = f.FV<double>();
+    if (!initialize)
+      xm[0] = x.FV<double>();
+    solver.Mult (fm, xm);
+    x.FV<double>() = xm[0];
+  }
+
+
+  void BlockCGSolver :: Mult (const MultiVector & f, MultiVector & x) const
+  {
+    static Timer timer ("Block CG solver");
+    RegionTimer reg (timer);
+
+    try
+      {
+	// Solve A x = f
+	if(sh)
+	  sh->SetThreadPercentage(0);
+
+        size_t n = f.Size(), k = f.Num();
+        if (x.Size() != n || x.Num() != k)
+          throw Exception ("sizes of right hand sides and solutions don't match");
+
+        // residuals r, preconditioned z, directions p, q = A p
+        MultiVector r(n,k), z(n,k), p(n,k), q(n,k);
+
+	if (initialize)
+	  {
+	    x = 0.0;
+	    r = f;
+	  }
+	else
+	  {
+	    r = f;
+	    a->MultAdd (-1.0, x, r);
+	  }
+
+        if (c)
+          c->Mult (r, z);
+        else
+          z = r;
+        p = z;
+
+        Vector<double> gamma(k), err(k);
+        Matrix<double> g(k,k), rfac(k,k), t(k,k), ginv(k,k);
+	int it = 0;
+
+        while (true)
+          {
+            Vector<double> zr = z.InnerProducts (r);
+            double maxgamma = 0;
+            for (size_t j = 0; j < k; j++)
+              {
+                gamma(j) = fabs (zr(j));
+                maxgamma = max2 (maxgamma, gamma(j));
+              }
+            if (it == 0)
+              for (size_t j = 0; j < k; j++)
+                err(j) = stop_absolute ? prec * prec : prec * prec * gamma(j);
+
+            if (printrates) cout << IM(1) << it << " " << sqrt (maxgamma) << endl;
+
+            bool converged = true;
+            for (size_t j = 0; j < k; j++)
+              if (gamma(j) > err(j)) converged = false;
+            if (it >= maxsteps || converged || (sh && sh->ShouldTerminate()))
+              break;
+
+            if (it > 0)
+              {
+                // new directions A-orthogonal to the last ones
+                Matrix<double> beta = ginv * q.InnerProduct (z);
+                z.Add (-1.0, p, beta);
+                p.Swap (z);
+              }
+            it++;
+
+            // pseudo-inverse of p^T A p, dependent directions are dropped
+            a->Mult (p, q);
+            g = p.InnerProduct (q);
+            if (TruncatedCholesky (g, rfac, t) == 0) break;
+            ginv = t * Trans (t);
+
+            Matrix<double> alpha = ginv * p.InnerProduct (r);
+            x.Add (1.0, p, alpha);
+            r.Add (-1.0, q, alpha);
+
+            if (c)
+              c->Mult (r, z);
+            else
+              z = r;
+
+            if ( sh )
+              sh->SetThreadPercentage(100.*double(it)/double(maxsteps));
+          }
+
+	const_cast<int&> (steps) = it;
+      }
+
+    catch (Exception & e)
+      {
+	e.Append ("in caught in BlockCGSolver::Mult\n");
+	throw;
+      }
+    catch (exception & e)
+      {
+	throw Exception(e.what() +
+			string ("\ncaught in BlockCGSolver::Mult\n"));
+      }
+  }
+
+  void BlockCGSolver :: Mult (const BaseVector & f, BaseVector & x) const
+  {
+    SolveSingleVector (*this, initialize, f, x);
+  }
+
+
+
+  void BlockGMRESSolver :: Mult (const MultiVector & f, MultiVector & x) const
+  {
+    static Timer timer ("Block GMRES solver");
+    RegionTimer reg (timer);
+
+    try
+      {
+	// Solve C A x = C f
+	if(sh)
+	  sh->SetThreadPercentage(0);
+
+        size_t n = f.Size(), k = f.Num();
+        if (x.Size() != n || x.Num() != k)
+          throw Exception ("sizes of right hand sides and solutions don't match");
+
+        MultiVector r(n,k), w(n,k), hw(n,k);
+
+	if (initialize)
+	  x = 0.0;
+
+        // block steps per cycle, the Krylov basis and h are restricted to it
+        int m = (restart > 0) ? min2 (restart, maxsteps) : maxsteps;
+        Matrix<double> h((m+1)*k, m*k), g((m+1)*k, k);
+        Array<size_t> rotrow, pivcol;
+        Array<double> rotc, rots;
+        Array<shared_ptr<MultiVector>> v;
+
+        Vector<double> res(k), err(k);
+        double maxres = 0;
+        int totalsteps = 0;
+        bool converged = false;
+
+        for (int cycle = 0; ; cycle++)
+          {
+            r = f;
+            if (cycle > 0 || !initialize)
+              a->MultAdd (-1.0, x, r);
+            if (c)
+              {
+                c->Mult (r, hw);
+                r = hw;
+              }
+
+            res = r.Norms();
+            maxres = 0;
+            for (size_t i = 0; i < k; i++)
+              {
+                if (cycle == 0)
+                  err(i) = stop_absolute ? prec : prec * res(i);
+                maxres = max2 (maxres, res(i));
+              }
+            if (cycle == 0 && printrates) cout << IM(1) << "0 " << maxres << endl;
+
+            // block Hessenberg matrix, its nonzero columns are rotated to upper
+            // triangular form by Givens rotations, g is the rotated right hand side
+            h = 0.0;
+            g = 0.0;
+            rotrow.SetSize0();
+            pivcol.SetSize0();
+            rotc.SetSize0();
+            rots.SetSize0();
+
+            v.SetSize0();
+            v.Append (make_shared<MultiVector> (r));
+            v[0]->Orthogonalize (g.Rows(0,k));
+
+            int j = 0;
+            for ( ; j < m && totalsteps < maxsteps; j++, totalsteps++)
+              {
+                converged = true;
+                for (size_t i = 0; i < k; i++)
+                  if (res(i) > err(i)) converged = false;
+                if (converged || (sh && sh->ShouldTerminate()))
+                  break;
+
+                // block Gram-Schmidt, twice
+                a->Mult (*v[j], w);
+                if (c)
+                  {
+                    c->Mult (w, hw);
+                    w = hw;
+                  }
+                auto hcol = h.Cols (j*k, (j+1)*k);
+                for (int pass = 0; pass < 2; pass++)
+                  for (int i = 0; i <= j; i++)
+                    {
+                      Matrix<double> hij = v[i]->InnerProduct (w);
+                      w.Add (-1.0, *v[i], hij);
+                      hcol.Rows (i*k, (i+1)*k) += hij;
+                    }
+                v.Append (make_shared<MultiVector> (w));
+                v[j+1]->Orthogonalize (hcol.Rows ((j+1)*k, (j+2)*k));
+
+                for (size_t l = 0; l < k; l++)
+                  {
+                    size_t col = j*k+l;
+                    for (size_t ri = 0; ri < rotrow.Size(); ri++)
+                      {
+                        size_t p = rotrow[ri];
+                        double hp = h(p,col), hq = h(p+1,col);
+                        h(p,col)   =  rotc[ri] * hp + rots[ri] * hq;
+                        h(p+1,col) = -rots[ri] * hp + rotc[ri] * hq;
+                      }
+
+                    // directions dropped from the basis give zero columns
+                    bool zero = true;
+                    for (size_t p = 0; p <= col+k; p++)
+                      if (h(p,col) != 0.0) zero = false;
+                    if (zero) continue;
+
+                    // eliminate the entries below the next pivot row, from the bottom
+                    size_t prow = pivcol.Size();
+                    for (size_t p = col+k; p > prow; p--)
+                      {
+                        double hp = h(p-1,col), hq = h(p,col);
+                        if (hq == 0.0) continue;
+                        double nrm = hypot (hp, hq);
+                        double cs = hp / nrm, sn = hq / nrm;
+                        h(p-1,col) = nrm;
+                        h(p,col) = 0.0;
+                        for (size_t i = 0; i < k; i++)
+                          {
+                            double gp = g(p-1,i), gq = g(p,i);
+                            g(p-1,i) =  cs * gp + sn * gq;
+                            g(p,i)   = -sn * gp + cs * gq;
+                          }
+                        rotrow.Append (p-1);
+                        rotc.Append (cs);
+                        rots.Append (sn);
+                      }
+                    pivcol.Append (col);
+                  }
+
+                // least squares residuals are the rows of g below the pivots
+                maxres = 0;
+                for (size_t i = 0; i < k; i++)
+                  {
+                    res(i) = L2Norm (g.Rows (pivcol.Size(), (j+2)*k).Col(i));
+                    maxres = max2 (maxres, res(i));
+                  }
+
+                if (printrates) cout << IM(1) << totalsteps+1 << " " << maxres << endl;
+                if ( sh )
+                  sh->SetThreadPercentage(100.*double(totalsteps+1)/double(maxsteps));
+              }
+
+            // back substitution in the triangular part of the pivot columns
+            size_t np = pivcol.Size();
+            Matrix<double> y(j*k, k);
+            y = 0.0;
+            for (size_t i = np; i-- > 0; )
+              for (size_t l = 0; l < k; l++)
+                {
+                  double sum = g(i,l);
+                  for (size_t i2 = i+1; i2 < np; i2++)
+                    sum -= h(i,pivcol[i2]) * y(pivcol[i2],l);
+                  double diag = h(i,pivcol[i]);
+                  y(pivcol[i],l) = (diag != 0.0) ? sum / diag : 0.0;
+                }
+
+            for (int i = 0; i < j; i++)
+              x.Add (1.0, *v[i], y.Rows (i*k, (i+1)*k));
+
+            if (j < m || totalsteps >= maxsteps)
+              break;
+          }
+
+	const_cast<int&> (steps) = totalsteps;
+      }
+
+    catch (Exception & e)
+      {
+	e.Append ("in caught in BlockGMRESSolver::Mult\n");
+	throw;
+      }
+    catch (exception & e)
+      {
+	throw Exception(e.what() +
+			string ("\ncaught in BlockGMRESSolver::Mult\n"));
+      }
+  }
+
+  void BlockGMRESSolver :: Mult (const BaseVector & f, BaseVector & x) const
+  {
+    SolveSingleVector (*this, initialize, f, x);
+  }
+
+
   template class CGSolver<double>;
   template class CGSolver<Complex>;
   template class CGSolver<ComplexConjugate>;
   template class CGSolver<ComplexConjugate2>;
+  template class PipelinedCGSolver<double>;
+  template class PipelinedCGSolver<Complex>;
+  template class SStepCGSolver<double>;
+  template class SStepCGSolver<Complex>;
   template class BiCGStabSolver<double>;
   template class BiCGStabSolver<Complex>;
   template class BiCGStabSolver<ComplexConjugate>;
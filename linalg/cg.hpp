@@ -89,6 +89,8 @@ namespace ngla
     { return steps; }
     ///
     NGS_DLL_HEADER virtual void Mult (const BaseVector & v, BaseVector & prod) const = 0;
+    /// solves for the vectors one by one, such that x is the initial guess if initialize is not set
+    NGS_DLL_HEADER virtual void Mult (const MultiVector & f, MultiVector & x) const override;
     ///
     NGS_DLL_HEADER virtual AutoVector CreateVector() const;
 
@@ -125,6 +127,88 @@ namespace ngla
   };
 
 
+  /**
+     Pipelined conjugate gradient method (Ghysels, Vanroose).
+     The two inner products of an iteration are reduced together, the
+     reduction overlaps with the preconditioner and the matrix
+     application. Needs 9 vectors instead of 4, the recursively updated
+     residual may drift from the true one by rounding errors.
+  */
+  template <class IPTYPE>
+  class NGS_DLL_HEADER PipelinedCGSolver : public KrylovSpaceSolver
+  {
+  public:
+    typedef typename SCAL_TRAIT<IPTYPE>::SCAL SCAL;
+    ///
+    PipelinedCGSolver () 
+      : KrylovSpaceSolver () { ; }
+    ///
+    PipelinedCGSolver (const BaseMatrix & aa)
+      : KrylovSpaceSolver (aa) { ; }
+    ///
+    PipelinedCGSolver (const BaseMatrix & aa, const BaseMatrix & ac)
+      : KrylovSpaceSolver (aa, ac) { ; }
+
+    ///
+    virtual void Mult (const BaseVector & v, BaseVector & prod) const;
+  };
+
+
+  /**
+     s-step conjugate gradient method (Chronopoulos, Gear).
+     One outer step builds the basis z, (CA) z, ... (CA)^{s-1} z
+     without inner products, and computes all Gram matrices in a single
+     reduction. A step counts as s iterations. Directions which are
+     numerically dependent in the monomial basis are dropped, s up to
+     about 8 is useful.
+  */
+  template <class IPTYPE>
+  class NGS_DLL_HEADER SStepCGSolver : public KrylovSpaceSolver
+  {
+    int s = 4;
+  public:
+    typedef typename SCAL_TRAIT<IPTYPE>::SCAL SCAL;
+    ///
+    SStepCGSolver () 
+      : KrylovSpaceSolver () { ; }
+    ///
+    SStepCGSolver (const BaseMatrix & aa)
+      : KrylovSpaceSolver (aa) { ; }
+    ///
+    SStepCGSolver (const BaseMatrix & aa, const BaseMatrix & ac)
+      : KrylovSpaceSolver (aa, ac) { ; }
+
+    ///
+    void SetS (int as) { s = max2 (as, 1); }
+    ///
+    virtual void Mult (const BaseVector & v, BaseVector & prod) const;
+  };
+
+
+  /**
+     Block conjugate gradient method (O'Leary) for several right hand
+     sides at once. Search directions which become numerically
+     dependent are dropped. Every step applies the matrix and the
+     preconditioner to all vectors at once, but costs O(n k^2) for the
+     block inner products and updates. Real, sequential vectors only.
+  */
+  class NGS_DLL_HEADER BlockCGSolver : public KrylovSpaceSolver
+  {
+  public:
+    ///
+    BlockCGSolver (const BaseMatrix & aa)
+      : KrylovSpaceSolver (aa) { ; }
+    ///
+    BlockCGSolver (const BaseMatrix & aa, const BaseMatrix & ac)
+      : KrylovSpaceSolver (aa, ac) { ; }
+
+    /// solves A x[i] = f[i] for all vectors
+    virtual void Mult (const MultiVector & f, MultiVector & x) const override;
+    /// a block of one vector
+    virtual void Mult (const BaseVector & v, BaseVector & prod) const override;
+  };
+
+
   /// The BiCGStab solver
   template <class IPTYPE>
   class NGS_DLL_HEADER BiCGStabSolver : public KrylovSpaceSolver
@@ -201,6 +285,39 @@ namespace ngla
 
 
 
+  /**
+     Block GMRES for several right hand sides at once, left
+     preconditioned, restarted after restart block steps. One step
+     extends the Krylov space by a block of Num() vectors, maxsteps
+     counts block steps of all cycles. The residual of every right
+     hand side is checked separately.
+     Real, sequential vectors only.
+  */
+  class NGS_DLL_HEADER BlockGMRESSolver : public KrylovSpaceSolver
+  {
+    /// block steps per cycle, 0 for no restart
+    int restart = 30;
+  public:
+    ///
+    BlockGMRESSolver (const BaseMatrix & aa)
+      : KrylovSpaceSolver (aa) { ; }
+    ///
+    BlockGMRESSolver (const BaseMatrix & aa, const BaseMatrix & ac)
+      : KrylovSpaceSolver (aa, ac) { ; }
+
+    /// the Krylov basis and the Hessenberg matrix hold at most arestart blocks
+    void SetRestart (int arestart) { restart = arestart; }
+
+    /// solves A x[i] = f[i] for all vectors
+    virtual void Mult (const MultiVector & f, MultiVector & x) const override;
+    /// a block of one vector
+    virtual void Mult (const BaseVector & v, BaseVector & prod) const override;
+  };
+
+
+
+
+
   /// The quasi-minimal residual (QMR) solver
   template <class IPTYPE>
   class NGS_DLL_HEADER QMRSolver : public KrylovSpaceSolver
@@ -31,8 +31,10 @@ namespace ngla
 #include "paralleldofs.hpp"
 #include "basevector.hpp"
 #include "vvector.hpp"
+#include "multivector.hpp"
 #include "basematrix.hpp"
 #include "sparsematrix.hpp"
+#include "sellmatrix.hpp"
 #include "order.hpp"
 #include "sparsecholesky.hpp"
 #include "pardisoinverse.hpp"
@@ -49,6 +51,8 @@ namespace ngla
 #include "chebyshev.hpp"
 #include "eigen.hpp"
 #include "arnoldi.hpp"
+#include "lobpcg.hpp"
+#include "timestepping.hpp"
 
 #include "cuda_linalg.hpp"
 #endif
@@ -0,0 +1,230 @@
+/**************************************************************************/
+/* File:   lobpcg.cpp                                                     */
+/* Date:   Oct. 2026                                                      */
+/**************************************************************************/
+
+/*
+
+LOBPCG Eigenvalue Solver
+
+*/
+
+#include <la.hpp>
+
+namespace ngla
+{
+
+  /*
+    eigenvalues of the symmetric matrix a in ascending order,
+    the eigenvectors are the rows of evecs
+  */
+  static void SymmetricEigenSystem (FlatMatrix<double> a, FlatVector<double> lam,
+                                    FlatMatrix<double> evecs)
+  {
+#ifdef LAPACK
+    LapackEigenValuesSymmetric (a, lam, evecs);
+#else
+    CalcEigenSystem (a, lam, evecs);
+    int n = a.Height();
+    for (int i = 0; i < n; i++)
+      {
+        int imin = i;
+        for (int j = i+1; j < n; j++)
+          if (lam(j) < lam(imin)) imin = j;
+        Swap (lam(i), lam(imin));
+        for (int l = 0; l < n; l++)
+          Swap (evecs(i,l), evecs(imin,l));
+      }
+#endif
+  }
+
+
+  /*
+    Rayleigh-Ritz in the span of s: the k smallest eigenvalues, and the
+    coefficients of the M-orthonormal Ritz vectors.
+    Numerically dependent vectors of s are dropped.
+  */
+  static void RayleighRitz (const MultiVector & s, const MultiVector & as, const MultiVector & ms,
+                            size_t k, Vector<double> & lam, Matrix<double> & coefs)
+  {
+    size_t sz = s.Num();
+    Matrix<double> ga = s.InnerProduct (as);
+    Matrix<double> gm = s.InnerProduct (ms);
+    Matrix<double> h = 0.5 * (ga + Trans(ga));
+    ga = h;
+    h = 0.5 * (gm + Trans(gm));
+    gm = h;
+
+    Matrix<double> r(sz), t(sz);
+    int nkeep = TruncatedCholesky (gm, r, t);
+    if (nkeep < k)
+      throw Exception ("LOBPCG: search space has become degenerate, M not positive definite ?");
+
+    // columns of t span an M-orthonormal basis of span(s)
+    Matrix<double> tk(sz, nkeep);
+    for (size_t j = 0, c = 0; j < sz; j++)
+      if (t(j,j) != 0)
+        tk.Col(c++) = t.Col(j);
+
+    Matrix<double> hat = ga * tk;
+    Matrix<double> red = Trans(tk) * hat;
+    Vector<double> ev(nkeep);
+    Matrix<double> evecs(nkeep);
+    SymmetricEigenSystem (red, ev, evecs);
+
+    lam = ev.Range(0, k);
+    coefs.SetSize (sz, k);
+    coefs = tk * Trans (evecs.Rows(0, k));
+  }
+
+
+  void LOBPCG :: Project (MultiVector & v) const
+  {
+    if (!freedofs) return;
+    ParallelForRange (v.Size(), [&] (IntRange r)
+                      {
+                        for (size_t i : r)
+                          if (!freedofs->Test(i))
+                            for (size_t j = 0; j < v.Num(); j++)
+                              v[j](i) = 0.0;
+                      });
+  }
+
+  void LOBPCG :: Deflate (MultiVector & v) const
+  {
+    if (!defl) return;
+    Matrix<double> h = mdefl->InnerProduct (v);
+    v.Add (-1, *defl, h);
+  }
+
+
+  void LOBPCG :: SetDeflation (const MultiVector & y)
+  {
+    defl = make_shared<MultiVector> (y);
+    Project (*defl);
+    mdefl = make_shared<MultiVector> (y.Size(), y.Num());
+    m.Mult (*defl, *mdefl);
+
+    Matrix<double> g = defl->InnerProduct (*mdefl);
+    Matrix<double> r(y.Num()), t(y.Num());
+    TruncatedCholesky (g, r, t);
+    defl->MultRight (t);
+    mdefl->MultRight (t);
+  }
+
+
+  int LOBPCG :: Calc (MultiVector & x, Vector<double> & lam)
+  {
+    static Timer t("LOBPCG");
+    static Timer tpre("LOBPCG - preconditioner");
+    static Timer trr("LOBPCG - Rayleigh-Ritz");
+    RegionTimer reg(t);
+
+    if (a.IsComplex() || m.IsComplex())
+      throw Exception ("LOBPCG: real matrices only");
+
+    size_t n = x.Size(), k = x.Num();
+    lam.SetSize (k);
+    if (k == 0) return 0;
+
+    MultiVector ax(n, k), mx(n, k), r(n, k), hx(n, k);
+    // search directions of the active vectors
+    MultiVector p(n, 0), ap(n, 0), mp(n, 0);
+    Matrix<double> coefs;
+
+    Project (x);
+    Deflate (x);
+    a.Mult (x, ax);
+    m.Mult (x, mx);
+
+    RayleighRitz (x, ax, mx, k, lam, coefs);
+    hx = 0.0; hx.Add (1, x, coefs); x = hx;
+    hx = 0.0; hx.Add (1, ax, coefs); ax.Swap (hx);
+    hx = 0.0; hx.Add (1, mx, coefs); mx.Swap (hx);
+
+    Array<int> active;
+    for (steps = 0; ; steps++)
+      {
+        // r = A x - M x diag(lam)
+        Matrix<double> dlam(k);
+        dlam = 0.0;
+        for (size_t i = 0; i < k; i++)
+          dlam(i,i) = -lam(i);
+        r = ax;
+        r.Add (1, mx, dlam);
+        Project (r);
+
+        // soft locking: only vectors not yet converged get new directions
+        Vector<double> rnorm = r.Norms(), anorm = ax.Norms();
+        double maxres = 0;
+        active.SetSize0();
+        for (size_t i = 0; i < k; i++)
+          {
+            double res = (anorm(i) > 0) ? rnorm(i) / anorm(i) : 0;
+            maxres = max2 (maxres, res);
+            if (res > prec) active.Append (i);
+          }
+
+        if (printrates)
+          cout << IM(1) << "LOBPCG iteration " << steps << ", converged "
+               << k-active.Size() << "/" << k << ", max res = " << maxres << endl;
+        if (active.Size() == 0 || steps == maxsteps) break;
+
+        size_t na = active.Size();
+        MultiVector ra(n, na), w(n, na);
+        for (size_t j = 0; j < na; j++)
+          ra[j] = r[active[j]];
+
+        tpre.Start();
+        if (pre)
+          pre->Mult (ra, w);
+        else
+          w = ra;
+        tpre.Stop();
+        Project (w);
+        Deflate (w);
+
+        // M-orthogonal to x, improves the conditioning of the basis
+        Matrix<double> h = mx.InnerProduct (w);
+        w.Add (-1, x, h);
+
+        MultiVector aw(n, na), mw(n, na);
+        a.Mult (w, aw);
+        m.Mult (w, mw);
+
+        // Rayleigh-Ritz in span [x, w, p]
+        RegionTimer regrr(trr);
+        size_t np = p.Num(), sz = k+na+np;
+        MultiVector s(n, sz), as(n, sz), ms(n, sz);
+        IntRange rx(0, k), rw(k, k+na), rp(k+na, sz);
+        s.Range(rx) = x;   s.Range(rw) = w;   s.Range(rp) = p;
+        as.Range(rx) = ax; as.Range(rw) = aw; as.Range(rp) = ap;
+        ms.Range(rx) = mx; ms.Range(rw) = mw; ms.Range(rp) = mp;
+
+        RayleighRitz (s, as, ms, k, lam, coefs);
+
+        // new directions: the update of the active vectors in span [w, p]
+        Matrix<double> cp(sz-k, na);
+        for (size_t j = 0; j < na; j++)
+          cp.Col(j) = coefs.Col(active[j]).Range(k, sz);
+
+        MultiVector pn(n, na), apn(n, na), mpn(n, na);
+        auto swp = s.Range(IntRange(k, sz));
+        auto aswp = as.Range(IntRange(k, sz));
+        auto mswp = ms.Range(IntRange(k, sz));
+        pn = 0.0;  pn.Add (1, swp, cp);
+        apn = 0.0; apn.Add (1, aswp, cp);
+        mpn = 0.0; mpn.Add (1, mswp, cp);
+        p.Swap (pn);
+        ap.Swap (apn);
+        mp.Swap (mpn);
+
+        hx = 0.0; hx.Add (1, s, coefs); x = hx;
+        hx = 0.0; hx.Add (1, as, coefs); ax.Swap (hx);
+        hx = 0.0; hx.Add (1, ms, coefs); mx.Swap (hx);
+      }
+
+    return k - active.Size();
+  }
+
+}
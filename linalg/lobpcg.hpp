@@ -0,0 +1,68 @@
+#ifndef FILE_LOBPCG
+#define FILE_LOBPCG
+
+/**************************************************************************/
+/* File:   lobpcg.hpp                                                     */
+/* Date:   Oct. 2026                                                      */
+/**************************************************************************/
+
+namespace ngla
+{
+  /**
+     LOBPCG Eigenvalue Solver (Knyazev).
+
+     Computes the smallest eigenvalues of the generalized evp
+
+     A x = lam M x
+
+     A must be symmetric, M symmetric and positive definite.
+     The preconditioner approximates the inverse of A, a factorization
+     is not needed.
+
+     All vectors of the block are iterated together. Converged vectors
+     stay in the Rayleigh-Ritz basis, but get no new search directions
+     (soft locking). Known eigenvectors, or the kernel of A, can be
+     deflated, then the iteration runs in their M-orthogonal complement.
+
+     Real, sequential vectors only.
+   */
+  class NGS_DLL_HEADER LOBPCG
+  {
+    const BaseMatrix & a;
+    const BaseMatrix & m;
+    const BaseMatrix * pre;
+    shared_ptr<BitArray> freedofs;
+    shared_ptr<MultiVector> defl, mdefl;
+    double prec = 1e-8;
+    int maxsteps = 200;
+    bool printrates = false;
+    int steps = 0;
+
+    void Project (MultiVector & v) const;
+    void Deflate (MultiVector & v) const;
+
+  public:
+    LOBPCG (const BaseMatrix & aa, const BaseMatrix & am,
+            const BaseMatrix * apre = nullptr, shared_ptr<BitArray> afreedofs = nullptr)
+      : a(aa), m(am), pre(apre), freedofs(afreedofs) { ; }
+
+    /// relative residual  |A x - lam M x| / |A x|
+    void SetPrecision (double aprec) { prec = aprec; }
+    void SetMaxSteps (int amaxsteps) { maxsteps = amaxsteps; }
+    void SetPrintRates (bool aprintrates = true) { printrates = aprintrates; }
+
+    /// iterate in the M-orthogonal complement of the vectors y
+    void SetDeflation (const MultiVector & y);
+
+    /**
+       Computes x.Num() eigenpairs. x is the initial guess, and returns
+       the M-orthonormal eigenvectors. Returns the number of converged
+       eigenpairs.
+     */
+    int Calc (MultiVector & x, Vector<double> & lam);
+
+    int GetSteps () const { return steps; }
+  };
+}
+
+#endif
@@ -0,0 +1,323 @@
+/*********************************************************************/
+/* File:   multivector.cpp                                           */
+/* Date:   Oct. 2026                                                 */
+/*********************************************************************/
+
+/*
+   Sets of vectors in one block of memory
+*/
+
+#include <la.hpp>
+
+namespace ngla
+{
+
+  MultiVector & MultiVector :: operator= (double val)
+  {
+    ParallelForRange (size, [&] (IntRange r)
+                      {
+                        for (size_t i = 0; i < num; i++)
+                          (*this)[i].Range(r) = val;
+                      });
+    return *this;
+  }
+
+  MultiVector & MultiVector :: operator= (const MultiVector & v2)
+  {
+    if (v2.Size() != size || v2.Num() != num)
+      throw Exception ("MultiVector::operator=: sizes don't match");
+    ParallelForRange (size, [&] (IntRange r)
+                      {
+                        for (size_t i = 0; i < num; i++)
+                          (*this)[i].Range(r) = v2[i].Range(r);
+                      });
+    return *this;
+  }
+
+
+  Matrix<double> MultiVector :: InnerProduct (const MultiVector & v2) const
+  {
+    static Timer t("MultiVector::InnerProduct"); RegionTimer reg(t);
+    t.AddFlops (2*size*num*v2.Num());
+    if (v2.Size() != size)
+      throw Exception ("MultiVector::InnerProduct: sizes don't match");
+
+    // partial sums of row blocks, reduced afterwards
+    constexpr int ntasks = 16;
+    Matrix<double> parts[ntasks];
+    auto a = Trans (AsMatrix());
+    auto b = Trans (v2.AsMatrix());
+    ParallelJob ([&] (TaskInfo ti)
+                 {
+                   auto r = ngstd::Range(size).Split (ti.task_nr, ti.ntasks);
+                   Matrix<double> & part = parts[ti.task_nr];
+                   part.SetSize (num, v2.Num());
+                   part = 0.0;
+                   if (r.Size())
+                     AddABt (a.Cols(r), b.Cols(r), part);
+                 }, ntasks);
+
+    Matrix<double> sum(num, v2.Num());
+    sum = 0.0;
+    for (auto & part : parts)
+      sum += part;
+    return sum;
+  }
+
+
+  Vector<double> MultiVector :: InnerProducts (const MultiVector & v2) const
+  {
+    static Timer t("MultiVector::InnerProducts"); RegionTimer reg(t);
+    t.AddFlops (2*size*num);
+    if (v2.Size() != size || v2.Num() != num)
+      throw Exception ("MultiVector::InnerProducts: sizes don't match");
+
+    constexpr int ntasks = 16;
+    Vector<double> parts[ntasks];
+    ParallelJob ([&] (TaskInfo ti)
+                 {
+                   auto r = ngstd::Range(size).Split (ti.task_nr, ti.ntasks);
+                   Vector<double> & part = parts[ti.task_nr];
+                   part.SetSize (num);
+                   for (size_t i = 0; i < num; i++)
+                     part(i) = ngbla::InnerProduct ((*this)[i].Range(r), v2[i].Range(r));
+                 }, ntasks);
+
+    Vector<double> sum(num);
+    sum = 0.0;
+    for (auto & part : parts)
+      sum += part;
+    return sum;
+  }
+
+
+  void MultiVector :: Add (double s, const MultiVector & v2, SliceMatrix<double> mat)
+  {
+    static Timer t("MultiVector::Add"); RegionTimer reg(t);
+    t.AddFlops (2*size*num*v2.Num());
+    if (v2.Size() != size || mat.Height() != v2.Num() || mat.Width() != num)
+      throw Exception ("MultiVector::Add: sizes don't match");
+
+    Matrix<double> smat = s * Trans(mat);
+    auto a = Trans (v2.AsMatrix());
+    auto c = Trans (AsMatrix());
+    ParallelForRange (size, [&] (IntRange r)
+      {
+        // Trans(this) += Trans(mat) * Trans(v2), in blocks staying in cache
+        constexpr size_t bs = 256;
+        Matrix<double> hc(num, bs);
+        for (size_t first = r.First(); first < r.Next(); first += bs)
+          {
+            IntRange rb(first, min2(first+bs, size_t(r.Next())));
+            auto hcb = hc.Cols(0, rb.Size());
+            MultMatMat (smat, a.Cols(rb), hcb);
+            c.Cols(rb) += hcb;
+          }
+      });
+  }
+
+
+  void MultiVector :: MultRight (SliceMatrix<double> mat)
+  {
+    static Timer t("MultiVector::MultRight"); RegionTimer reg(t);
+    t.AddFlops (2*size*num*num);
+    if (mat.Height() != num || mat.Width() != num)
+      throw Exception ("MultiVector::MultRight: sizes don't match");
+
+    Matrix<double> tmat = Trans(mat);
+    auto c = Trans (AsMatrix());
+    ParallelForRange (size, [&] (IntRange r)
+      {
+        constexpr size_t bs = 256;
+        Matrix<double> hc(num, bs);
+        for (size_t first = r.First(); first < r.Next(); first += bs)
+          {
+            IntRange rb(first, min2(first+bs, size_t(r.Next())));
+            auto hcb = hc.Cols(0, rb.Size());
+            MultMatMat (tmat, c.Cols(rb), hcb);
+            c.Cols(rb) = hcb;
+          }
+      });
+  }
+
+
+  Vector<double> MultiVector :: Norms () const
+  {
+    Vector<double> norms(num);
+    ParallelFor (num, [&] (size_t i)
+                 { norms(i) = L2Norm ((*this)[i]); });
+    return norms;
+  }
+
+
+  int MultiVector :: Orthogonalize (SliceMatrix<double> r)
+  {
+    static Timer t("MultiVector::Orthogonalize"); RegionTimer reg(t);
+    if (r.Height() != num || r.Width() != num)
+      throw Exception ("MultiVector::Orthogonalize: sizes don't match");
+
+    Matrix<double> rfac(num), tinv(num), hr(num);
+    r = Identity(num);
+
+    // the second pass removes the loss of orthogonality of the first one
+    int nkeep = 0;
+    for (int pass = 0; pass < 2; pass++)
+      {
+        Matrix<double> g = InnerProduct (*this);
+        nkeep = TruncatedCholesky (g, rfac, tinv);
+        MultRight (tinv);
+        hr = rfac * r;
+        r = hr;
+      }
+    return nkeep;
+  }
+
+
+  /*
+    Householder QR of a, a is overwritten by the orthonormal factor.
+    Diagonal entries of r are non-negative.
+  */
+  static void QRFactor (SliceMatrix<double,ColMajor> a, SliceMatrix<double> r)
+  {
+    size_t m = a.Height(), n = a.Width();
+    Matrix<double,ColMajor> v(m, n);
+    Vector<double> beta(n);
+    r = 0.0;
+
+    for (size_t j = 0; j < n; j++)
+      {
+        IntRange rj(j, m);
+        auto vj = v.Col(j).Range(rj);
+        vj = a.Col(j).Range(rj);
+        double alpha = -L2Norm (vj);
+        if (vj(0) < 0) alpha = -alpha;
+        vj(0) -= alpha;
+        double vv = L2Norm2 (vj);
+        beta(j) = (vv > 0) ? 2/vv : 0;
+
+        for (size_t l = j+1; l < n; l++)
+          {
+            auto al = a.Col(l).Range(rj);
+            al -= (beta(j) * InnerProduct (vj, al)) * vj;
+          }
+        r(j,j) = alpha;
+        for (size_t l = j+1; l < n; l++)
+          r(j,l) = a(j,l);
+      }
+
+    // Q = H_0 ... H_{n-1} [I;0]
+    a = 0.0;
+    for (size_t j = 0; j < n; j++)
+      a(j,j) = 1;
+    for (size_t j = n; j-- > 0; )
+      {
+        IntRange rj(j, m);
+        auto vj = v.Col(j).Range(rj);
+        for (size_t l = j; l < n; l++)
+          {
+            auto al = a.Col(l).Range(rj);
+            al -= (beta(j) * InnerProduct (vj, al)) * vj;
+          }
+      }
+
+    for (size_t j = 0; j < n; j++)
+      if (r(j,j) < 0)
+        {
+          r.Row(j) *= -1;
+          a.Col(j) *= -1;
+        }
+  }
+
+
+  void MultiVector :: OrthogonalizeTSQR (SliceMatrix<double> r)
+  {
+    static Timer t("MultiVector::OrthogonalizeTSQR"); RegionTimer reg(t);
+    if (r.Height() != num || r.Width() != num)
+      throw Exception ("MultiVector::OrthogonalizeTSQR: sizes don't match");
+    if (num == 0) return;
+    if (size < num)
+      throw Exception ("MultiVector::OrthogonalizeTSQR: more vectors than entries");
+
+    // every row block must have at least num rows
+    int ntasks = min2 (size_t(16), size / num);
+    Matrix<double,ColMajor> rs(ntasks*num, num);
+    Matrix<double> rloc[16];
+
+    ParallelJob ([&] (TaskInfo ti)
+                 {
+                   auto rows = ngstd::Range(size).Split (ti.task_nr, ti.ntasks);
+                   rloc[ti.task_nr].SetSize (num, num);
+                   QRFactor (AsMatrix().Rows(rows), rloc[ti.task_nr]);
+                 }, ntasks);
+
+    for (int i = 0; i < ntasks; i++)
+      rs.Rows(i*num, (i+1)*num) = rloc[i];
+    QRFactor (rs, r);
+
+    // block i of Q = Q_i * (block i of the Q-factor of the stacked r's)
+    auto c = Trans (AsMatrix());
+    ParallelJob ([&] (TaskInfo ti)
+                 {
+                   auto rows = ngstd::Range(size).Split (ti.task_nr, ti.ntasks);
+                   Matrix<double> tmat = Trans (rs.Rows(ti.task_nr*num, (ti.task_nr+1)*num));
+                   constexpr size_t bs = 256;
+                   Matrix<double> hc(num, bs);
+                   for (size_t first = rows.First(); first < rows.Next(); first += bs)
+                     {
+                       IntRange rb(first, min2(first+bs, size_t(rows.Next())));
+                       auto hcb = hc.Cols(0, rb.Size());
+                       MultMatMat (tmat, c.Cols(rb), hcb);
+                       c.Cols(rb) = hcb;
+                     }
+                 }, ntasks);
+  }
+
+
+  int TruncatedCholesky (FlatMatrix<double> g, FlatMatrix<double> r,
+                         FlatMatrix<double> t)
+  {
+    int k = g.Height();
+    ArrayMem<bool,16> keep(k);
+    int nkeep = 0;
+    r = 0.0;
+    t = 0.0;
+
+    for (int j = 0; j < k; j++)
+      {
+        for (int i = 0; i < j; i++)
+          if (keep[i])
+            {
+              double sum = g(i,j);
+              for (int l = 0; l < i; l++)
+                sum -= r(l,i) * r(l,j);
+              r(i,j) = sum / r(i,i);
+            }
+        double d = g(j,j);
+        for (int l = 0; l < j; l++)
+          d -= r(l,j) * r(l,j);
+
+        keep[j] = d > 1e-12 * g(j,j);
+        if (keep[j])
+          {
+            r(j,j) = sqrt (d);
+            nkeep++;
+          }
+      }
+
+    for (int j = 0; j < k; j++)
+      if (keep[j])
+        {
+          t(j,j) = 1.0 / r(j,j);
+          for (int i = j-1; i >= 0; i--)
+            if (keep[i])
+              {
+                double sum = 0;
+                for (int l = i+1; l <= j; l++)
+                  sum += r(i,l) * t(l,j);
+                t(i,j) = -sum / r(i,i);
+              }
+        }
+    return nkeep;
+  }
+
+}
@@ -0,0 +1,131 @@
+#ifndef FILE_NGS_MULTIVECTOR
+#define FILE_NGS_MULTIVECTOR
+
+/**************************************************************************/
+/* File:   multivector.hpp                                                */
+/* Date:   Oct. 2026                                                      */
+/**************************************************************************/
+
+namespace ngla
+{
+
+  /**
+     A set of real vectors of the same size in one block of memory.
+
+     Vector i is column i of a column-major Size() x Num() matrix.
+     Columns start at SIMD-aligned addresses, the column distance is
+     Size() rounded up to the SIMD width.
+     Operations with several vectors (matrix times multi-vector, block
+     inner products) read each matrix entry or each vector entry once
+     for all vectors.
+
+     Range(r) is a view to some of the vectors, copies allocate new
+     memory.
+
+     Sequential vectors only.
+   */
+  class NGS_DLL_HEADER MultiVector
+  {
+    size_t size, num, dist;
+    Array<SIMD<double>> mem;
+    double * data;
+
+    MultiVector (size_t asize, size_t anum, size_t adist, double * adata)
+      : size(asize), num(anum), dist(adist), data(adata) { ; }
+
+  public:
+    MultiVector (size_t asize, size_t anum)
+      : size(asize), num(anum),
+        dist((asize+SIMD<double>::Size()-1) / SIMD<double>::Size() * SIMD<double>::Size()),
+        mem(dist*anum / SIMD<double>::Size())
+    {
+      data = (double*)(mem+0);
+    }
+
+    MultiVector (const MultiVector & v2)
+      : MultiVector (v2.Size(), v2.Num())
+    {
+      *this = v2;
+    }
+
+    MultiVector (MultiVector && v2) = default;
+
+    /// length of the vectors
+    size_t Size() const { return size; }
+    /// number of vectors
+    size_t Num() const { return num; }
+
+    /// vector i
+    FlatVector<double> operator[] (size_t i) const
+    { return FlatVector<double> (size, data+i*dist); }
+
+    /// vector i as BaseVector
+    VFlatVector<double> Vec (size_t i) const
+    { return VFlatVector<double> (size, data+i*dist); }
+
+    /// the vectors as columns
+    SliceMatrix<double,ColMajor> AsMatrix () const
+    { return SliceMatrix<double,ColMajor> (size, num, dist, data); }
+
+    /// the vectors r, sharing the memory
+    MultiVector Range (IntRange r) const
+    { return MultiVector (size, r.Size(), dist, data+r.First()*dist); }
+
+    MultiVector & operator= (double val);
+    MultiVector & operator= (const MultiVector & v2);
+
+    void Swap (MultiVector & v2)
+    {
+      ngstd::Swap (size, v2.size);
+      ngstd::Swap (num, v2.num);
+      ngstd::Swap (dist, v2.dist);
+      mem.Swap (v2.mem);
+      ngstd::Swap (data, v2.data);
+    }
+
+    /// result(i,j) = < this[i], v2[j] >
+    Matrix<double> InnerProduct (const MultiVector & v2) const;
+
+    /// result(i) = < this[i], v2[i] >
+    Vector<double> InnerProducts (const MultiVector & v2) const;
+
+    /// this += s * v2 * mat,  mat is v2.Num() x Num()
+    void Add (double s, const MultiVector & v2, SliceMatrix<double> mat);
+
+    /// this = this * mat,  mat is Num() x Num()
+    void MultRight (SliceMatrix<double> mat);
+
+    /// the L2 norms of all vectors
+    Vector<double> Norms () const;
+
+    /**
+       this = Q r with orthonormal Q and upper triangular r, by
+       Cholesky-QR applied twice (two block inner products).
+       Vectors numerically dependent on the previous ones become zero,
+       their rows in r are zero. Returns the number of independent
+       vectors.
+     */
+    int Orthogonalize (SliceMatrix<double> r);
+
+    /**
+       this = Q r by tall-skinny QR: Householder QR of row blocks in
+       parallel, and of the stacked triangular factors. Accurate also
+       for ill-conditioned vectors, no vectors are dropped.
+     */
+    void OrthogonalizeTSQR (SliceMatrix<double> r);
+  };
+
+
+  /**
+     Cholesky factorization g = r^T r, which drops columns numerically
+     dependent on the previous ones. Rows of dropped columns are zero in r,
+     rows and columns of dropped columns are zero in t = r^{-1}, such
+     that t^T g t is the identity up to zeros for the dropped columns.
+     Returns the number of kept columns.
+  */
+  NGS_DLL_HEADER int TruncatedCholesky (FlatMatrix<double> g, FlatMatrix<double> r,
+                                        FlatMatrix<double> t);
+
+}
+
+#endif
@@ -574,6 +574,45 @@ namespace ngla
     static Timer reorder_timer("MinimumDegreeOrdering::Order");
     RegionTimer reg(reorder_timer);
 
+    OrderImpl ([&] ()
+               {
+                 // find new master vertex
+                 int minj;
+                 do
+                   {
+                     minj = priqueue.MinDegree();
+                     priqueue.Invalidate(minj); 
+                     if (vertices[minj].Master() != minj)
+                       priqueue.SetDegree (minj, n);
+                   }
+                 while (vertices[minj].Master() != minj);
+                 return minj;
+               });
+  }
+
+
+  void MinimumDegreeOrdering :: Order (FlatArray<int> elimination_order)
+  {
+    static Timer reorder_timer("MinimumDegreeOrdering::Order - given order");
+    RegionTimer reg(reorder_timer);
+
+    // vertices merged into a supernode are eliminated together 
+    // with their master, which does not change the fill
+    size_t pos = 0;
+    OrderImpl ([&] ()
+               {
+                 while (vertices[elimination_order[pos]].Eliminated())
+                   pos++;
+                 int minj = vertices[elimination_order[pos]].Master();
+                 priqueue.Invalidate(minj);
+                 return minj;
+               });
+  }
+
+
+  template <typename TFUNC>
+  void MinimumDegreeOrdering :: OrderImpl (TFUNC find_master)
+  {
     cout << IM(4) << "start order" << endl;
 
     if (task_manager) task_manager -> StopWorkers();
@@ -623,16 +662,7 @@ namespace ngla
 
 	else
 	  {
-	    // find new master vertex
-	    do
-	      {
-		minj = priqueue.MinDegree();
-		priqueue.Invalidate(minj); 
-		if (vertices[minj].Master() != minj)
-		  priqueue.SetDegree (minj, n);
-	      }
-	    while (vertices[minj].Master() != minj);
-
+	    minj = find_master();
 	    blocknr[i] = i;
 	    EliminateMasterVertex (minj);
 	  }
@@ -796,4 +826,226 @@ namespace ngla
     list[nr].degree = 0;
   }
 
+
+
+
+
+  /*
+    Nested dissection 
+
+    Subgraphs of one level of the separator tree are disjoint, 
+    they are bisected in parallel. part[v] is the subgraph of v 
+    in the current level, level[v] is only accessed by the task
+    owning v.
+  */
+  
+  NestedDissection :: NestedDissection (const Table<int> & graph,
+                                        const BitArray & used,
+                                        int leafsize)
+  {
+    static Timer t("NestedDissection"); RegionTimer reg(t);
+    
+    size_t n = graph.Size();
+    leafsize = max2 (leafsize, 2);
+
+    struct SubGraph
+    {
+      Array<int> verts;
+      int first;     // position of first vertex in order
+      int parent;    // separator tree node
+    };
+
+    struct Split
+    {
+      Array<int> sep;
+      Array<int> parts[2];
+    };
+    
+    Array<int> part(n), level(n);
+    
+    Array<SubGraph> current, next;
+    {
+      SubGraph all;
+      for (size_t i = 0; i < n; i++)
+        if (used.Test(i)) all.verts.Append(i);
+      all.first = 0;
+      all.parent = -1;
+      order.SetSize (all.verts.Size());
+      if (all.verts.Size())
+        current.Append (move(all));
+    }
+    part = -1;
+    for (int i : Range(current))
+      for (int v : current[i].verts)
+        part[v] = i;
+    
+    while (current.Size())
+      {
+        Array<Split> splits(current.Size());
+
+        ParallelFor (current.Size(), [&] (size_t nr)
+          {
+            FlatArray<int> verts = current[nr].verts;
+            Split & split = splits[nr];
+            int size = verts.Size();
+            
+            if (size <= leafsize)
+              {
+                split.sep = verts;
+                return;
+              }
+
+            // level structure from pseudo-peripheral vertex
+            Array<int> queue(size);
+            Array<int> firstinlevel;
+            auto bfs = [&] (int root)
+              {
+                for (int v : verts) level[v] = -1;
+                firstinlevel.SetSize0();
+                level[root] = 0;
+                queue[0] = root;
+                int cnt = 1;
+                for (int i = 0; i < cnt; i++)
+                  {
+                    int v = queue[i];
+                    if (level[v] == int(firstinlevel.Size()))
+                      firstinlevel.Append (i);
+                    for (int w : graph[v])
+                      if (part[w] == int(nr) && level[w] == -1)
+                        {
+                          level[w] = level[v]+1;
+                          queue[cnt++] = w;
+                        }
+                  }
+                firstinlevel.Append (cnt);
+                return cnt;
+              };
+            
+            auto degree = [&] (int v)
+              {
+                int deg = 0;
+                for (int w : graph[v])
+                  if (part[w] == int(nr)) deg++;
+                return deg;
+              };
+            
+            int root = verts[0];
+            int reached = bfs (root);
+            int nlevels = firstinlevel.Size()-1;
+            for (int it = 0; it < 5 && reached == size; it++)
+              {
+                // minimal degree vertex in last level
+                int cand = queue[firstinlevel[nlevels-1]];
+                for (int j : Range(firstinlevel[nlevels-1], firstinlevel[nlevels]))
+                  if (degree(queue[j]) < degree(cand))
+                    cand = queue[j];
+                bfs (cand);
+                int newnlevels = firstinlevel.Size()-1;
+                if (newnlevels <= nlevels)
+                  {
+                    bfs (root);
+                    break;
+                  }
+                root = cand;
+                nlevels = newnlevels;
+              }
+
+            if (reached < size)
+              {
+                // not connected: component vs. rest, empty separator 
+                for (int j = 0; j < reached; j++)
+                  split.parts[0].Append (queue[j]);
+                for (int v : verts)
+                  if (level[v] == -1)
+                    split.parts[1].Append (v);
+                return;
+              }
+            
+            if (nlevels < 3)
+              {
+                // too dense for bisection
+                split.sep = verts;
+                return;
+              }
+
+            // separating level with about half of the vertices below
+            int seplevel = 1;
+            while (seplevel < nlevels-2 && firstinlevel[seplevel+1] < size/2)
+              seplevel++;
+
+            // level[v] < 0 .. part 0, = 0 .. separator, > 0 .. part 1
+            for (int v : verts)
+              level[v] -= seplevel;
+
+            auto has_neighbour = [&] (int v, int side)
+              {
+                for (int w : graph[v])
+                  if (part[w] == int(nr) && 
+                      ( (side == 0 && level[w] < 0) || (side == 1 && level[w] > 0) ))
+                    return true;
+                return false;
+              };
+
+            // thin the separator
+            for (int j : Range(firstinlevel[seplevel], firstinlevel[seplevel+1]))
+              {
+                int v = queue[j];
+                if (!has_neighbour (v, 1))
+                  level[v] = -1;
+                else if (!has_neighbour (v, 0))
+                  level[v] = 1;
+              }
+            
+            for (int j : Range(size))
+              {
+                int v = queue[j];
+                if (level[v] == 0) split.sep.Append (v);
+                else split.parts[level[v] < 0 ? 0 : 1].Append(v);
+              }
+          });
+
+        // create tree nodes, the separator goes last
+        next.SetSize0();
+        for (int nr : Range(current))
+          {
+            auto & sg = current[nr];
+            auto & split = splits[nr];
+            
+            int first = sg.first + sg.verts.Size() - split.sep.Size();
+            order.Range (first, first+split.sep.Size()) = split.sep;
+            for (int v : split.sep)
+              part[v] = -1;
+
+            int node = -1;
+            if (split.sep.Size())
+              {
+                node = nodes.Size();
+                nodes.Append (IntRange (first, first+split.sep.Size()));
+                parent.Append (sg.parent);
+              }
+            else
+              node = sg.parent;
+
+            int firstpart = sg.first;
+            for (auto & p : split.parts)
+              if (p.Size())
+                {
+                  SubGraph child;
+                  child.first = firstpart;
+                  child.parent = node;
+                  firstpart += p.Size();
+                  child.verts = move(p);
+                  next.Append (move(child));
+                }
+          }
+
+        ParallelFor (next.Size(), [&] (size_t i)
+                     {
+                       for (int v : next[i].verts)
+                         part[v] = i;
+                     });
+        current.Swap (next);
+      }
+  }
+
 }
@@ -152,6 +152,8 @@ namespace ngla
     void EliminateSlaveVertex (int v);
     ///
     void Order();
+    /// eliminate in the given order, detect supernodes on the fly
+    void Order (FlatArray<int> elimination_order);
     /// 
     ~MinimumDegreeOrdering();
 
@@ -196,6 +198,38 @@ namespace ngla
     }
 
     void SetMaster (int master, int slave);
+
+  private:
+    template <typename TFUNC>
+    void OrderImpl (TFUNC find_master);
+  };
+
+
+
+  /*
+    Nested dissection ordering by recursive graph bisection.
+
+    Separators are taken from level structures rooted at 
+    pseudo-peripheral vertices. Both halves of a subgraph are 
+    numbered before its separator, the recursion tree 
+    (the separator tree) is returned as well. Independent 
+    subgraphs of one tree level are split in parallel.
+  */
+  class NestedDissection
+  {
+  public:
+    /// elimination order, unused vertices are skipped
+    Array<int> order;
+    /// separator tree: vertices of node i are order[nodes[i]]
+    Array<IntRange> nodes;
+    /// parent node in separator tree, -1 for roots
+    Array<int> parent;
+
+    /// graph is symmetric adjacency, vertices with used[i]=false are ignored
+    NestedDissection (const Table<int> & graph, const BitArray & used,
+                      int leafsize = 64);
+
+    int NumNodes () const { return nodes.Size(); }
   };
 
 
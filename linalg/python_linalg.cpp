@@ -2,9 +2,64 @@
 #include <la.hpp>
 #include <parallelngs.hpp>
 #include "../ngstd/python_ngstd.hpp"
+#include <pybind11/numpy.h>
 using namespace ngla;
 
 
+/*
+  The memory of a contiguous buffer with entries of type T, not copied.
+  Integer types must match in size only.
+*/
+template <typename T>
+FlatArray<T> BufferAsArray (py::buffer b, string name)
+{
+  py::buffer_info info = b.request(true);
+  string format = info.format;
+  while (format.size() && string("@=<").find(format[0]) != string::npos)
+    format.erase(0,1);
+  bool match = (info.itemsize == sizeof(T)) &&
+    (is_integral<T>::value
+     ? format.size() == 1 && string("bBhHiIlLqQnN").find(format[0]) != string::npos
+     : format == py::format_descriptor<T>::format());
+  if (!match)
+    throw Exception (name + ": expected " + ToString(8*sizeof(T)) + " bit entries of format "
+                     + py::format_descriptor<T>::format() + ", got " + info.format
+                     + " (convert with numpy.astype to avoid a copy)");
+
+  size_t stride = info.itemsize;
+  for (int d = info.ndim-1; d >= 0; d--)
+    {
+      if (info.shape[d] > 1 && info.strides[d] != stride)
+        throw Exception (name + ": buffer must be contiguous");
+      stride *= info.shape[d];
+    }
+  return FlatArray<T> (info.size, (T*)info.ptr);
+}
+
+/// right hand side of a time stepper: None, a constant vector, or a function rhs(t, vec)
+static TimeStepper::TRHS MakeTimeStepperRHS (py::object rhs)
+{
+  if (rhs.is_none()) return nullptr;
+  if (py::isinstance<BaseVector> (rhs))
+    {
+      auto vec = rhs.cast<shared_ptr<BaseVector>>();
+      return [vec] (double t, BaseVector & f) { f = *vec; };
+    }
+  return [rhs] (double t, BaseVector & f)
+    {
+      py::gil_scoped_acquire gil;
+      rhs (t, py::cast (f, py::return_value_policy::reference));
+    };
+}
+
+/// numpy array on memory owned by base, base is kept alive by the array
+template <typename T>
+py::array NumPyView (std::vector<size_t> shape, T * data, py::handle base)
+{
+  return py::array_t<T> (shape, data, base);
+}
+
+
 template<typename T>
 void ExportSparseMatrix(py::module m)
 {
@@ -26,43 +81,60 @@ void ExportSparseMatrix(py::module m)
            self(row,col) = value;
          })
 
-    .def("COO", [] (SparseMatrix<T> * sp) -> py::object
+    .def("COO", [] (py::object self) -> py::object
          {
-           size_t nze = sp->NZE();
-           Array<int> ri(nze), ci(nze);
-           Vector<T> vals(nze);
-           for (size_t i = 0, ii = 0; i < sp->Height(); i++)
-             {
-               FlatArray<int> ind = sp->GetRowIndices(i);
-               FlatVector<T> rv = sp->GetRowValues(i);
-               for (int j = 0; j < ind.Size(); j++, ii++)
-                 {
-                   ri[ii] = i;
-                   ci[ii] = ind[j];
-                   vals[ii] = rv[j];
-                 }
-             }
-           /*
-           t2.Start();
-           // still copies, we don't understand why
-           py::object pyri = py::cast(std::move(ri));
-           py::object pyci = py::cast(std::move(ci));
-           py::object pyvals = py::cast(std::move(vals));
-           t2.Stop();
-           return py::make_tuple (pyri, pyci, pyvals);
-           */
-           // moves the arrays
-           return py::make_tuple (move(ri), move(ci), move(vals));
-         })
+           auto & sp = self.cast<SparseMatrix<T>&>();
+           size_t nze = sp.NZE();
+           py::array_t<int> ri(nze);
+           int * pri = ri.mutable_data();
+           FlatArray<size_t> first = sp.GetFirstArray();
+           ParallelFor (sp.Height(), [&] (size_t i)
+                        {
+                          for (size_t j = first[i]; j < first[i+1]; j++)
+                            pri[j] = i;
+                        });
+           auto csr = self.attr("CSR")().cast<py::tuple>();
+           return py::make_tuple (ri, csr[1], csr[0]);
+         },
+         "row indices, column indices and values as numpy arrays,\n"
+         "column indices and values share the memory of the matrix")
     
-    .def("CSR", [] (shared_ptr<SparseMatrix<T>> sp) -> py::object
+    .def("CSR", [] (py::object self) -> py::object
          {
-           FlatArray<int> colind(sp->NZE(), sp->GetRowIndices(0).Addr(0));
-           FlatVector<T> values(sp->NZE(), sp->GetRowValues(0).Addr(0));
-           FlatArray<size_t> first = sp->GetFirstArray();
-           return py::make_tuple (values, colind, first); 
+           typedef typename mat_traits<T>::TSCAL TSCAL;
+           auto & sp = self.cast<SparseMatrix<T>&>();
+           size_t nze = sp.NZE();
+           std::vector<size_t> valshape { nze };
+           if (mat_traits<T>::HEIGHT > 1 || mat_traits<T>::WIDTH > 1)
+             valshape = { nze, size_t(mat_traits<T>::HEIGHT), size_t(mat_traits<T>::WIDTH) };
+           FlatArray<size_t> first = sp.GetFirstArray();
+           auto values = NumPyView<TSCAL> (valshape, (TSCAL*)sp.AsVector().Memory(), self);
+           auto colind = NumPyView<int> ({ nze }, sp.GetRowIndices(0).Addr(0), self);
+           auto indptr = NumPyView<size_t> ({ first.Size() }, first.Addr(0), self);
+           return py::make_tuple (values, colind, indptr);
          },
-         py::return_value_policy::reference_internal)
+         "values, column indices and row pointers as numpy arrays sharing the\n"
+         "memory of the matrix, e.g. for scipy.sparse.csr_matrix(mat.CSR())")
+
+    .def_static("CreateFromCSR",
+                [] (py::buffer indptr, py::buffer indices, py::buffer data, int width)
+                {
+                  typedef typename mat_traits<T>::TSCAL TSCAL;
+                  auto first = BufferAsArray<size_t> (indptr, "indptr");
+                  auto cols = BufferAsArray<int> (indices, "indices");
+                  auto vals = BufferAsArray<TSCAL> (data, "data");
+                  size_t entrysize = mat_traits<T>::HEIGHT * mat_traits<T>::WIDTH;
+                  if (vals.Size() != entrysize * cols.Size())
+                    throw Exception ("CreateFromCSR: number of values does not match the column indices");
+                  if (width < 0) width = int(first.Size())-1;
+                  FlatVector<T> tvals (cols.Size(), (T*)vals.Addr(0));
+                  return make_shared<SparseMatrix<T>> (first, cols, tvals, width);
+                },
+                py::arg("indptr"), py::arg("indices"), py::arg("data"), py::arg("width") = -1,
+                py::keep_alive<0,1>(), py::keep_alive<0,2>(), py::keep_alive<0,3>(),
+                "sparse matrix on the given CSR arrays without copying them, they are kept alive\n"
+                "by the matrix. Needs 64 bit row pointers, 32 bit column indices sorted in every row,\n"
+                "and values of the matrix type. width=-1 gives a square matrix.")
     
     .def_static("CreateFromCOO",
                 [] (py::list indi, py::list indj, py::list values, size_t h, size_t w)
@@ -150,8 +222,30 @@ void NGS_DLL_HEADER ExportNgla(py::module &m) {
           py::arg("pardofs"), "complex"_a=false, "entrysize"_a=1);
     
   py::class_<BaseVector, shared_ptr<BaseVector>>(m, "BaseVector",
+        py::buffer_protocol(),
         py::dynamic_attr() // add dynamic attributes
       )
+    .def_buffer([] (BaseVector & self) -> py::buffer_info
+                {
+                  if (self.IsComplex())
+                    {
+                      FlatVector<Complex> fv = self.FVComplex();
+                      return py::buffer_info (fv.Data(), sizeof(Complex), py::format_descriptor<Complex>::format(),
+                                              1, { fv.Size() }, { sizeof(Complex) });
+                    }
+                  FlatVector<double> fv = self.FVDouble();
+                  return py::buffer_info (fv.Data(), sizeof(double), py::format_descriptor<double>::format(),
+                                          1, { fv.Size() }, { sizeof(double) });
+                })
+    .def("NumPy", [] (py::object self)
+         {
+           auto & v = self.cast<BaseVector&>();
+           auto numpy = py::module::import("numpy");
+           auto dtype = v.IsComplex() ? py::detail::npy_format_descriptor<Complex>::dtype()
+             : py::detail::npy_format_descriptor<double>::dtype();
+           return numpy.attr("frombuffer")(self, dtype);
+         },
+         "numpy array on the memory of the vector, the vector is kept alive by the array")
     .def(py::init([] (size_t s, bool is_complex, int es) -> shared_ptr<BaseVector>
                   { return CreateBaseVector(s,is_complex, es); }),
                   "size"_a, "complex"_a=false, "entrysize"_a=1)
@@ -382,6 +476,47 @@ void NGS_DLL_HEADER ExportNgla(py::module &m) {
                             "number of blocks in BlockVector")
     ;
 
+  py::class_<MultiVector, shared_ptr<MultiVector>> (m, "MultiVector",
+                                                   "set of real vectors of the same size in one block of memory")
+    .def(py::init<size_t,size_t>(), py::arg("size"), py::arg("num"))
+    .def("__len__", &MultiVector::Num)
+    .def_property_readonly("size", &MultiVector::Size, "length of the vectors")
+    .def("__getitem__", [](MultiVector & self, size_t i) -> shared_ptr<BaseVector>
+         {
+           if (i >= self.Num()) throw py::index_error();
+           return make_shared<VFlatVector<double>> (self.Size(), self[i].Data());
+         }, py::keep_alive<0,1>())
+    .def("__setitem__", [](MultiVector & self, size_t i, BaseVector & v)
+         {
+           if (i >= self.Num()) throw py::index_error();
+           if (v.IsComplex() || v.EntrySize() != 1 || v.Size() != self.Size())
+             throw Exception ("MultiVector: needs a real vector of size " + ToString(self.Size()));
+           self[i] = v.FV<double>();
+         })
+    .def("Assign", [](MultiVector & self, MultiVector & v2) { self = v2; },
+         py::call_guard<py::gil_scoped_release>())
+    .def("InnerProduct", [](MultiVector & self, MultiVector & v2) { return self.InnerProduct(v2); },
+         py::call_guard<py::gil_scoped_release>(),
+         "matrix of inner products of all vectors with all vectors of v2")
+    .def("Add", [](MultiVector & self, double s, MultiVector & v2, Matrix<double> mat)
+         { self.Add (s, v2, mat); },
+         py::arg("s"), py::arg("v2"), py::arg("mat"),
+         py::call_guard<py::gil_scoped_release>(),
+         "self += s * v2 * mat")
+    .def("Norms", [](MultiVector & self) { return self.Norms(); })
+    .def("Orthogonalize", [](MultiVector & self, bool tsqr)
+         {
+           Matrix<double> r(self.Num());
+           if (tsqr)
+             self.OrthogonalizeTSQR (r);
+           else
+             self.Orthogonalize (r);
+           return r;
+         },
+         py::arg("tsqr")=false, py::call_guard<py::gil_scoped_release>(),
+         "orthonormalize the vectors by Cholesky-QR, or tall-skinny QR, returns the triangular factor R")
+    ;
+
 
 
 
@@ -560,6 +695,7 @@ void NGS_DLL_HEADER ExportNgla(py::module &m) {
 
     .def("Mult",         [](BaseMatrix &m, BaseVector &x, BaseVector &y) { m.Mult(x, y); }, py::call_guard<py::gil_scoped_release>())
     .def("MultAdd",      [](BaseMatrix &m, double s, BaseVector &x, BaseVector &y) { m.MultAdd (s, x, y); }, py::call_guard<py::gil_scoped_release>())
+    .def("Mult",         [](BaseMatrix &m, MultiVector &x, MultiVector &y) { m.Mult(x, y); }, py::call_guard<py::gil_scoped_release>())
     .def("MultTrans",    [](BaseMatrix &m, double s, BaseVector &x, BaseVector &y) { y=0; m.MultTransAdd (1.0, x, y); }, py::call_guard<py::gil_scoped_release>())
     .def("MultTransAdd",  [](BaseMatrix &m, double s, BaseVector &x, BaseVector &y) { m.MultTransAdd (s, x, y); }, py::call_guard<py::gil_scoped_release>())
     .def("MultScale",    [](BaseMatrix &m, double s, BaseVector &x, BaseVector &y)
@@ -587,12 +723,15 @@ void NGS_DLL_HEADER ExportNgla(py::module &m) {
                                               return GetInverseName( m.GetInverseType());
                                             })
 
-    .def("Inverse", [](BM &m, shared_ptr<BitArray> freedofs, string inverse)
+    .def("Inverse", [](BM &m, shared_ptr<BitArray> freedofs, string inverse, Flags flags)
                                      { 
                                        if (inverse != "") m.SetInverseType(inverse);
+                                       if (auto sparsemat = dynamic_cast<BaseSparseMatrix*> (&m))
+                                         return sparsemat->InverseMatrix(freedofs, flags);
                                        return m.InverseMatrix(freedofs);
                                      }
-         ,"Inverse", py::arg("freedofs")=nullptr, py::arg("inverse")=py::str(""), 
+         ,"Inverse", py::arg("freedofs")=nullptr, py::arg("inverse")=py::str(""), py::arg("flags")=py::dict(),
+
          docu_string(R"raw_string(Calculate inverse of sparse matrix
 Parameters
 
@@ -606,6 +745,14 @@ inverse : string
     pardiso        - PARDISO, either provided by libpardiso (USE_PARDISO=ON) or Intel MKL (USE_MKL=ON).
                      If neither Pardiso nor Intel MKL was linked at compile-time, NGSolve will look
                      for libmkl_rt in LD_LIBRARY_PATH (Unix) or PATH (Windows) at run-time.
+
+flags : dict
+  Options for the solver. sparsecholesky supports:
+    outofcore        - keep the factor in a memory-mapped scratch file
+    outofcore_dir    - directory of the scratch file (default: $TMPDIR or /tmp)
+    outofcore_memory - MB of the factor kept in memory (default: 1000)
+    ordering         - fill-reducing ordering, "mindegree" (default) or "nesteddissection"
+    singleprecision  - store the factor as float (real matrices), for use as preconditioner
 )raw_string"), py::call_guard<py::gil_scoped_release>())
     // .def("Inverse", [](BM &m)  { return m.InverseMatrix(); })
 
@@ -630,7 +777,7 @@ inverse : string
          { return m.CreateJacobiPrecond(ba); },
          py::arg("freedofs") = shared_ptr<BitArray>())
     
-    .def("CreateBlockSmoother", [](BaseSparseMatrix & m, py::object blocks)
+    .def("CreateBlockSmoother", [](BaseSparseMatrix & m, py::object blocks, bool singleprecision)
          {
            size_t size = py::len(blocks);
            
@@ -650,8 +797,11 @@ inverse : string
              }
 
            auto pre = m.CreateBlockJacobiPrecond (make_shared<Table<int>> (move(blocktable)));
+           if (singleprecision)
+             pre->ConvertToSinglePrecision();
            return pre;
-         })
+         }, py::arg("blocks"), py::arg("singleprecision")=false,
+         "block smoother, singleprecision stores the block inverses as float")
      ;
 
   py::class_<S_BaseMatrix<double>, shared_ptr<S_BaseMatrix<double>>, BaseMatrix>
@@ -711,6 +861,26 @@ inverse : string
   ExportSparseMatrix<Mat<2,2,Complex>>(m);
   ExportSparseMatrix<Mat<3,3,double>>(m);
   ExportSparseMatrix<Mat<3,3,Complex>>(m);
+
+  py::class_<SELLMatrix<double>, shared_ptr<SELLMatrix<double>>, S_BaseMatrix<double>>
+    (m, "SELLMatrix", "SELL-C-sigma copy of a real sparse matrix for fast matrix-vector products")
+    .def(py::init<> ([] (shared_ptr<SparseMatrix<double>> mat, int sigma)
+                     { return make_shared<SELLMatrix<double>> (*mat, sigma); }),
+         py::arg("mat"), py::arg("sigma")=256,
+         "copy of mat, rows are sorted by length within windows of sigma rows")
+    .def_property_readonly("fillratio", &SELLMatrix<double>::FillRatio,
+                           "stored entries including padding per non-zero")
+    ;
+
+  py::class_<SELLMatrix<float>, shared_ptr<SELLMatrix<float>>, S_BaseMatrix<double>>
+    (m, "SELLMatrixFloat", "SELL-C-sigma copy of a real sparse matrix, values in single precision")
+    .def(py::init<> ([] (shared_ptr<SparseMatrix<double>> mat, int sigma)
+                     { return make_shared<SELLMatrix<float>> (*mat, sigma); }),
+         py::arg("mat"), py::arg("sigma")=256,
+         "copy of mat with values rounded to float, vectors stay double")
+    .def_property_readonly("fillratio", &SELLMatrix<float>::FillRatio,
+                           "stored entries including padding per non-zero")
+    ;
   
   py::class_<BaseBlockJacobiPrecond, shared_ptr<BaseBlockJacobiPrecond>, BaseMatrix>
     (m, "BlockSmoother",
@@ -756,6 +926,30 @@ inverse : string
 
   py::class_<KrylovSpaceSolver, shared_ptr<KrylovSpaceSolver>, BaseMatrix> (m, "KrylovSpaceSolver")
     .def("GetSteps", &KrylovSpaceSolver::GetSteps)
+    .def("Solve", [](KrylovSpaceSolver & self, py::list rhs, py::list sol)
+         {
+           size_t k = py::len(rhs);
+           if (py::len(sol) != k)
+             throw Exception ("Solve: different number of right hand sides and solutions");
+           if (k == 0) return;
+
+           size_t n = rhs[0].cast<BaseVector&>().Size();
+           MultiVector fm(n, k), xm(n, k);
+           for (size_t i = 0; i < k; i++)
+             {
+               BaseVector & f = rhs[i].cast<BaseVector&>();
+               BaseVector & x = sol[i].cast<BaseVector&>();
+               if (f.IsComplex() || f.EntrySize() != 1 || f.Size() != n || x.Size() != n)
+                 throw Exception ("Solve: needs real vectors of the same size");
+               fm[i] = f.FV<double>();
+               xm[i] = x.FV<double>();
+             }
+           static_cast<BaseMatrix&>(self).Mult (fm, xm);
+           for (size_t i = 0; i < k; i++)
+             sol[i].cast<BaseVector&>().FV<double>() = xm[i];
+         },
+         "solves for all right hand sides, block solvers treat them at once",
+         py::arg("rhs"), py::arg("sol"))
     ;
 
   m.def("CGSolver", [](const BaseMatrix & mat, const BaseMatrix & pre,
@@ -779,6 +973,52 @@ inverse : string
           )
     ;
 
+  m.def("PipelinedCGSolver", [](const BaseMatrix & mat, const BaseMatrix & pre,
+                                 bool printrates, double precision, int maxsteps)
+                                       {
+                                         KrylovSpaceSolver * solver;
+                                         if (mat.IsComplex())
+                                           solver = new PipelinedCGSolver<Complex> (mat, pre);
+                                         else
+                                           solver = new PipelinedCGSolver<double> (mat, pre);
+                                         solver->SetPrecision(precision);
+                                         solver->SetMaxSteps(maxsteps);
+                                         solver->SetPrintRates (printrates);
+                                         return shared_ptr<KrylovSpaceSolver>(solver);
+                                       },
+          "pipelined CG Solver, one global reduction per iteration overlapping pre and mat",
+          py::arg("mat"), py::arg("pre"), py::arg("printrates")=true,
+          py::arg("precision")=1e-8, py::arg("maxsteps")=200
+          )
+    ;
+
+  m.def("SStepCGSolver", [](const BaseMatrix & mat, const BaseMatrix & pre, int s,
+                             bool printrates, double precision, int maxsteps)
+                                       {
+                                         KrylovSpaceSolver * solver;
+                                         if (mat.IsComplex())
+                                           {
+                                             auto hsolver = new SStepCGSolver<Complex> (mat, pre);
+                                             hsolver->SetS (s);
+                                             solver = hsolver;
+                                           }
+                                         else
+                                           {
+                                             auto hsolver = new SStepCGSolver<double> (mat, pre);
+                                             hsolver->SetS (s);
+                                             solver = hsolver;
+                                           }
+                                         solver->SetPrecision(precision);
+                                         solver->SetMaxSteps(maxsteps);
+                                         solver->SetPrintRates (printrates);
+                                         return shared_ptr<KrylovSpaceSolver>(solver);
+                                       },
+          "s-step CG Solver, one global reduction per s iterations",
+          py::arg("mat"), py::arg("pre"), py::arg("s")=4, py::arg("printrates")=true,
+          py::arg("precision")=1e-8, py::arg("maxsteps")=200
+          )
+    ;
+
   m.def("GMRESSolver", [](const BaseMatrix & mat, const BaseMatrix & pre,
                                            bool printrates, 
                                            double precision, int maxsteps)
@@ -798,6 +1038,41 @@ inverse : string
           )
     ;
 
+  m.def("BlockCGSolver", [](const BaseMatrix & mat, const BaseMatrix & pre,
+                             bool printrates, double precision, int maxsteps)
+                                       {
+                                         if (mat.IsComplex())
+                                           throw Exception ("BlockCGSolver: real matrices only");
+                                         auto solver = make_shared<BlockCGSolver> (mat, pre);
+                                         solver->SetPrecision(precision);
+                                         solver->SetMaxSteps(maxsteps);
+                                         solver->SetPrintRates (printrates);
+                                         return shared_ptr<KrylovSpaceSolver>(solver);
+                                       },
+          "block CG Solver, use Solve for several right hand sides",
+          py::arg("mat"), py::arg("pre"), py::arg("printrates")=true,
+          py::arg("precision")=1e-8, py::arg("maxsteps")=200
+          )
+    ;
+
+  m.def("BlockGMRESSolver", [](const BaseMatrix & mat, const BaseMatrix & pre,
+                                bool printrates, double precision, int maxsteps, int restart)
+                                        {
+                                          if (mat.IsComplex())
+                                            throw Exception ("BlockGMRESSolver: real matrices only");
+                                          auto solver = make_shared<BlockGMRESSolver> (mat, pre);
+                                          solver->SetPrecision(precision);
+                                          solver->SetMaxSteps(maxsteps);
+                                          solver->SetRestart(restart);
+                                          solver->SetPrintRates (printrates);
+                                          return shared_ptr<KrylovSpaceSolver>(solver);
+                                        },
+          "block GMRES Solver, use Solve for several right hand sides, restarted after 'restart' block steps (0 for no restart)",
+          py::arg("mat"), py::arg("pre"), py::arg("printrates")=true,
+          py::arg("precision")=1e-8, py::arg("maxsteps")=200, py::arg("restart")=30
+          )
+    ;
+
   m.def("TestPC", [](const BaseMatrix & mat, const BaseMatrix & pre) {
       EigenSystem eigen(mat, pre);
       eigen.Calc();
@@ -888,9 +1163,150 @@ inverse : string
         "Arnoldi Solver", py::arg("mata"), py::arg("matm"), py::arg("freedofs"), py::arg("vecs"), py::arg("shift")=DummyArgument()
         )
     ;
+
+  m.def("LOBPCG", [](BaseMatrix & mata, BaseMatrix & matm, py::list vecs,
+                     shared_ptr<BaseMatrix> pre, shared_ptr<BitArray> freedofs,
+                     py::list deflation, bool initialize,
+                     double precision, int maxsteps, bool printrates)
+        {
+          if (mata.IsComplex())
+            throw Exception ("LOBPCG: real matrices only");
+          size_t nev = py::len(vecs);
+          if (nev == 0) return Vector<double>(0);
+
+          auto & v0 = vecs[0].cast<BaseVector&>();
+          if (v0.EntrySize() != 1 || v0.GetParallelStatus() != NOT_PARALLEL)
+            throw Exception ("LOBPCG: sequential vectors with scalar entries only");
+          size_t n = v0.Size();
+          for (py::list l : { vecs, deflation })
+            for (auto v : l)
+              {
+                auto & bv = v.cast<BaseVector&>();
+                if (bv.IsComplex() || bv.EntrySize() != 1 || bv.Size() != n)
+                  throw Exception ("LOBPCG: vecs and deflation need real vectors of size " + ToString(n));
+              }
+
+          LOBPCG lobpcg (mata, matm, pre.get(), freedofs);
+          lobpcg.SetPrecision (precision);
+          lobpcg.SetMaxSteps (maxsteps);
+          lobpcg.SetPrintRates (printrates);
+
+          if (py::len(deflation))
+            {
+              MultiVector y(n, py::len(deflation));
+              for (size_t i = 0; i < y.Num(); i++)
+                y[i] = deflation[i].cast<BaseVector&>().FV<double>();
+              lobpcg.SetDeflation (y);
+            }
+
+          MultiVector x(n, nev);
+          for (size_t i = 0; i < nev; i++)
+            if (initialize)
+              x.Vec(i).SetRandom();
+            else
+              x[i] = vecs[i].cast<BaseVector&>().FV<double>();
+
+          Vector<double> lam;
+          {
+            py::gil_scoped_release release;
+            lobpcg.Calc (x, lam);
+          }
+          for (size_t i = 0; i < nev; i++)
+            vecs[i].cast<BaseVector&>().FV<double>() = x[i];
+          return lam;
+        },
+        "LOBPCG eigenvalue solver for the smallest eigenvalues of A x = lam M x,\n"
+        "computes as many eigenpairs as vectors are given in vecs",
+        py::arg("mata"), py::arg("matm"), py::arg("vecs"),
+        py::arg("pre")=nullptr, py::arg("freedofs")=nullptr,
+        py::arg("deflation")=py::list(), py::arg("initialize")=true,
+        py::arg("precision")=1e-8, py::arg("maxsteps")=200, py::arg("printrates")=false
+        );
   
   
 
+  py::class_<TimeStepper, shared_ptr<TimeStepper>>
+    (m, "TimeStepper", "time integration of  M u' + A u = f(t),  or  M u'' + C u' + A u = f(t)")
+    .def("Step", [](TimeStepper & self, BaseVector & u, double dt) { self.Step (u, dt); },
+         py::arg("u"), py::arg("dt"), py::call_guard<py::gil_scoped_release>(),
+         "one step from time to time+dt")
+    .def("Integrate", [](TimeStepper & self, BaseVector & u, double tend, double dt, py::object callback)
+         {
+           function<void(double)> cb;
+           if (!callback.is_none())
+             cb = [callback] (double t)
+               {
+                 py::gil_scoped_acquire gil;
+                 callback (t);
+               };
+           py::gil_scoped_release release;
+           return self.Integrate (u, tend, dt, cb);
+         },
+         py::arg("u"), py::arg("tend"), py::arg("dt"), py::arg("callback")=py::none(),
+         "equidistant steps of size at most dt up to tend, calls callback(t) after every step")
+    .def_property("time", &TimeStepper::GetTime, &TimeStepper::SetTime,
+                  "time of the current solution, setting it resets the history")
+    .def_property_readonly("steps", &TimeStepper::GetSteps)
+    .def("Reset", &TimeStepper::Reset, "forget the history, e.g. after changing u")
+    ;
+
+  py::class_<BDF, shared_ptr<BDF>, TimeStepper>
+    (m, "BDF", "backward differentiation formula of order 1, 2 or 3")
+    .def(py::init([](shared_ptr<BaseMatrix> mat_m, shared_ptr<BaseMatrix> mat_a, py::object rhs,
+                     int order, shared_ptr<BitArray> freedofs, string inverse)
+                  {
+                    return make_shared<BDF> (mat_m, mat_a, MakeTimeStepperRHS(rhs),
+                                             order, freedofs, inverse);
+                  }),
+         py::arg("m"), py::arg("a"), py::arg("rhs")=py::none(), py::arg("order")=2,
+         py::arg("freedofs")=nullptr, py::arg("inverse")="")
+    ;
+
+  py::class_<RungeKutta, shared_ptr<RungeKutta>, TimeStepper>
+    (m, "RungeKutta", "explicit (euler, heun, ssprk3, rk4) or diagonally implicit\n"
+     "(implicit_euler, sdirk2, sdirk3) Runge-Kutta method, minv is used for explicit stages")
+    .def(py::init([](shared_ptr<BaseMatrix> mat_m, shared_ptr<BaseMatrix> mat_a, py::object rhs,
+                     string method, shared_ptr<BaseMatrix> minv,
+                     shared_ptr<BitArray> freedofs, string inverse)
+                  {
+                    return make_shared<RungeKutta> (mat_m, mat_a, MakeTimeStepperRHS(rhs),
+                                                    ButcherTableau(method), minv, freedofs, inverse);
+                  }),
+         py::arg("m"), py::arg("a"), py::arg("rhs")=py::none(), py::arg("method")="rk4",
+         py::arg("minv")=nullptr, py::arg("freedofs")=nullptr, py::arg("inverse")="")
+    ;
+
+  py::class_<GeneralizedAlpha, shared_ptr<GeneralizedAlpha>, TimeStepper>
+    (m, "GeneralizedAlpha", "generalized-alpha method for  M u'' + C u' + A u = f(t)")
+    .def(py::init([](shared_ptr<BaseMatrix> mat_m, shared_ptr<BaseMatrix> mat_a,
+                     shared_ptr<BaseMatrix> mat_c, py::object rhs, double rho_inf,
+                     shared_ptr<BitArray> freedofs, string inverse)
+                  {
+                    return make_shared<GeneralizedAlpha> (mat_m, mat_c, mat_a, MakeTimeStepperRHS(rhs),
+                                                          rho_inf, freedofs, inverse);
+                  }),
+         py::arg("m"), py::arg("a"), py::arg("c")=nullptr, py::arg("rhs")=py::none(),
+         py::arg("rho_inf")=1.0, py::arg("freedofs")=nullptr, py::arg("inverse")="")
+    .def("SetVelocity", &GeneralizedAlpha::SetVelocity, py::arg("v"))
+    .def("SetAcceleration", &GeneralizedAlpha::SetAcceleration, py::arg("acc"))
+    .def_property_readonly("velocity", &GeneralizedAlpha::GetVelocity)
+    .def_property_readonly("acceleration", &GeneralizedAlpha::GetAcceleration)
+    ;
+
+  m.def("Newmark", [](shared_ptr<BaseMatrix> mat_m, shared_ptr<BaseMatrix> mat_a,
+                      shared_ptr<BaseMatrix> mat_c, py::object rhs, double beta, double gamma,
+                      shared_ptr<BitArray> freedofs, string inverse)
+        {
+          auto stepper = make_shared<GeneralizedAlpha> (mat_m, mat_c, mat_a, MakeTimeStepperRHS(rhs),
+                                                        1.0, freedofs, inverse);
+          stepper->SetParameters (0, 0, beta, gamma);
+          return stepper;
+        },
+        py::arg("m"), py::arg("a"), py::arg("c")=nullptr, py::arg("rhs")=py::none(),
+        py::arg("beta")=0.25, py::arg("gamma")=0.5,
+        py::arg("freedofs")=nullptr, py::arg("inverse")="",
+        "Newmark method for  M u'' + C u' + A u = f(t)");
+
   m.def("DoArchive" , [](shared_ptr<Archive> & arch, BaseMatrix & mat)
                                          { cout << "output basematrix" << endl;
                                            mat.DoArchive(*arch); return arch; });
@@ -0,0 +1,226 @@
+/*********************************************************************/
+/* File:   sellmatrix.cpp                                            */
+/* Date:   Oct. 2026                                                 */
+/*********************************************************************/
+
+/*
+   SELL-C-sigma storage for fast matrix-vector products
+*/
+
+#include <la.hpp>
+
+namespace ngla
+{
+
+  template <typename TVAL>
+  SELLMatrix<TVAL> :: SELLMatrix (const SparseMatrixTM<double> & mat, int asigma)
+  {
+    static Timer t("SELLMatrix - build"); RegionTimer reg(t);
+
+    height = mat.Height();
+    width = mat.Width();
+    sigma = max2 (C * ((asigma + C - 1) / C), int(C));
+
+    // full row graph, a symmetric matrix stores only the lower triangle
+    bool symmetric = dynamic_cast<const SparseMatrixSymmetric<double>*> (&mat) != nullptr;
+
+    Array<int> rowlen(height);
+    ParallelFor (Range(height), [&] (int i)
+                 { rowlen[i] = mat.GetRowIndices(i).Size(); });
+
+    Array<size_t> firsti;
+    Array<int> cols;
+    Array<double> vals;
+    if (symmetric)
+      {
+        for (int i = 0; i < height; i++)
+          for (int c : mat.GetRowIndices(i))
+            if (c != i) rowlen[c]++;
+        firsti.SetSize (height+1);
+        firsti[0] = 0;
+        for (int i = 0; i < height; i++)
+          firsti[i+1] = firsti[i] + rowlen[i];
+        cols.SetSize (firsti[height]);
+        vals.SetSize (firsti[height]);
+
+        Array<size_t> cnt(height);
+        cnt = firsti.Range(0, height);
+        for (int i = 0; i < height; i++)
+          {
+            auto rowind = mat.GetRowIndices(i);
+            auto rowvals = mat.GetRowValues(i);
+            for (int j : Range(rowind))
+              {
+                int c = rowind[j];
+                cols[cnt[i]] = c;
+                vals[cnt[i]++] = rowvals(j);
+                if (c != i)
+                  {
+                    cols[cnt[c]] = i;
+                    vals[cnt[c]++] = rowvals(j);
+                  }
+              }
+          }
+      }
+    nze = symmetric ? firsti[height] : mat.NZE();
+
+    auto row_indices = [&] (int i) -> FlatArray<int>
+      {
+        if (symmetric) return cols.Range (firsti[i], firsti[i+1]);
+        return mat.GetRowIndices(i);
+      };
+    auto row_values = [&] (int i) -> FlatArray<double>
+      {
+        if (symmetric) return vals.Range (firsti[i], firsti[i+1]);
+        return FlatArray<double> (rowlen[i], mat.GetRowValues(i).Addr(0));
+      };
+
+    // sort rows by length within windows of sigma rows
+    size_t nchunks = (height + C - 1) / C;
+    perm.SetSize (nchunks * C);
+    for (int i : Range(perm))
+      perm[i] = (i < height) ? i : -1;
+
+    ParallelFor (Range((height + sigma - 1) / sigma), [&] (int w)
+      {
+        FlatArray<int> window = perm.Range (size_t(w)*sigma, min2(size_t(w+1)*sigma, perm.Size()));
+        auto len = [&] (int row) { return row >= 0 ? rowlen[row] : -1; };
+        // keep original order among rows of same length
+        QuickSort (window, [&] (int a, int b)
+                   { return len(a) > len(b) || (len(a) == len(b) && unsigned(a) < unsigned(b)); });
+      });
+
+    // chunks of C rows, padded to the longest row
+    firstinchunk.SetSize (nchunks+1);
+    firstinchunk[0] = 0;
+    for (size_t k = 0; k < nchunks; k++)
+      {
+        int maxlen = 0;
+        for (int r = 0; r < C; r++)
+          if (perm[k*C+r] >= 0)
+            maxlen = max2 (maxlen, rowlen[perm[k*C+r]]);
+        firstinchunk[k+1] = firstinchunk[k] + size_t(maxlen) * C;
+      }
+
+    colnr.SetSize (firstinchunk[nchunks]);
+    values.SetSize (firstinchunk[nchunks]);
+
+    ParallelFor (Range(nchunks), [&] (size_t k)
+      {
+        size_t first = firstinchunk[k];
+        size_t len = (firstinchunk[k+1] - first) / C;
+        for (int r = 0; r < C; r++)
+          {
+            int row = perm[k*C+r];
+            size_t j = 0;
+            if (row >= 0)
+              {
+                auto rowind = row_indices(row);
+                auto rowvals = row_values(row);
+                for ( ; j < rowind.Size(); j++)
+                  {
+                    colnr[first + j*C + r] = rowind[j];
+                    values[first + j*C + r] = TVAL(rowvals[j]);
+                  }
+              }
+            for ( ; j < len; j++)
+              {
+                colnr[first + j*C + r] = 0;
+                values[first + j*C + r] = 0.0;
+              }
+          }
+      });
+
+    balance.Calc (nchunks, [&] (size_t k)
+                  { return firstinchunk[k+1] - firstinchunk[k] + C; });
+  }
+
+
+  template <typename TVAL, typename FUNC>
+  INLINE void SELLChunkProducts (const Partitioning & balance,
+                                 FlatArray<size_t> firstinchunk,
+                                 FlatArray<int> colnr, FlatArray<TVAL> values,
+                                 FlatArray<int> perm,
+                                 const double * px, FUNC func)
+  {
+    constexpr int C = SELLMatrix<TVAL>::C;
+    ParallelFor (balance, [&] (size_t k)
+      {
+        SIMD<double,C> sum(0.0);
+        for (size_t j = firstinchunk[k]; j < firstinchunk[k+1]; j += C)
+          sum = FMA (LoadDouble<C> (&values[j]), Gather<C> (px, &colnr[j]), sum);
+        for (int r = 0; r < C; r++)
+          {
+            int row = perm[k*C+r];
+            if (row >= 0) func (row, sum[r]);
+          }
+      });
+  }
+
+
+  template <typename TVAL>
+  void SELLMatrix<TVAL> :: Mult (const BaseVector & x, BaseVector & y) const
+  {
+    static Timer t("SELLMatrix::Mult"); RegionTimer reg(t);
+    t.AddFlops (nze);
+
+    FlatVector<double> fx = x.FV<double>();
+    FlatVector<double> fy = y.FV<double>();
+    SELLChunkProducts (balance, firstinchunk, colnr, values, perm, &fx(0),
+                       [fy] (int row, double sum) { fy(row) = sum; });
+  }
+
+
+  template <typename TVAL>
+  void SELLMatrix<TVAL> :: MultAdd (double s, const BaseVector & x, BaseVector & y) const
+  {
+    static Timer t("SELLMatrix::MultAdd"); RegionTimer reg(t);
+    t.AddFlops (nze);
+
+    FlatVector<double> fx = x.FV<double>();
+    FlatVector<double> fy = y.FV<double>();
+    SELLChunkProducts (balance, firstinchunk, colnr, values, perm, &fx(0),
+                       [fy,s] (int row, double sum) { fy(row) += s * sum; });
+  }
+
+
+  template <typename TVAL>
+  void SELLMatrix<TVAL> :: MultTransAdd (double s, const BaseVector & x, BaseVector & y) const
+  {
+    static Timer t("SELLMatrix::MultTransAdd"); RegionTimer reg(t);
+    t.AddFlops (nze);
+
+    FlatVector<double> fx = x.FV<double>();
+    FlatVector<double> fy = y.FV<double>();
+
+    // scatter to columns, padding adds zeros to column 0
+    for (size_t k = 0; k + 1 < firstinchunk.Size(); k++)
+      {
+        double hx[C];
+        for (int r = 0; r < C; r++)
+          {
+            int row = perm[k*C+r];
+            hx[r] = row >= 0 ? s * fx(row) : 0.0;
+          }
+        SIMD<double,C> sx(&hx[0]);
+        for (size_t j = firstinchunk[k]; j < firstinchunk[k+1]; j += C)
+          {
+            SIMD<double,C> prod = LoadDouble<C> (&values[j]) * sx;
+            for (int r = 0; r < C; r++)
+              fy(colnr[j+r]) += prod[r];
+          }
+      }
+  }
+
+
+  template <typename TVAL>
+  void SELLMatrix<TVAL> :: MemoryUsage (Array<MemoryUsageStruct*> & mu) const
+  {
+    mu.Append (new MemoryUsageStruct ("SELLMatrix", values.Size()*(sizeof(TVAL)+sizeof(int)), 1));
+  }
+
+
+  template class SELLMatrix<double>;
+  template class SELLMatrix<float>;
+
+}
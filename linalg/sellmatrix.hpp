@@ -0,0 +1,73 @@
+#ifndef FILE_NGS_SELLMATRIX
+#define FILE_NGS_SELLMATRIX
+
+/**************************************************************************/
+/* File:   sellmatrix.hpp                                                 */
+/* Date:   Oct. 2026                                                      */
+/**************************************************************************/
+
+namespace ngla
+{
+
+  /**
+     Sliced ELLPACK (SELL-C-sigma) copy of a real sparse matrix.
+
+     Rows are sorted by length within windows of sigma rows, and
+     grouped into chunks of C = SIMD<double>::Size() rows. A chunk
+     is stored column by column, padded to its longest row, so one
+     SIMD lane works on one row.
+
+     The copy is built once after assembly, it does not follow later
+     changes of the original matrix.
+
+     With TVAL = float the values are stored in single precision and
+     converted on load, vectors and arithmetic stay in double.
+   */
+  template <typename TVAL = double>
+  class NGS_DLL_HEADER SELLMatrix : public S_BaseMatrix<double>
+  {
+  public:
+    enum { C = SIMD<double>::Size() };
+
+  protected:
+    int height, width;
+    int sigma;
+    size_t nze;
+
+    /// original row of sorted row
+    Array<int> perm;
+    /// first entry of chunk, stride is C
+    Array<size_t> firstinchunk;
+    /// column numbers, padding entries point to column 0 with value 0
+    Array<int> colnr;
+    Array<TVAL> values;
+    /// balancing for multi-threading
+    Partitioning balance;
+
+  public:
+    /// symmetric matrices are expanded to full storage
+    SELLMatrix (const SparseMatrixTM<double> & mat, int asigma = 256);
+
+    virtual bool IsComplex() const override { return false; }
+    virtual int VHeight() const override { return height; }
+    virtual int VWidth() const override { return width; }
+    virtual size_t NZE () const override { return nze; }
+
+    virtual AutoVector CreateRowVector () const override
+    { return make_shared<VVector<double>> (width); }
+    virtual AutoVector CreateColVector () const override
+    { return make_shared<VVector<double>> (height); }
+
+    virtual void Mult (const BaseVector & x, BaseVector & y) const override;
+    virtual void MultAdd (double s, const BaseVector & x, BaseVector & y) const override;
+    virtual void MultTransAdd (double s, const BaseVector & x, BaseVector & y) const override;
+
+    /// stored entries including padding, relative to non-zeros
+    double FillRatio () const { return nze ? double(values.Size()) / nze : 1; }
+
+    virtual void MemoryUsage (Array<MemoryUsageStruct*> & mu) const override;
+  };
+
+}
+
+#endif
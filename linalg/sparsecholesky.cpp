@@ -10,6 +10,12 @@
 
 #include "concurrentqueue.h" 
 
+#ifndef WIN32
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 
 typedef moodycamel::ConcurrentQueue<int> TQueue; 
 typedef moodycamel::ProducerToken TPToken; 
@@ -38,8 +44,9 @@ namespace ngla
   SparseCholeskyTM (const SparseMatrixTM<TM> & a, 
                     shared_ptr<BitArray> ainner,
                     shared_ptr<const Array<int>> acluster,
-                    bool allow_refactor)
-    : SparseFactorization (a, ainner, acluster), mat(a)
+                    bool allow_refactor,
+                    const Flags & aflags)
+    : SparseFactorization (a, ainner, acluster), mat(a), flags(aflags)
   { 
     static Timer t("SparseCholesky - total");
     static Timer ta("SparseCholesky - allocate");
@@ -130,7 +137,43 @@ namespace ngla
       cout << IM(4) << "start ordering" << endl;
     
     // mdo -> PrintCliques ();
-    mdo->Order();
+    string ordering = flags.GetStringFlag ("ordering", "mindegree");
+    if (ordering == "nesteddissection")
+      {
+        auto use_entry = [&] (int i, int col)
+          {
+            if (inner) return inner->Test(i) && inner->Test(col);
+            if (cluster) return (*cluster)[i] == (*cluster)[col] && (*cluster)[i] != 0;
+            return true;
+          };
+
+        TableCreator<int> creator(n);
+        for ( ; !creator.Done(); creator++)
+          ParallelFor (Range(n), [&] (int i)
+                       {
+                         for (int col : a.GetRowIndices(i))
+                           if (col < i && use_entry (i, col))
+                             {
+                               creator.Add (i, col);
+                               creator.Add (col, i);
+                             }
+                       });
+        Table<int> graph = creator.MoveTable();
+        
+        BitArray used(n);
+        used.Clear();
+        for (int i = 0; i < n; i++)
+          if (!mdo->vertices[i].Eliminated())
+            used.Set(i);
+
+        NestedDissection nd(graph, used);
+        cout << IM(4) << "nested dissection, " << nd.NumNodes() << " separator tree nodes" << endl;
+        mdo->Order (nd.order);
+      }
+    else if (ordering == "mindegree")
+      mdo->Order();
+    else
+      throw Exception ("SparseCholesky: unknown ordering '"+ordering+"'");
     nused = mdo->nused;
     endtime = clock();
     if (printstat)
@@ -151,9 +194,7 @@ namespace ngla
     mdo = 0;
 
     diag.SetSize(nused);
-    // lfact.SetSize (nze);
-    lfact = NumaInterleavedArray<TM> (nze);
-    lfact = TM(0.0);     // first touch
+    AllocateFactor();
     
     endtime = clock();
     if (printstat)
@@ -231,6 +272,8 @@ namespace ngla
       cout << IM(4) << "do factor " << flush;
 
     FactorSPD();
+    if (flags.GetDefineFlag ("singleprecision"))
+      ConvertFactorToSingle();
     /*
 #ifdef LAPACK
     if (a.IsSPD())
@@ -271,6 +314,61 @@ namespace ngla
   
 
   
+  template <class TM>
+  void SparseCholeskyTM<TM> :: AllocateFactor ()
+  {
+    if (flags.GetDefineFlag ("outofcore"))
+      {
+        // only the supernodal FactorSPD1 writes back and evicts finished blocks
+        if (!is_same<TM,double>::value && !is_same<TM,Complex>::value)
+          throw Exception ("SparseCholesky: outofcore is available for double and complex matrices only");
+        string dir = flags.GetStringFlag ("outofcore_dir", "");
+        if (dir == "")
+          dir = getenv("TMPDIR") ? getenv("TMPDIR") : "/tmp";
+        ooc_memory = size_t(flags.GetNumFlag ("outofcore_memory", 1000) * 1e6);
+
+        cout << IM(4) << " out-of-core in " << dir << flush;
+        lfact_file = make_unique<ScratchFile> (dir, nze*sizeof(TM));
+        // the file is zero-initialized
+        lfact.Assign (FlatArray<TM> (nze, static_cast<TM*> (lfact_file->Data())));
+      }
+    else
+      {
+        ooc_memory = 0;
+        lfact_mem = NumaInterleavedArray<TM> (nze);
+        lfact_mem = TM(0.0);     // first touch
+        lfact.Assign (lfact_mem);
+      }
+  }
+
+
+  template <class TM>
+  void SparseCholeskyTM<TM> :: 
+  StreamBlocks (int bnr, int dir, int & prefetched) const
+  {
+    int nblocks = blocks.Size()-1;
+
+    int prev = bnr-dir;
+    if (prev >= 0 && prev < nblocks)
+      {
+        auto r = BlockEntries(prev);
+        lfact_file->Evict (r.First()*sizeof(TM), r.Next()*sizeof(TM));
+      }
+
+    auto r0 = BlockEntries(bnr);
+    while (true)
+      {
+        int next = prefetched+dir;
+        if (next < 0 || next >= nblocks) break;
+        auto r = BlockEntries(next);
+        size_t window = (dir > 0) ? r.Next()-r0.First() : r0.Next()-r.First();
+        if (window*sizeof(TM) > ooc_memory && next != bnr) break;
+        lfact_file->Prefetch (r.First()*sizeof(TM), r.Next()*sizeof(TM));
+        prefetched = next;
+      }
+  }
+
+
   template <class TM>
   void SparseCholeskyTM<TM> :: 
   Allocate (const Array<int> & aorder, 
@@ -511,6 +609,11 @@ namespace ngla
     id = 0.0;
     SetIdentity(id);
 
+    if (lfact_single.Size())
+      {
+        lfact_single.SetSize0();
+        AllocateFactor();
+      }
     for (size_t i = 0; i < nze; i++) lfact[i] = 0.0;
 
     for (int i = 0; i < height; i++)
@@ -531,6 +634,33 @@ namespace ngla
 	}
     
     FactorSPD(); 
+    if (flags.GetDefineFlag ("singleprecision"))
+      ConvertFactorToSingle();
+  }
+
+
+  template <class TM>
+  void SparseCholeskyTM<TM> :: ConvertFactorToSingle ()
+  {
+    throw Exception ("SparseCholesky: singleprecision is available for real matrices only");
+  }
+
+  template <>
+  void SparseCholeskyTM<double> :: ConvertFactorToSingle ()
+  {
+    if (lfact_file)
+      throw Exception ("SparseCholesky: singleprecision cannot be combined with outofcore");
+    static Timer t("SparseCholesky::ConvertFactorToSingle"); RegionTimer reg(t);
+
+    lfact_single.SetSize (nze);
+    ParallelForRange (nze, [&] (IntRange r)
+                      {
+                        for (auto i : r)
+                          lfact_single[i] = lfact[i];
+                      });
+    NumaInterleavedArray<double> empty;
+    lfact_mem.Swap (empty);
+    lfact.Assign (lfact_mem);
   }
  
 
@@ -914,6 +1044,7 @@ namespace ngla
     TM * hlfact = lfact.Addr(0);
     
     Array<TM> tmpmem;
+    size_t written = 0, evicted = 0;   // out-of-core progress, in entries of lfact
     for (size_t i1 = 0; i1 < n;  )
       {
 	size_t last_same = i1;
@@ -1046,18 +1177,31 @@ namespace ngla
 	      }
 	  }
         // timerc2.Stop();
-	i1 = last_same;
-        // timerc.Stop();
-      }
 
-    size_t j = 0;
-    for (size_t i = 0; i < n; i++)
-      {
-	TM ai = diag[i];
-	size_t last = hfirstinrow[i+1];
+        // rows of this block are final now
+	for (size_t i2 = i1; i2 < last_same; i2++)
+	  {
+	    TM ai = diag[i2];
+	    for (size_t j = hfirstinrow[i2]; j < hfirstinrow[i2+1]; j++)
+              lfact[j] = lfact[j] * ai;
+	  }
 
-	for ( ; j < last; j++)
-          lfact[j] = lfact[j] * ai;
+        if (lfact_file)
+          {
+            // write back while the next blocks are factored,
+            // drop the oldest blocks when over budget
+            lfact_file->WriteBack (written*sizeof(TM), hfirstinrow[last_same]*sizeof(TM));
+            written = hfirstinrow[last_same];
+            if ((written-evicted)*sizeof(TM) > ooc_memory)
+              {
+                size_t upto = written - ooc_memory/(2*sizeof(TM));
+                lfact_file->Evict (evicted*sizeof(TM), upto*sizeof(TM));
+                evicted = upto;
+              }
+          }
+        
+	i1 = last_same;
+        // timerc.Stop();
       }
 
 
@@ -1291,9 +1435,97 @@ namespace ngla
 
 
 
+  template <class TM, class TV_ROW, class TV_COL>
+  void SparseCholesky<TM, TV_ROW, TV_COL> :: 
+  SolveReorderedOutOfCore (FlatVector<TVX> hy) const
+  {
+    static Timer t("SparseCholesky::Solve out-of-core");
+    RegionTimer reg(t);
+
+    int nblocks = blocks.Size()-1;
+    const TM * hlfact = lfact.Addr(0);
+
+    // forward substitution, the factor is streamed in block order
+    int prefetched = -1;
+    for (int b = 0; b < nblocks; b++)
+      {
+        this->StreamBlocks (b, 1, prefetched);
+        auto range = BlockDofs (b);
+        if (range.Size() == 0) continue;
+        auto extdofs = BlockExtDofs (b);
+
+        for (auto i : range)
+          {
+            TVX hyi = hy(i);
+            size_t size = range.end()-i-1;
+            FlatVector<TM> vlfact(size, const_cast<TM*>(hlfact+firstinrow[i]));
+            auto hyr = hy.Range(i+1, range.end());
+            for (size_t j = 0; j < size; j++)
+              hyr(j) -= Trans(vlfact(j)) * hyi;
+
+            FlatVector<TM> ext_lfact (extdofs.Size(), const_cast<TM*>(hlfact+firstinrow[i]+size));
+            for (size_t j = 0; j < extdofs.Size(); j++)
+              hy(extdofs[j]) -= Trans(ext_lfact(j)) * hyi;
+          }
+      }
+
+    // solve with the diagonal
+    const TM * hdiag = &diag[0];
+    ParallelFor (hy.Size(), [&] (int i)
+                 {
+                   TVX tmp = hdiag[i] * hy[i];
+                   hy[i] = tmp;
+                 });
+
+    // backward substitution, streamed in reverse block order
+    prefetched = nblocks;
+    for (int b = nblocks-1; b >= 0; b--)
+      {
+        this->StreamBlocks (b, -1, prefetched);
+        auto range = BlockDofs (b);
+        if (range.Size() == 0) continue;
+        auto extdofs = BlockExtDofs (b);
+
+        for (auto i : range)
+          {
+            size_t first = firstinrow[i] + range.end()-i-1;
+            FlatVector<TM> ext_lfact (extdofs.Size(), const_cast<TM*>(hlfact+first));
+            TVX val(0.0);
+            for (auto j : Range(extdofs))
+              val += ext_lfact(j) * hy(extdofs[j]);
+            hy(i) -= val;
+          }
+
+        for (size_t i = range.end()-1; i-- > range.begin(); )
+          {
+            size_t size = range.end()-i-1;
+            FlatVector<TM> vlfact(size, const_cast<TM*>(hlfact+firstinrow[i]));
+            auto hyr = hy.Range(i+1, range.end());
+            TVX hyi = hy(i);
+            for (size_t j = 0; j < size; j++)
+              hyi -= vlfact(j) * hyr(j);
+            hy(i) = hyi;
+          }
+      }
+  }
+
+
   template <class TM, class TV_ROW, class TV_COL>
   void SparseCholesky<TM, TV_ROW, TV_COL> :: 
   SolveReordered (FlatVector<TVX> hy) const
+  {
+    if (lfact_file)
+      SolveReorderedOutOfCore (hy);
+    else if (lfact_single.Size())
+      SolveReordered<typename BASE::TSINGLE> (hy, lfact_single.Addr(0));
+    else
+      SolveReordered<TM> (hy, lfact.Addr(0));
+  }
+
+
+  template <class TM, class TV_ROW, class TV_COL> template <typename TFACT>
+  void SparseCholesky<TM, TV_ROW, TV_COL> :: 
+  SolveReordered (FlatVector<TVX> hy, const TFACT * hlfact) const
   {
     static Timer timer1("SparseCholesky<d,d,d>::MultAdd fac1");
     static Timer timer2("SparseCholesky<d,d,d>::MultAdd fac2");
@@ -1392,11 +1624,11 @@ namespace ngla
                                      size_t size = range.end()-i-1;
                                      if (size > 0)
                                        {
-                                         FlatVector<TM> vlfact(size, &lfact[firstinrow[i]]);
+                                         FlatVector<TFACT> vlfact(size, const_cast<TFACT*>(hlfact+firstinrow[i]));
                                          
                                          auto hyr = hy.Range(i+1, range.end());
                                          for (size_t j = 0; j < size; j++)
-                                           hyr(j) -= Trans(vlfact(j)) * hyi;
+                                           hyr(j) -= Trans(TM(vlfact(j))) * hyi;
                                        }
                                      if (extdofs.Size() == 0)
                                        {
@@ -1404,9 +1636,9 @@ namespace ngla
                                          continue;
                                        }
                                      size_t first = firstinrow[i] + range.end()-i-1;
-                                     FlatVector<TM> ext_lfact (extdofs.Size(), &lfact[first]);
+                                     FlatVector<TFACT> ext_lfact (extdofs.Size(), const_cast<TFACT*>(hlfact+first));
                                      for (size_t j = 0; j < temp.Size(); j++)
-                                       temp(j) += Trans(ext_lfact(j)) * hyi;
+                                       temp(j) += Trans(TM(ext_lfact(j))) * hyi;
                                    }
                                  
                                  for (size_t j : Range(extdofs))
@@ -1420,12 +1652,12 @@ namespace ngla
                                    {
                                      size_t size = range.end()-i-1;
                                      if (size == 0) continue;
-                                     FlatVector<TM> vlfact(size, &lfact[firstinrow[i]]);
+                                     FlatVector<TFACT> vlfact(size, const_cast<TFACT*>(hlfact+firstinrow[i]));
 
                                      TVX hyi = hy(i);
                                      auto hyr = hy.Range(i+1, range.end());
                                      for (size_t j = 0; j < hyr.Size(); j++)
-                                       hyr(j) -= Trans(vlfact(j)) * hyi;
+                                       hyr(j) -= Trans(TM(vlfact(j))) * hyi;
                                    }
 
                                }
@@ -1446,11 +1678,11 @@ namespace ngla
                                        {
                                          size_t first = firstinrow[i] + range.end()-i-1;
                                          
-                                         FlatVector<TM> ext_lfact (all_extdofs.Size(), &lfact[first]);
+                                         FlatVector<TFACT> ext_lfact (all_extdofs.Size(), const_cast<TFACT*>(hlfact+first));
  
                                          TVX hyi = hy(i);
                                          for (size_t j = 0; j < temp.Size(); j++)
-                                           temp(j) += Trans(ext_lfact(myr.begin()+j)) * hyi;
+                                           temp(j) += Trans(TM(ext_lfact(myr.begin()+j))) * hyi;
                                        }
                                      
                                      for (size_t j : Range(extdofs))
@@ -1502,23 +1734,23 @@ namespace ngla
                                    for (auto i : range)
                                      {
                                        size_t first = firstinrow[i] + range.end()-i-1;
-                                       FlatVector<TM> ext_lfact (extdofs.Size(), &lfact[first]);
+                                       FlatVector<TFACT> ext_lfact (extdofs.Size(), const_cast<TFACT*>(hlfact+first));
                                        
                                        TVX val(0.0);
                                        for (auto j : Range(extdofs))
-                                         val += ext_lfact(j) * temp(j);
+                                         val += TM(ext_lfact(j)) * temp(j);
                                        hy(i) -= val;
                                      }
                                  for (size_t i = range.end()-1; i-- > range.begin(); )
                                    {
                                      size_t size = range.end()-i-1;
                                      if (size == 0) continue;
-                                     FlatVector<TM> vlfact(size, &lfact[firstinrow[i]]);
+                                     FlatVector<TFACT> vlfact(size, const_cast<TFACT*>(hlfact+firstinrow[i]));
                                      auto hyr = hy.Range(i+1, range.end());
 
                                      TVX hyi = hy(i);
                                      for (size_t j = 0; j < vlfact.Size(); j++)
-                                       hyi -= vlfact(j) * hyr(j);
+                                       hyi -= TM(vlfact(j)) * hyr(j);
                                      hy(i) = hyi;
                                    }
                                  
@@ -1531,12 +1763,12 @@ namespace ngla
                                    {
                                      size_t size = range.end()-i-1;
                                      if (size == 0) continue;
-                                     FlatVector<TM> vlfact(size, &lfact[firstinrow[i]]);
+                                     FlatVector<TFACT> vlfact(size, const_cast<TFACT*>(hlfact+firstinrow[i]));
                                      auto hyr = hy.Range(i+1, range.end());
 
                                      TVX hyi = hy(i);
                                      for (size_t j = 0; j < vlfact.Size(); j++)
-                                       hyi -= vlfact(j) * hyr(j);
+                                       hyi -= TM(vlfact(j)) * hyr(j);
                                      hy(i) = hyi;
                                    }
 
@@ -1558,11 +1790,11 @@ namespace ngla
                                      for (auto i : range)
                                        {
                                          size_t first = firstinrow[i] + range.end()-i-1;
-                                         FlatVector<TM> ext_lfact (all_extdofs.Size(), &lfact[first]);
+                                         FlatVector<TFACT> ext_lfact (all_extdofs.Size(), const_cast<TFACT*>(hlfact+first));
     
                                          TVX val(0.0);
                                          for (auto j : Range(extdofs))
-                                           val += ext_lfact(myr.begin()+j) * temp(j);
+                                           val += TM(ext_lfact(myr.begin()+j)) * temp(j);
                                          MyAtomicAdd (hy(i), -val);
                                        }
                                    }
@@ -1580,7 +1812,7 @@ namespace ngla
   {
     static Timer timer("SparseCholesky<d,d,d>::MultAdd");
     RegionTimer reg (timer);
-    timer.AddFlops (2.0*lfact.Size());
+    timer.AddFlops (2.0*this->nze);
 
     // int n = Height();
     
@@ -1672,6 +1904,92 @@ namespace ngla
 
 
 
+#ifndef WIN32
+
+  ScratchFile :: ScratchFile (const string & dir, size_t asize)
+    : size(asize)
+  {
+    // unique name, no races between concurrent jobs
+    string templ = dir + "/ngs_scratch_XXXXXX";
+    Array<char> name(templ.size()+1);
+    strcpy (&name[0], templ.c_str());
+    fd = mkstemp (&name[0]);
+    if (fd == -1)
+      throw Exception (string("ScratchFile: cannot create file in ") + dir);
+    // the file disappears when closed, also after a crash
+    unlink (&name[0]);
+
+    if (size == 0) size = 1;
+    if (ftruncate (fd, size) != 0)
+      {
+        close (fd);
+        throw Exception (string("ScratchFile: cannot allocate ") + ToString(size) + " bytes in " + dir);
+      }
+
+    ptr = mmap (nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (ptr == MAP_FAILED)
+      {
+        close (fd);
+        throw Exception ("ScratchFile: mmap failed");
+      }
+  }
+
+  ScratchFile :: ~ScratchFile ()
+  {
+    munmap (ptr, size);
+    close (fd);
+  }
+
+  static size_t PageSize()
+  {
+    static size_t pagesize = sysconf(_SC_PAGESIZE);
+    return pagesize;
+  }
+
+  void ScratchFile :: WriteBack (size_t first, size_t next) const
+  {
+    first -= first % PageSize();
+    if (next <= first) return;
+#ifdef __linux__
+    sync_file_range (fd, first, next-first, SYNC_FILE_RANGE_WRITE);
+#else
+    msync ((char*)ptr+first, next-first, MS_ASYNC);
+#endif
+  }
+
+  void ScratchFile :: Evict (size_t first, size_t next) const
+  {
+    // only whole pages, neighbours may still be in use
+    first = (first + PageSize()-1) / PageSize() * PageSize();
+    next -= next % PageSize();
+    if (next <= first) return;
+    // dirty pages stay in the page cache until written, no data is lost
+    madvise ((char*)ptr+first, next-first, MADV_DONTNEED);
+    posix_fadvise (fd, first, next-first, POSIX_FADV_DONTNEED);
+  }
+
+  void ScratchFile :: Prefetch (size_t first, size_t next) const
+  {
+    first -= first % PageSize();
+    if (next <= first) return;
+    madvise ((char*)ptr+first, next-first, MADV_WILLNEED);
+  }
+
+#else
+
+  ScratchFile :: ScratchFile (const string & dir, size_t asize)
+  {
+    throw Exception ("ScratchFile: out-of-core storage not available on Windows");
+  }
+  ScratchFile :: ~ScratchFile () { ; }
+  void ScratchFile :: WriteBack (size_t first, size_t next) const { ; }
+  void ScratchFile :: Evict (size_t first, size_t next) const { ; }
+  void ScratchFile :: Prefetch (size_t first, size_t next) const { ; }
+
+#endif
+
+
+
   SparseFactorization ::     
   SparseFactorization (const BaseSparseMatrix & amatrix,
 		       shared_ptr<BitArray> ainner,
@@ -1829,7 +2147,7 @@ namespace ngla
 	for ( ; j < firstinrow[i]; j++, j_ri++)
 	  {
 	    ost << rowindex2[j_ri] << "("
-		<< lfact[j] 
+		<< (lfact_single.Size() ? TM(lfact_single[j]) : lfact[j])
 		<< ")  ";
 	  }
 	ost << endl;
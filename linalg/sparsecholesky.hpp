@@ -47,6 +47,32 @@ namespace ngla
 
 
 
+  /**
+     Storage in an (already unlinked) memory-mapped scratch file.
+     Used for the out-of-core mode of the sparse cholesky factorization,
+     the operating system pages the data in and out.
+     Positions are in bytes.
+  */
+  class NGS_DLL_HEADER ScratchFile
+  {
+    int fd;
+    void * ptr;
+    size_t size;
+  public:
+    ScratchFile (const string & dir, size_t asize);
+    ~ScratchFile ();
+
+    void * Data() const { return ptr; }
+    /// start writing back the range, returns immediately
+    void WriteBack (size_t first, size_t next) const;
+    /// drop the range from memory, it is read again from the file on access
+    void Evict (size_t first, size_t next) const;
+    /// start reading the range in background
+    void Prefetch (size_t first, size_t next) const;
+  };
+
+
+
   /**
      A sparse cholesky factorization.
      The unknowns are reordered by the minimum degree
@@ -75,7 +101,16 @@ namespace ngla
     
     // L-factor in compressed storage
     // Array<TM, size_t> lfact;
-    NumaInterleavedArray<TM> lfact;
+    FlatArray<TM> lfact;
+    // memory of lfact, in RAM ...
+    NumaInterleavedArray<TM> lfact_mem;
+    // ... or out-of-core (flag "outofcore")
+    unique_ptr<ScratchFile> lfact_file;
+    // single precision copy of lfact (flag "singleprecision"), lfact is freed
+    typedef typename std::conditional<std::is_same<TM,double>::value,float,TM>::type TSINGLE;
+    Array<TSINGLE> lfact_single;
+    // bytes of finished factor blocks kept in memory in out-of-core mode
+    size_t ooc_memory;
 
     // index-array to lfact
     Array<size_t> firstinrow;
@@ -124,6 +159,8 @@ namespace ngla
 
     // the original matrix
     const SparseMatrixTM<TM> & mat;
+    // solver options (ordering, outofcore, singleprecision)
+    Flags flags;
 
   public:
     typedef typename mat_traits<TM>::TSCAL TSCAL_MAT;
@@ -132,7 +169,8 @@ namespace ngla
     SparseCholeskyTM (const SparseMatrixTM<TM> & a, 
                       shared_ptr<BitArray> ainner = nullptr,
                       shared_ptr<const Array<int>> acluster = nullptr,
-                      bool allow_refactor = 0);
+                      bool allow_refactor = 0,
+                      const Flags & aflags = Flags());
     ///
     virtual ~SparseCholeskyTM ();
     ///
@@ -172,7 +210,11 @@ namespace ngla
 
     virtual void MemoryUsage (Array<MemoryUsageStruct*> & mu) const
     {
-      mu.Append (new MemoryUsageStruct ("SparseChol", nze*sizeof(TM), 1));
+      if (lfact_single.Size())
+        mu.Append (new MemoryUsageStruct ("SparseChol (single precision)", nze*sizeof(TSINGLE), 1));
+      else
+        mu.Append (new MemoryUsageStruct (lfact_file ? "SparseChol (out-of-core)" : "SparseChol",
+                                          nze*sizeof(TM), 1));
     }
 
     virtual size_t NZE () const { return nze; }
@@ -196,6 +238,19 @@ namespace ngla
       auto ext_size =  firstinrow[range.First()+1]-firstinrow[range.First()] - range.Size()+1;
       return rowindex2.Range(base, base+ext_size);
     }
+
+    // the entries of lfact belonging to block bnr
+    T_Range<size_t> BlockEntries (int bnr) const
+    { return T_Range<size_t> (firstinrow[blocks[bnr]], firstinrow[blocks[bnr+1]]); }
+
+    // out-of-core: prefetch blocks following bnr in direction dir (+1 or -1)
+    // up to the memory budget, and evict the block before bnr
+    void StreamBlocks (int bnr, int dir, int & prefetched) const;
+
+  protected:
+    void AllocateFactor ();
+    // replace lfact by its single precision copy
+    void ConvertFactorToSingle ();
   };
 
 
@@ -227,6 +282,9 @@ namespace ngla
     using BASE::block_dependency;
     using BASE::BlockDofs;
     using BASE::BlockExtDofs;
+    using BASE::BlockEntries;
+    using BASE::lfact_file;
+    using BASE::lfact_single;
   public:
     typedef TV_COL TV;
     typedef TV_ROW TVX;
@@ -236,8 +294,9 @@ namespace ngla
     SparseCholesky (const SparseMatrixTM<TM> & a, 
 		    shared_ptr<BitArray> ainner = nullptr,
 		    shared_ptr<const Array<int>> acluster = nullptr,
-		    bool allow_refactor = 0)
-      : SparseCholeskyTM<TM> (a, ainner, acluster, allow_refactor) { ; }
+		    bool allow_refactor = 0,
+                    const Flags & aflags = Flags())
+      : SparseCholeskyTM<TM> (a, ainner, acluster, allow_refactor, aflags) { ; }
 
     ///
     virtual ~SparseCholesky () { ; }
@@ -257,6 +316,9 @@ namespace ngla
     void SolveBlockT (int i, FlatVector<TV> hy) const;
   private:
     void SolveReordered(FlatVector<TVX> hy) const;
+    template <typename TFACT>
+    void SolveReordered(FlatVector<TVX> hy, const TFACT * hlfact) const;
+    void SolveReorderedOutOfCore(FlatVector<TVX> hy) const;
   };
 
 
@@ -110,6 +110,37 @@ namespace ngla
   }
 
 
+  MatrixGraph :: MatrixGraph (FlatArray<size_t> afirsti, FlatArray<int> acolnr, int awidth)
+  {
+    if (afirsti.Size() == 0)
+      throw Exception ("MatrixGraph: row pointer array must not be empty");
+    size = afirsti.Size()-1;
+    width = awidth;
+    nze = acolnr.Size();
+    owner = false;
+
+    firsti = Array<size_t> (afirsti.Size(), afirsti.Addr(0));
+    colnr = NumaDistributedArray<int> (acolnr.Size(), acolnr.Addr(0));
+
+    // lookup by bisection needs sorted column numbers
+    if (firsti[0] != 0 || firsti[size] != nze)
+      throw Exception ("MatrixGraph: row pointers don't match the column indices");
+    atomic<bool> valid(true);
+    ParallelFor (size, [&] (size_t i)
+                 {
+                   if (firsti[i+1] < firsti[i]) { valid = false; return; }
+                   for (size_t j = firsti[i]; j < firsti[i+1]; j++)
+                     if (colnr[j] < 0 || colnr[j] >= width ||
+                         (j > firsti[i] && colnr[j] <= colnr[j-1]))
+                       valid = false;
+                 });
+    if (!valid)
+      throw Exception ("MatrixGraph: column indices must be in range and sorted in every row");
+
+    CalcBalancing ();
+  }
+
+
 
   /*
   template <typename FUNC>
@@ -1191,6 +1222,13 @@ namespace ngla
       AddRowTransToVector (i, ConvertTo<TSCAL> (s)*fx(i), fy);
   }
 
+  template <class TM, class TV_ROW, class TV_COL>
+  void SparseMatrix<TM,TV_ROW,TV_COL> ::
+  MultAdd (double s, const MultiVector & x, MultiVector & y) const
+  {
+    BaseMatrix::MultAdd (s, x, y);
+  }
+
   
   template <class TM, class TV_ROW, class TV_COL>
   void SparseMatrix<TM,TV_ROW,TV_COL> :: DoArchive (Archive & ar)
@@ -1208,10 +1246,25 @@ namespace ngla
 
 
 
+  // the options of the built-in sparse cholesky, other solvers would ignore them
+  static void CheckInverseFlags (INVERSETYPE inversetype, const Flags & flags)
+  {
+    if (inversetype != SPARSECHOLESKY && flags.GetDefineFlag ("outofcore"))
+      throw Exception ("SparseMatrix::InverseMatrix: outofcore is supported by sparsecholesky only");
+  }
+
   template <class TM, class TV_ROW, class TV_COL>
   shared_ptr<BaseMatrix> SparseMatrix<TM,TV_ROW,TV_COL> ::
   InverseMatrix (shared_ptr<BitArray> subset) const
   {
+    return InverseMatrix (subset, Flags());
+  }
+
+  template <class TM, class TV_ROW, class TV_COL>
+  shared_ptr<BaseMatrix> SparseMatrix<TM,TV_ROW,TV_COL> ::
+  InverseMatrix (shared_ptr<BitArray> subset, const Flags & flags) const
+  {
+    CheckInverseFlags (this->GetInverseType(), flags);
     if ( this->GetInverseType() == SUPERLU_DIST )
       throw Exception ("SparseMatrix::InverseMatrix:  SuperLU_DIST_Inverse not available");
 
@@ -1248,7 +1301,7 @@ namespace ngla
 #endif
       }
     else
-      return make_shared<SparseCholesky<TM,TV_ROW,TV_COL>> (*this, subset);
+      return make_shared<SparseCholesky<TM,TV_ROW,TV_COL>> (*this, subset, nullptr, false, flags);
     //#endif
   }
 
@@ -1631,6 +1684,13 @@ namespace ngla
       }
   }
 
+  template <class TM, class TV>
+  void SparseMatrixSymmetric<TM,TV> :: 
+  MultAdd (double s, const MultiVector & x, MultiVector & y) const
+  {
+    BaseMatrix::MultAdd (s, x, y);
+  }
+
   template <class TM, class TV>
   void SparseMatrixSymmetric<TM,TV> :: 
   MultAdd1 (double s, const BaseVector & x, BaseVector & y,
@@ -2307,6 +2367,13 @@ namespace ngla
   template <class TM, class TV>
   shared_ptr<BaseMatrix> SparseMatrixSymmetric<TM,TV> :: InverseMatrix (shared_ptr<BitArray> subset) const
   {
+    return InverseMatrix (subset, Flags());
+  }
+
+  template <class TM, class TV>
+  shared_ptr<BaseMatrix> SparseMatrixSymmetric<TM,TV> :: InverseMatrix (shared_ptr<BitArray> subset, const Flags & flags) const
+  {
+    CheckInverseFlags (this->GetInverseType(), flags);
     if ( this->GetInverseType() == SUPERLU_DIST )
       throw Exception ("SparseMatrix::InverseMatrix:  SuperLU_DIST_Inverse not available");
 
@@ -2342,7 +2409,7 @@ namespace ngla
 #endif
       }
     else
-      return make_shared<SparseCholesky<TM,TV_ROW,TV_COL>> (*this, subset);
+      return make_shared<SparseCholesky<TM,TV_ROW,TV_COL>> (*this, subset, nullptr, false, flags);
   }
 
   template <class TM, class TV>
@@ -2477,6 +2544,134 @@ namespace ngla
 
 
 
+  /*
+    sums[j] = row * x[j] for a group of NJ vectors. The entries of the
+    vectors are interleaved (x[j](c) at px[c*dist+j]), such that every
+    matrix entry reads one cache line.
+   */
+  template <int NJ, typename TVALS>
+  INLINE void RowTimesMultiVector (FlatArray<int> cols, TVALS vals,
+                                   const double * px, size_t dist, double * sums)
+  {
+    double hsum[NJ];
+    for (int j = 0; j < NJ; j++) hsum[j] = 0;
+    for (size_t l = 0; l < cols.Size(); l++)
+      {
+        double val = vals(l);
+        const double * pxl = px + cols[l]*dist;
+        for (int j = 0; j < NJ; j++)
+          hsum[j] += val * pxl[j];
+      }
+    for (int j = 0; j < NJ; j++) sums[j] = hsum[j];
+  }
+
+  template <typename TVALS>
+  INLINE void RowTimesMultiVector (FlatArray<int> cols, TVALS vals,
+                                   FlatMatrix<double> xr, double * sums)
+  {
+    size_t k = xr.Width();
+    const double * px = &xr(0,0);
+    size_t j = 0;
+    for ( ; j+8 <= k; j += 8)
+      RowTimesMultiVector<8> (cols, vals, px+j, k, sums+j);
+    if (k-j >= 4)
+      {
+        RowTimesMultiVector<4> (cols, vals, px+j, k, sums+j);
+        j += 4;
+      }
+    if (k-j >= 2)
+      {
+        RowTimesMultiVector<2> (cols, vals, px+j, k, sums+j);
+        j += 2;
+      }
+    if (k-j >= 1)
+      RowTimesMultiVector<1> (cols, vals, px+j, k, sums+j);
+  }
+
+  // the vectors interleaved, row i of the matrix holds the entries i
+  static Matrix<double> InterleaveMultiVector (const MultiVector & x)
+  {
+    Matrix<double> xr(x.Size(), x.Num());
+    auto xm = x.AsMatrix();
+    ParallelForRange (x.Size(), [&] (IntRange r)
+                      { xr.Rows(r) = xm.Rows(r); });
+    return xr;
+  }
+
+  template <>
+  void SparseMatrix<double,double,double> ::
+  MultAdd (double s, const MultiVector & x, MultiVector & y) const
+  {
+    static Timer t("SparseMatrix::MultAdd (multi-vector)"); RegionTimer reg(t);
+    size_t k = x.Num();
+    if (y.Num() != k)
+      throw Exception ("SparseMatrix::MultAdd: different number of vectors");
+    if (k == 0) return;
+    t.AddFlops (this->NZE()*k);
+
+    Matrix<double> xr = InterleaveMultiVector (x);
+    ParallelForRange (balance, [&] (IntRange r)
+      {
+        ArrayMem<double,16> sums(k);
+        for (auto i : r)
+          {
+            RowTimesMultiVector (GetRowIndices(i), GetRowValues(i), xr, &sums[0]);
+            for (size_t j = 0; j < k; j++)
+              y[j](i) += s * sums[j];
+          }
+      });
+  }
+
+  template <>
+  void SparseMatrixSymmetric<double,double> ::
+  MultAdd (double s, const MultiVector & x, MultiVector & y) const
+  {
+    static Timer t("SparseMatrixSymmetric::MultAdd (multi-vector)"); RegionTimer reg(t);
+    size_t k = x.Num();
+    if (y.Num() != k)
+      throw Exception ("SparseMatrixSymmetric::MultAdd: different number of vectors");
+    if (k == 0) return;
+    t.AddFlops (2*this->NZE()*k);
+
+    // the lower triangle and the rows of its transpose, such that every row
+    // of y is written by one task only
+    {
+      static mutex trans_mutex;
+      lock_guard<mutex> guard(trans_mutex);
+      if (trans_cols.Size() != this->Height())
+        {
+          TableCreator<int> ccols(this->Height());
+          TableCreator<size_t> cpos(this->Height());
+          for ( ; !ccols.Done(); ccols++, cpos++)
+            for (size_t i = 0; i < this->Height(); i++)
+              for (size_t l = this->firsti[i]; l < this->firsti[i+1]; l++)
+                if (this->colnr[l] != int(i))
+                  {
+                    ccols.Add (this->colnr[l], i);
+                    cpos.Add (this->colnr[l], l);
+                  }
+          trans_cols = ccols.MoveTable();
+          trans_pos = cpos.MoveTable();
+        }
+    }
+
+    Matrix<double> xr = InterleaveMultiVector (x);
+    ParallelForRange (this->balance, [&] (IntRange r)
+      {
+        ArrayMem<double,16> sums(k), tsums(k);
+        for (auto i : r)
+          {
+            RowTimesMultiVector (GetRowIndices(i), GetRowValues(i), xr, &sums[0]);
+            FlatArray<size_t> pos = trans_pos[i];
+            RowTimesMultiVector (trans_cols[i], [&] (size_t l) { return this->data[pos[l]]; },
+                                 xr, &tsums[0]);
+            for (size_t j = 0; j < k; j++)
+              y[j](i) += s * (sums[j] + tsums[j]);
+          }
+      });
+  }
+
+
   template class SparseMatrix<double>;
   template class SparseMatrix<Complex>;
   template class SparseMatrix<double, Complex, Complex>;
@@ -106,6 +106,8 @@ namespace ngla
     MatrixGraph (int as, int max_elsperrow);    
     /// shadow matrix graph
     MatrixGraph (const MatrixGraph & graph, bool stealgraph);
+    /// graph on given CSR arrays, which are not copied and must outlive the graph
+    MatrixGraph (FlatArray<size_t> afirsti, FlatArray<int> acolnr, int awidth);
     /// 
     MatrixGraph (int size, const Table<int> & rowelements, const Table<int> & colelements, bool symmetric);
     /// 
@@ -182,6 +184,10 @@ namespace ngla
       : MatrixGraph (agraph, stealgraph)
     { ; }   
 
+    BaseSparseMatrix (FlatArray<size_t> afirsti, FlatArray<int> acolnr, int awidth)
+      : MatrixGraph (afirsti, acolnr, awidth)
+    { ; }   
+
     BaseSparseMatrix (const BaseSparseMatrix & amat)
       : BaseMatrix(amat), MatrixGraph (amat, 0)
     { ; }   
@@ -227,6 +233,13 @@ namespace ngla
       throw Exception ("BaseSparseMatrix::CreateInverse called");
     }
 
+    /// inverse with options for the direct solver, see Python docu of Inverse
+    virtual shared_ptr<BaseMatrix>
+      InverseMatrix (shared_ptr<BitArray> subset, const Flags & flags) const
+    { 
+      throw Exception ("BaseSparseMatrix::CreateInverse called");
+    }
+
     virtual shared_ptr<BaseSparseMatrix> Restrict (const SparseMatrixTM<double> & prol,
                                                    shared_ptr<BaseSparseMatrix> cmat = nullptr ) const
     {
@@ -301,6 +314,16 @@ namespace ngla
       AsVector() = amat.AsVector(); 
     }
 
+    /// matrix on external CSR arrays and values, nothing is copied
+    SparseMatrixTM (FlatArray<size_t> afirsti, FlatArray<int> acolnr,
+                    FlatVector<TM> avalues, int awidth)
+      : BaseSparseMatrix (afirsti, acolnr, awidth),
+        data(nze, avalues.Data()), nul(TSCAL(0))
+    {
+      if (avalues.Size() != nze)
+        throw Exception ("SparseMatrix: number of values does not match the column indices");
+    }
+
     static shared_ptr<SparseMatrixTM> CreateFromCOO (FlatArray<int> i, FlatArray<int> j,
                                                      FlatArray<TSCAL> val, size_t h, size_t w);
       
@@ -410,6 +433,11 @@ namespace ngla
     SparseMatrix (const SparseMatrixTM<TM> & amat)
       : SparseMatrixTM<TM> (amat) { ; }
 
+    /// matrix on external CSR arrays and values, nothing is copied
+    SparseMatrix (FlatArray<size_t> afirsti, FlatArray<int> acolnr,
+                  FlatVector<TM> avalues, int awidth)
+      : SparseMatrixTM<TM> (afirsti, acolnr, avalues, awidth) { ; }
+
     virtual shared_ptr<BaseMatrix> CreateMatrix () const override;
     // virtual BaseMatrix * CreateMatrix (const Array<int> & elsperrow) const;
     ///
@@ -434,6 +462,7 @@ namespace ngla
 
     virtual shared_ptr<BaseMatrix> InverseMatrix (shared_ptr<BitArray> subset = nullptr) const override;
     virtual shared_ptr<BaseMatrix> InverseMatrix (shared_ptr<const Array<int>> clusters) const override;
+    virtual shared_ptr<BaseMatrix> InverseMatrix (shared_ptr<BitArray> subset, const Flags & flags) const override;
 
     virtual shared_ptr<BaseSparseMatrix> Restrict (const SparseMatrixTM<double> & prol,
 					 shared_ptr<BaseSparseMatrix> cmat = nullptr) const override;
@@ -466,6 +495,8 @@ namespace ngla
     virtual void MultTransAdd (double s, const BaseVector & x, BaseVector & y) const override;
     virtual void MultAdd (Complex s, const BaseVector & x, BaseVector & y) const override;
     virtual void MultTransAdd (Complex s, const BaseVector & x, BaseVector & y) const override;
+    /// every matrix entry is loaded once for all vectors (real scalar matrices)
+    virtual void MultAdd (double s, const MultiVector & x, MultiVector & y) const override;
 
     virtual void MultAdd1 (double s, const BaseVector & x, BaseVector & y,
 			   const BitArray * ainner = NULL,
@@ -626,6 +657,17 @@ namespace ngla
       MultAdd (s, x, y);
     }
 
+    virtual void MultAdd (double s, const MultiVector & x, MultiVector & y) const override;
+
+  protected:
+    /// rows of the strict upper triangle: columns, and positions of the
+    /// values in the lower triangle. Built with the first multi-vector
+    /// product, the values are read from the matrix, so they stay valid
+    /// when the matrix is re-assembled with the same graph.
+    mutable Table<int> trans_cols;
+    mutable Table<size_t> trans_pos;
+
+  public:
 
     /*
       y += s L * x
@@ -681,6 +723,7 @@ namespace ngla
 
     virtual shared_ptr<BaseMatrix> InverseMatrix (shared_ptr<BitArray> subset = nullptr) const override;
     virtual shared_ptr<BaseMatrix> InverseMatrix (shared_ptr<const Array<int>> clusters) const override;
+    virtual shared_ptr<BaseMatrix> InverseMatrix (shared_ptr<BitArray> subset, const Flags & flags) const override;
   };
 
   shared_ptr<SparseMatrixTM<double>> TransposeMatrix (const SparseMatrixTM<double> & mat);
@@ -688,6 +731,11 @@ namespace ngla
   shared_ptr<SparseMatrixTM<double>>
   MatMult (const SparseMatrix<double, double, double> & mata, const SparseMatrix<double, double, double> & matb);
 
+  template <> void SparseMatrix<double,double,double> ::
+  MultAdd (double s, const MultiVector & x, MultiVector & y) const;
+  template <> void SparseMatrixSymmetric<double,double> ::
+  MultAdd (double s, const MultiVector & x, MultiVector & y) const;
+
 #ifdef GOLD
 #include <sparsematrix_spec.hpp>
 #endif
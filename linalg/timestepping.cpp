@@ -0,0 +1,408 @@
+/**************************************************************************/
+/* File:   timestepping.cpp                                               */
+/* Date:   Oct. 2026                                                      */
+/**************************************************************************/
+
+/*
+
+Time integration of linear systems of ODEs
+
+*/
+
+#include <la.hpp>
+
+namespace ngla
+{
+
+  ButcherTableau :: ButcherTableau (string name)
+  {
+    auto Set = [&] (int s, std::initializer_list<double> la,
+                    std::initializer_list<double> lb)
+      {
+        a.SetSize (s, s);
+        b.SetSize (s);
+        c.SetSize (s);
+        auto pa = la.begin();
+        for (int i = 0; i < s; i++)
+          for (int j = 0; j < s; j++)
+            a(i,j) = *pa++;
+        auto pb = lb.begin();
+        for (int i = 0; i < s; i++)
+          b(i) = *pb++;
+        for (int i = 0; i < s; i++)
+          {
+            c(i) = 0;
+            for (int j = 0; j < s; j++)
+              c(i) += a(i,j);
+          }
+      };
+
+    if (name == "euler")
+      Set (1, { 0 }, { 1 });
+    else if (name == "heun")
+      Set (2, { 0, 0,
+                1, 0 },
+           { 0.5, 0.5 });
+    else if (name == "ssprk3")
+      Set (3, { 0, 0, 0,
+                1, 0, 0,
+                0.25, 0.25, 0 },
+           { 1.0/6, 1.0/6, 2.0/3 });
+    else if (name == "rk4")
+      Set (4, { 0, 0, 0, 0,
+                0.5, 0, 0, 0,
+                0, 0.5, 0, 0,
+                0, 0, 1, 0 },
+           { 1.0/6, 1.0/3, 1.0/3, 1.0/6 });
+    else if (name == "implicit_euler")
+      Set (1, { 1 }, { 1 });
+    else if (name == "sdirk2")
+      {
+        // Alexander, L-stable, order 2
+        double g = 1 - sqrt(0.5);
+        Set (2, { g, 0,
+                  1-g, g },
+             { 1-g, g });
+      }
+    else if (name == "sdirk3")
+      {
+        // Alexander, L-stable, order 3
+        double g = 0.435866521508459;
+        double t2 = (1+g)/2;
+        double b1 = -(6*g*g-16*g+1)/4;
+        double b2 = (6*g*g-20*g+5)/4;
+        Set (3, { g, 0, 0,
+                  t2-g, g, 0,
+                  b1, b2, g },
+             { b1, b2, g });
+      }
+    else
+      throw Exception ("ButcherTableau: unknown method '" + name + "', available are "
+                       "euler, heun, ssprk3, rk4, implicit_euler, sdirk2, sdirk3");
+  }
+
+  bool ButcherTableau :: IsDiagonallyImplicit () const
+  {
+    for (int i = 0; i < Stages(); i++)
+      for (int j = i+1; j < Stages(); j++)
+        if (a(i,j) != 0) return false;
+    return true;
+  }
+
+
+
+  CachedInverse :: CachedInverse (Array<shared_ptr<BaseMatrix>> amats,
+                                  shared_ptr<BitArray> afreedofs, string ainversetype)
+    : mats(amats), freedofs(afreedofs), inversetype(ainversetype)
+  { ; }
+
+  const BaseMatrix & CachedInverse :: Get (FlatArray<double> coefs)
+  {
+    static Timer t("CachedInverse::Get - factor");
+    if (coefs.Size() != mats.Size())
+      throw Exception ("CachedInverse: number of coefficients does not match");
+
+    // most recently used entries are at the end
+    for (size_t i = 0; i < entries.Size(); i++)
+      if (entries[i]->coefs == coefs)
+        {
+          auto entry = entries[i];
+          entries.RemoveElement (i);
+          entries.Append (entry);
+          return *entry->inv;
+        }
+
+    RegionTimer reg(t);
+    shared_ptr<Entry> entry;
+    if (entries.Size() < maxentries)
+      entry = make_shared<Entry>();
+    else
+      {
+        // reuse the memory of the oldest system matrix
+        entry = entries[0];
+        entries.RemoveElement (0);
+        entry->inv = nullptr;
+      }
+
+    if (!entry->mat)
+      entry->mat = mats[0]->CreateMatrix();
+    BaseVector & sum = entry->mat->AsVector();
+    sum = 0.0;
+    for (size_t i = 0; i < mats.Size(); i++)
+      if (coefs[i] != 0)
+        {
+          const BaseVector & vi = mats[i]->AsVector();
+          if (vi.Size() != sum.Size())
+            throw Exception ("CachedInverse: matrices need the same sparsity pattern");
+          sum += coefs[i] * vi;
+        }
+
+    if (inversetype != "")
+      entry->mat->SetInverseType (inversetype);
+    entry->inv = entry->mat->InverseMatrix (freedofs);
+    entry->coefs = coefs;
+    nfactorizations++;
+
+    entries.Append (entry);
+    return *entry->inv;
+  }
+
+
+
+  size_t TimeStepper :: Integrate (BaseVector & u, double tend, double dt,
+                                   function<void(double)> callback)
+  {
+    static Timer timer("TimeStepper::Integrate"); RegionTimer reg(timer);
+    if (dt <= 0)
+      throw Exception ("TimeStepper: dt must be positive");
+
+    // equal steps, such that the factorizations can be reused
+    size_t n = size_t (ceil ((tend-t) / dt - 1e-10));
+    if (tend <= t) n = 0;
+    double h = n ? (tend-t) / n : 0;
+    double t0 = t;
+    for (size_t i = 0; i < n; i++)
+      {
+        Step (u, h);
+        t = t0 + (i+1) * h;
+        if (callback) callback (t);
+      }
+    return n;
+  }
+
+
+
+  BDF :: BDF (shared_ptr<BaseMatrix> am, shared_ptr<BaseMatrix> aa, TRHS arhs,
+              int aorder, shared_ptr<BitArray> freedofs, string inversetype)
+    : TimeStepper (am, aa, arhs), order(aorder),
+      inverse (Array<shared_ptr<BaseMatrix>> ({ am, aa }), freedofs, inversetype)
+  {
+    if (order < 1 || order > 3)
+      throw Exception ("BDF: order must be 1, 2 or 3");
+    // BDF1 startup steps would limit BDF3 to second order
+    if (order == 3)
+      startup = make_shared<RungeKutta> (am, aa, arhs, ButcherTableau("sdirk3"),
+                                         nullptr, freedofs, inversetype);
+    // BDF2 also factorizes the matrix of its implicit Euler startup step
+    inverse.SetMaxEntries (order == 2 ? 2 : 1);
+  }
+
+  void BDF :: Step (BaseVector & u, double dt)
+  {
+    static Timer timer("BDF::Step"); RegionTimer reg(timer);
+
+    if (!r)
+      {
+        r = u.CreateVector();
+        w = u.CreateVector();
+        du = u.CreateVector();
+        f = u.CreateVector();
+        history.SetSize (order-1);
+        for (auto & h : history)
+          h = u.CreateVector();
+      }
+    if (dt != lastdt) nhistory = 0;
+    lastdt = dt;
+
+    // u^{n-1} becomes the newest history entry
+    auto shift_history = [&] ()
+      {
+        if (order == 1) return;
+        auto last = history.Last();
+        for (int j = order-2; j > 0; j--)
+          history[j] = history[j-1];
+        history[0] = last;
+        *history[0] = u;
+        nhistory = min2 (nhistory+1, order-1);
+      };
+
+    if (startup && nhistory < order-1)
+      {
+        shift_history();
+        startup->SetTime (t);
+        startup->Step (u, dt);
+        t += dt;
+        steps++;
+        return;
+      }
+
+    // u^{n+1} = sum_j alpha_j u^{n-j} + beta dt u'^{n+1}
+    static const double alphas[3][3] =
+      { { 1, 0, 0 },
+        { 4.0/3, -1.0/3, 0 },
+        { 18.0/11, -9.0/11, 2.0/11 } };
+    static const double betas[3] = { 1, 2.0/3, 6.0/11 };
+    int k = min2 (order, nhistory+1);
+    const double * alpha = alphas[k-1];
+    double beta = betas[k-1];
+
+    // increment du = u^{n+1} - u^n:
+    // (M + beta dt A) du = M (sum_j alpha_j u^{n-j} - u^n) + beta dt (f - A u^n)
+    *w = (alpha[0]-1) * u;
+    for (int j = 1; j < k; j++)
+      *w += alpha[j] * *history[j-1];
+    *r = *m * *w;
+
+    EvaluateRHS (t+dt, *f);
+    *w = *f - *a * u;
+    *r += beta * dt * *w;
+
+    double coefs[] = { 1, beta*dt };
+    *du = inverse.Get (FlatArray<double> (2, coefs)) * *r;
+
+    shift_history();
+    u += *du;
+    t += dt;
+    steps++;
+  }
+
+
+
+  RungeKutta :: RungeKutta (shared_ptr<BaseMatrix> am, shared_ptr<BaseMatrix> aa, TRHS arhs,
+                            const ButcherTableau & atableau, shared_ptr<BaseMatrix> aminv,
+                            shared_ptr<BitArray> freedofs, string inversetype)
+    : TimeStepper (am, aa, arhs), tableau(atableau), minv(aminv),
+      inverse (Array<shared_ptr<BaseMatrix>> ({ am, aa }), freedofs, inversetype)
+  {
+    if (!tableau.IsDiagonallyImplicit())
+      throw Exception ("RungeKutta: only explicit and diagonally implicit methods");
+  }
+
+  void RungeKutta :: Step (BaseVector & u, double dt)
+  {
+    static Timer timer("RungeKutta::Step"); RegionTimer reg(timer);
+
+    int s = tableau.Stages();
+    if (!w)
+      {
+        w = u.CreateVector();
+        r = u.CreateVector();
+        f = u.CreateVector();
+        k.SetSize (s);
+        for (auto & ki : k)
+          ki = u.CreateVector();
+      }
+
+    for (int i = 0; i < s; i++)
+      {
+        *w = u;
+        for (int j = 0; j < i; j++)
+          if (tableau.a(i,j) != 0)
+            *w += (dt * tableau.a(i,j)) * *k[j];
+
+        EvaluateRHS (t + tableau.c(i)*dt, *f);
+        *r = *f - *a * *w;
+
+        double aii = tableau.a(i,i);
+        if (aii == 0 && minv)
+          *k[i] = *minv * *r;
+        else
+          {
+            double coefs[] = { 1, aii*dt };
+            *k[i] = inverse.Get (FlatArray<double> (2, coefs)) * *r;
+          }
+      }
+
+    for (int i = 0; i < s; i++)
+      if (tableau.b(i) != 0)
+        u += (dt * tableau.b(i)) * *k[i];
+    t += dt;
+    steps++;
+  }
+
+
+
+  GeneralizedAlpha :: GeneralizedAlpha (shared_ptr<BaseMatrix> am, shared_ptr<BaseMatrix> ac,
+                                        shared_ptr<BaseMatrix> aa, TRHS arhs, double rho_inf,
+                                        shared_ptr<BitArray> freedofs, string inversetype)
+    : TimeStepper (am, aa, arhs), c(ac),
+      inverse (ac ? Array<shared_ptr<BaseMatrix>> ({ am, aa, ac })
+               : Array<shared_ptr<BaseMatrix>> ({ am, aa }), freedofs, inversetype)
+  {
+    if (rho_inf < 0 || rho_inf > 1)
+      throw Exception ("GeneralizedAlpha: rho_inf must be in [0,1]");
+    double am_ = (2*rho_inf-1) / (rho_inf+1);
+    double af_ = rho_inf / (rho_inf+1);
+    SetParameters (am_, af_, 0.25 * sqr(1-am_+af_), 0.5-am_+af_);
+  }
+
+  void GeneralizedAlpha :: SetParameters (double aalpham, double aalphaf,
+                                          double abeta, double agamma)
+  {
+    alpham = aalpham;
+    alphaf = aalphaf;
+    beta = abeta;
+    gamma = agamma;
+  }
+
+  void GeneralizedAlpha :: Allocate (const BaseVector & u)
+  {
+    if (vel) return;
+    vel = u.CreateVector();
+    acc = u.CreateVector();
+    upred = u.CreateVector();
+    vpred = u.CreateVector();
+    w = u.CreateVector();
+    r = u.CreateVector();
+    f = u.CreateVector();
+    *vel = 0.0;
+    *acc = 0.0;
+  }
+
+  void GeneralizedAlpha :: SetVelocity (const BaseVector & v)
+  {
+    Allocate (v);
+    *vel = v;
+  }
+
+  void GeneralizedAlpha :: SetAcceleration (const BaseVector & aacc)
+  {
+    Allocate (aacc);
+    *acc = aacc;
+    has_acc = true;
+  }
+
+  void GeneralizedAlpha :: Step (BaseVector & u, double dt)
+  {
+    static Timer timer("GeneralizedAlpha::Step"); RegionTimer reg(timer);
+    Allocate (u);
+    int nmats = c ? 3 : 2;
+
+    if (!has_acc)
+      {
+        // M a = f - C v - A u
+        EvaluateRHS (t, *f);
+        *r = *f - *a * u;
+        if (c) *r -= *c * *vel;
+        double coefs[] = { 1, 0, 0 };
+        *acc = inverse.Get (FlatArray<double> (nmats, coefs)) * *r;
+        has_acc = true;
+      }
+
+    *upred = u + dt * *vel;
+    *upred += (dt*dt*(0.5-beta)) * *acc;
+    *vpred = *vel + (dt*(1-gamma)) * *acc;
+
+    // equation at t_{n+1-alpha_f}, with acc_{n+1-alpha_m}
+    EvaluateRHS (t + (1-alphaf)*dt, *f);
+    *r = *m * *acc;
+    *r *= -alpham;
+    *r += *f;
+    *w = (1-alphaf) * *upred + alphaf * u;
+    *r -= *a * *w;
+    if (c)
+      {
+        *w = (1-alphaf) * *vpred + alphaf * *vel;
+        *r -= *c * *w;
+      }
+
+    double coefs[] = { 1-alpham, (1-alphaf)*beta*dt*dt, (1-alphaf)*gamma*dt };
+    *acc = inverse.Get (FlatArray<double> (nmats, coefs)) * *r;
+
+    u = *upred + (beta*dt*dt) * *acc;
+    *vel = *vpred + (gamma*dt) * *acc;
+    t += dt;
+    steps++;
+  }
+
+}
@@ -0,0 +1,228 @@
+#ifndef FILE_TIMESTEPPING
+#define FILE_TIMESTEPPING
+
+/**************************************************************************/
+/* File:   timestepping.hpp                                               */
+/* Date:   Oct. 2026                                                      */
+/**************************************************************************/
+
+namespace ngla
+{
+
+  /**
+     Coefficients a, b, c of a Runge-Kutta method.
+
+     Explicit: "euler", "heun", "ssprk3", "rk4"
+     Diagonally implicit: "implicit_euler", "sdirk2", "sdirk3"
+   */
+  class NGS_DLL_HEADER ButcherTableau
+  {
+  public:
+    Matrix<double> a;
+    Vector<double> b, c;
+
+    ButcherTableau (string name);
+
+    int Stages () const { return b.Size(); }
+    /// a(i,j) = 0 for j > i
+    bool IsDiagonallyImplicit () const;
+  };
+
+
+
+  /**
+     Inverses of linear combinations  sum_i coefs[i] * mats[i]  of
+     assembled matrices with the same sparsity pattern.
+
+     A combination is assembled and factorized only for coefficients
+     not seen recently, as long as dt does not change the stages of a
+     time stepping method reuse their factorizations. The system matrices
+     of the last few coefficients are kept, the oldest one is overwritten
+     by a new combination.
+   */
+  class NGS_DLL_HEADER CachedInverse
+  {
+    struct Entry
+    {
+      Array<double> coefs;
+      shared_ptr<BaseMatrix> mat, inv;
+    };
+
+    Array<shared_ptr<BaseMatrix>> mats;
+    shared_ptr<BitArray> freedofs;
+    string inversetype;
+    Array<shared_ptr<Entry>> entries;
+    size_t maxentries = 2;
+    size_t nfactorizations = 0;
+
+  public:
+    CachedInverse (Array<shared_ptr<BaseMatrix>> amats,
+                   shared_ptr<BitArray> afreedofs = nullptr, string ainversetype = "");
+
+    /// number of kept factorizations
+    void SetMaxEntries (size_t n) { maxentries = max2 (n, size_t(1)); }
+
+    /// the inverse of sum coefs[i] * mats[i], restricted to the free dofs
+    const BaseMatrix & Get (FlatArray<double> coefs);
+
+    size_t GetNumFactorizations () const { return nfactorizations; }
+  };
+
+
+
+  /**
+     Base class for time integration of
+
+     M u' + A u = f(t)
+
+     or, for second order methods, of M u'' + C u' + A u = f(t).
+
+     The stepper holds the time and the history it needs (previous
+     solutions, velocity, acceleration); all work vectors are allocated
+     in the first step. Implicit solves use a CachedInverse with the
+     freedofs, so values of u on the other dofs are kept constant.
+   */
+  class NGS_DLL_HEADER TimeStepper
+  {
+  public:
+    /// f = f(t), the right hand side is zero if not set
+    typedef function<void(double,BaseVector&)> TRHS;
+
+  protected:
+    shared_ptr<BaseMatrix> m, a;
+    TRHS rhs;
+    double t = 0;
+    size_t steps = 0;
+    shared_ptr<BaseVector> f;
+
+    void EvaluateRHS (double time, BaseVector & hf) const
+    {
+      if (rhs)
+        rhs (time, hf);
+      else
+        hf = 0.0;
+    }
+
+  public:
+    TimeStepper (shared_ptr<BaseMatrix> am, shared_ptr<BaseMatrix> aa, TRHS arhs)
+      : m(am), a(aa), rhs(arhs) { ; }
+    virtual ~TimeStepper () { ; }
+
+    /// one step from GetTime() to GetTime()+dt
+    virtual void Step (BaseVector & u, double dt) = 0;
+
+    /**
+       Equidistant steps from the current time to tend, the step size
+       is at most dt. The callback is called after every step.
+       Returns the number of steps.
+     */
+    size_t Integrate (BaseVector & u, double tend, double dt,
+                      function<void(double)> callback = nullptr);
+
+    /// the time of the current solution, resets the history
+    void SetTime (double at) { t = at; Reset(); }
+    double GetTime () const { return t; }
+    size_t GetSteps () const { return steps; }
+
+    /// forget the history, e.g. after changing u
+    virtual void Reset () { ; }
+  };
+
+
+
+  class RungeKutta;
+
+  /**
+     Backward differentiation formulas of order 1 to 3 for constant
+     step size. The first steps, and every step after a change of dt,
+     build the history: BDF2 starts with one implicit Euler step, BDF3
+     with two SDIRK3 steps, such that the startup keeps the order.
+   */
+  class NGS_DLL_HEADER BDF : public TimeStepper
+  {
+    int order;
+    CachedInverse inverse;
+    /// startup steps of BDF3
+    shared_ptr<RungeKutta> startup;
+    /// u^{n-1}, u^{n-2}
+    Array<shared_ptr<BaseVector>> history;
+    int nhistory = 0;
+    double lastdt = 0;
+    shared_ptr<BaseVector> r, w, du;
+
+  public:
+    BDF (shared_ptr<BaseMatrix> am, shared_ptr<BaseMatrix> aa, TRHS arhs,
+         int aorder = 2, shared_ptr<BitArray> freedofs = nullptr, string inversetype = "");
+
+    virtual void Step (BaseVector & u, double dt) override;
+    virtual void Reset () override { nhistory = 0; }
+  };
+
+
+
+  /**
+     Runge-Kutta methods with explicit or diagonally implicit tableau.
+
+     Stage k_i solves  (M + a_ii dt A) k_i = f(t+c_i dt) - A (u + dt sum_{j<i} a_ij k_j).
+     All stages with the same a_ii share one factorization. For explicit
+     stages the given inverse of M is used (lumped, or block-diagonal for
+     DG), without it M is factorized once.
+   */
+  class NGS_DLL_HEADER RungeKutta : public TimeStepper
+  {
+    ButcherTableau tableau;
+    shared_ptr<BaseMatrix> minv;
+    CachedInverse inverse;
+    Array<shared_ptr<BaseVector>> k;
+    shared_ptr<BaseVector> w, r;
+
+  public:
+    RungeKutta (shared_ptr<BaseMatrix> am, shared_ptr<BaseMatrix> aa, TRHS arhs,
+                const ButcherTableau & atableau, shared_ptr<BaseMatrix> aminv = nullptr,
+                shared_ptr<BitArray> freedofs = nullptr, string inversetype = "");
+
+    virtual void Step (BaseVector & u, double dt) override;
+  };
+
+
+
+  /**
+     Generalized-alpha method (Chung, Hulbert) for
+
+     M u'' + C u' + A u = f(t)
+
+     The Newmark method is alpha_m = alpha_f = 0. Without given
+     acceleration, the initial acceleration is computed from the
+     equation in the first step.
+   */
+  class NGS_DLL_HEADER GeneralizedAlpha : public TimeStepper
+  {
+    shared_ptr<BaseMatrix> c;
+    double alpham, alphaf, beta, gamma;
+    CachedInverse inverse;
+    shared_ptr<BaseVector> vel, acc, upred, vpred, w, r;
+    bool has_acc = false;
+
+    void Allocate (const BaseVector & u);
+
+  public:
+    /// rho_inf in [0,1] is the spectral radius for dt -> infinity
+    GeneralizedAlpha (shared_ptr<BaseMatrix> am, shared_ptr<BaseMatrix> ac, shared_ptr<BaseMatrix> aa,
+                      TRHS arhs, double rho_inf = 1, shared_ptr<BitArray> freedofs = nullptr,
+                      string inversetype = "");
+
+    void SetParameters (double aalpham, double aalphaf, double abeta, double agamma);
+
+    void SetVelocity (const BaseVector & v);
+    void SetAcceleration (const BaseVector & acc);
+    /// nullptr before the first step
+    shared_ptr<BaseVector> GetVelocity () const { return vel; }
+    shared_ptr<BaseVector> GetAcceleration () const { return acc; }
+
+    virtual void Step (BaseVector & u, double dt) override;
+    virtual void Reset () override { has_acc = false; }
+  };
+
+}
+
+#endif
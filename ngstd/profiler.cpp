@@ -179,6 +179,266 @@ namespace ngstd
 
 
 
+  atomic<bool> HierarchicalProfiler::active{false};
+
+  namespace
+  {
+    struct ProfileNode
+    {
+      int timer = -1;
+      int parent = -1;
+      int first_child = -1;
+      int next_sibling = -1;
+      size_t count = 0;
+      /// inclusive time in nanoseconds
+      int64_t time = 0;
+      double flops = 0;
+      double bytes = 0;
+    };
+
+    struct ProfileFrame
+    {
+      int node;
+      int64_t start;
+    };
+
+    struct ProfileEvent
+    {
+      int timer;
+      int64_t start, stop;
+    };
+
+    /// data of one thread, node 0 is the root
+    struct ThreadProfile
+    {
+      int thread_id;
+      Array<ProfileNode> nodes;
+      Array<ProfileFrame> stack;
+      Array<ProfileEvent> events;
+    };
+
+    mutex hprof_mutex;
+    Array<shared_ptr<ThreadProfile>> hprof_threads;
+    thread_local ThreadProfile * hprof_my = nullptr;
+    bool hprof_record_events = false;
+    size_t hprof_max_events = 0;
+    std::chrono::steady_clock::time_point hprof_start = std::chrono::steady_clock::now();
+
+    inline int64_t ProfileTime ()
+    {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>
+        (std::chrono::steady_clock::now() - hprof_start).count();
+    }
+
+    ThreadProfile & MyThreadProfile ()
+    {
+      if (!hprof_my)
+        {
+          auto tp = make_shared<ThreadProfile>();
+          tp->thread_id = TaskManager::GetThreadId();
+          tp->nodes.Append (ProfileNode());
+          lock_guard<mutex> guard(hprof_mutex);
+          hprof_threads.Append (tp);
+          hprof_my = tp.get();
+        }
+      return *hprof_my;
+    }
+
+    /// innermost running region of the timer, or nullptr
+    ProfileNode * RunningNode (int timer)
+    {
+      auto & tp = MyThreadProfile();
+      for (int i = int(tp.stack.Size())-1; i >= 0; i--)
+        if (tp.nodes[tp.stack[i].node].timer == timer)
+          return &tp.nodes[tp.stack[i].node];
+      return nullptr;
+    }
+
+    void WriteJSONString (ostream & ost, const string & str)
+    {
+      ost << '"';
+      for (char c : str)
+        switch (c)
+          {
+          case '"': ost << "\\\""; break;
+          case '\\': ost << "\\\\"; break;
+          case '\n': ost << "\\n"; break;
+          case '\t': ost << "\\t"; break;
+          default:
+            if (static_cast<unsigned char>(c) < 0x20) ost << ' ';
+            else ost << c;
+          }
+      ost << '"';
+    }
+
+    void WriteJSONNode (ostream & ost, const ThreadProfile & tp, int nr, int indent)
+    {
+      const ProfileNode & node = tp.nodes[nr];
+      string ind(indent, ' ');
+
+      // children sorted by time, most expensive first
+      Array<int> children;
+      int64_t children_time = 0;
+      for (int c = node.first_child; c != -1; c = tp.nodes[c].next_sibling)
+        {
+          children.Append (c);
+          children_time += tp.nodes[c].time;
+        }
+      QuickSort (children, [&] (int a, int b) { return tp.nodes[a].time > tp.nodes[b].time; });
+
+      ost << ind << "{ \"name\": ";
+      WriteJSONString (ost, NgProfiler::GetName(node.timer));
+      ost << ", \"calls\": " << node.count
+          << ", \"time\": " << 1e-9 * node.time
+          << ", \"exclusive\": " << 1e-9 * (node.time - children_time)
+          << ", \"flops\": " << node.flops
+          << ", \"bytes\": " << node.bytes
+          << ", \"children\": [";
+      for (size_t i = 0; i < children.Size(); i++)
+        {
+          ost << (i ? ",\n" : "\n");
+          WriteJSONNode (ost, tp, children[i], indent+2);
+        }
+      if (children.Size()) ost << "\n" << ind;
+      ost << "] }";
+    }
+  }
+
+
+  void HierarchicalProfiler :: Enable (bool record_events, size_t max_events)
+  {
+    hprof_record_events = record_events;
+    hprof_max_events = max_events;
+    // regions still open from an earlier run are not closed anymore
+    for (auto & tp : hprof_threads)
+      tp->stack.SetSize0();
+    active = true;
+  }
+
+  void HierarchicalProfiler :: Disable ()
+  {
+    active = false;
+  }
+
+  void HierarchicalProfiler :: Reset ()
+  {
+    for (auto & tp : hprof_threads)
+      {
+        tp->nodes.SetSize (1);
+        tp->nodes[0] = ProfileNode();
+        tp->stack.SetSize0();
+        tp->events.SetSize0();
+      }
+    hprof_start = std::chrono::steady_clock::now();
+  }
+
+  void HierarchicalProfiler :: StartRegion (int timer)
+  {
+    auto & tp = MyThreadProfile();
+    int parent = tp.stack.Size() ? tp.stack.Last().node : 0;
+
+    int nr = tp.nodes[parent].first_child;
+    while (nr != -1 && tp.nodes[nr].timer != timer)
+      nr = tp.nodes[nr].next_sibling;
+    if (nr == -1)
+      {
+        nr = tp.nodes.Size();
+        ProfileNode node;
+        node.timer = timer;
+        node.parent = parent;
+        node.next_sibling = tp.nodes[parent].first_child;
+        tp.nodes.Append (node);
+        tp.nodes[parent].first_child = nr;
+      }
+    tp.stack.Append (ProfileFrame { nr, ProfileTime() });
+  }
+
+  void HierarchicalProfiler :: StopRegion (int timer)
+  {
+    auto & tp = MyThreadProfile();
+    int pos = int(tp.stack.Size())-1;
+    while (pos >= 0 && tp.nodes[tp.stack[pos].node].timer != timer)
+      pos--;
+    // started before the profiler was enabled
+    if (pos < 0) return;
+
+    // regions started later and not stopped yet are closed as well
+    int64_t now = ProfileTime();
+    for (int i = int(tp.stack.Size())-1; i >= pos; i--)
+      {
+        ProfileFrame frame = tp.stack[i];
+        ProfileNode & node = tp.nodes[frame.node];
+        node.count++;
+        node.time += now - frame.start;
+        if (hprof_record_events && tp.events.Size() < hprof_max_events)
+          tp.events.Append (ProfileEvent { node.timer, frame.start, now });
+      }
+    tp.stack.SetSize (pos);
+  }
+
+  void HierarchicalProfiler :: AddFlops (int timer, double flops)
+  {
+    if (auto node = RunningNode (timer))
+      node->flops += flops;
+  }
+
+  void HierarchicalProfiler :: AddBytes (int timer, double bytes)
+  {
+    if (auto node = RunningNode (timer))
+      node->bytes += bytes;
+  }
+
+  void HierarchicalProfiler :: WriteJSON (ostream & ost)
+  {
+    lock_guard<mutex> guard(hprof_mutex);
+    auto prec = ost.precision(15);
+    ost << "{ \"threads\": [";
+    bool first = true;
+    for (auto & tp : hprof_threads)
+      {
+        if (tp->nodes[0].first_child == -1) continue;
+        ost << (first ? "\n" : ",\n");
+        first = false;
+
+        ost << "  { \"thread\": " << tp->thread_id << ", \"regions\": [";
+        Array<int> roots;
+        for (int c = tp->nodes[0].first_child; c != -1; c = tp->nodes[c].next_sibling)
+          roots.Append (c);
+        QuickSort (roots, [&] (int a, int b) { return tp->nodes[a].time > tp->nodes[b].time; });
+        for (size_t i = 0; i < roots.Size(); i++)
+          {
+            ost << (i ? ",\n" : "\n");
+            WriteJSONNode (ost, *tp, roots[i], 4);
+          }
+        ost << "\n  ] }";
+      }
+    ost << "\n] }" << endl;
+    ost.precision(prec);
+  }
+
+  void HierarchicalProfiler :: WriteChromeTrace (ostream & ost)
+  {
+    lock_guard<mutex> guard(hprof_mutex);
+    auto prec = ost.precision(15);
+    ost << "{ \"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+    bool first = true;
+    for (auto & tp : hprof_threads)
+      for (auto & ev : tp->events)
+        {
+          ost << (first ? "\n" : ",\n");
+          first = false;
+          ost << "{ \"name\": ";
+          WriteJSONString (ost, NgProfiler::GetName(ev.timer));
+          ost << ", \"ph\": \"X\", \"pid\": 0, \"tid\": " << tp->thread_id
+              << ", \"ts\": " << 1e-3 * ev.start
+              << ", \"dur\": " << 1e-3 * (ev.stop - ev.start) << " }";
+        }
+    ost << "\n] }" << endl;
+    ost.precision(prec);
+  }
+
+
+
 #ifdef  VTRACE
 #ifdef PARALLEL
   Timer * Timer::stack_top = NULL;
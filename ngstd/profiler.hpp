@@ -59,6 +59,46 @@ namespace ngstd {
 namespace ngstd
 {
 
+  /**
+     Hierarchical profile, switched on at runtime.
+
+     A timer started while another one is running on the same thread is
+     recorded as its child, so a timer used at several call sites shows
+     up under each caller.  Every thread keeps its own tree with call
+     counts, inclusive and exclusive times, and the flops and bytes added
+     to running timers.  Optionally every region is also stored as an
+     event for the Chrome trace format (chrome://tracing, Perfetto).
+
+     Enable, Reset and the output functions must not be called while
+     parallel tasks are running.
+  */
+  class HierarchicalProfiler
+  {
+  public:
+    /// toggled from Python while worker threads read it
+    NGS_DLL_HEADER static atomic<bool> active;
+    static bool IsActive () { return active.load (memory_order_relaxed); }
+
+    /// starts recording, keeps at most max_events events per thread
+    NGS_DLL_HEADER static void Enable (bool record_events = false,
+                                       size_t max_events = 1000000);
+    NGS_DLL_HEADER static void Disable ();
+    /// clears the recorded data of all threads
+    NGS_DLL_HEADER static void Reset ();
+
+    NGS_DLL_HEADER static void StartRegion (int timer);
+    NGS_DLL_HEADER static void StopRegion (int timer);
+    /// adds to the innermost running region of this timer
+    NGS_DLL_HEADER static void AddFlops (int timer, double flops);
+    NGS_DLL_HEADER static void AddBytes (int timer, double bytes);
+
+    /// region trees of all threads, times in seconds
+    NGS_DLL_HEADER static void WriteJSON (ostream & ost);
+    /// recorded events, "complete" events with times in microseconds
+    NGS_DLL_HEADER static void WriteChromeTrace (ostream & ost);
+  };
+
+
 
   /**
      A built-in profile
@@ -269,6 +309,8 @@ namespace ngstd
     {
       if (priority <= 2) 
 	NgProfiler::StartTimer (timernr);
+      if (priority <= 2 && HierarchicalProfiler::IsActive())
+        HierarchicalProfiler::StartRegion (timernr);
       if (priority <= 1)
         if(trace) trace->StartTimer(timernr);
     }
@@ -276,6 +318,8 @@ namespace ngstd
     {
       if (priority <= 2) 
 	NgProfiler::StopTimer (timernr);
+      if (priority <= 2 && HierarchicalProfiler::IsActive())
+        HierarchicalProfiler::StopRegion (timernr);
       if (priority <= 1)
         if(trace) trace->StopTimer(timernr);
     }
@@ -283,6 +327,16 @@ namespace ngstd
     {
       if (priority <= 2)
 	NgProfiler::AddFlops (timernr, aflops);
+      if (priority <= 2 && HierarchicalProfiler::IsActive())
+        HierarchicalProfiler::AddFlops (timernr, aflops);
+    }
+    /// memory traffic, counted as loads
+    void AddBytes (double abytes)
+    {
+      if (priority <= 2)
+	NgProfiler::AddLoads (timernr, abytes);
+      if (priority <= 2 && HierarchicalProfiler::IsActive())
+        HierarchicalProfiler::AddBytes (timernr, abytes);
     }
 
     double GetTime () { return NgProfiler::GetTime(timernr); }
@@ -315,10 +369,16 @@ namespace ngstd
   public:
     /// start timer
     ThreadRegionTimer (size_t _nr, size_t _tid) : nr(_nr), tid(_tid)
-    { NgProfiler::StartThreadTimer(nr, tid); }
+    {
+      NgProfiler::StartThreadTimer(nr, tid);
+      if (HierarchicalProfiler::IsActive()) HierarchicalProfiler::StartRegion(nr);
+    }
     /// stop timer
     ~ThreadRegionTimer ()
-    { NgProfiler::StopThreadTimer(nr, tid); }
+    {
+      NgProfiler::StopThreadTimer(nr, tid);
+      if (HierarchicalProfiler::IsActive()) HierarchicalProfiler::StopRegion(nr);
+    }
   };
 
   class RegionTracer
@@ -426,6 +426,33 @@ void NGS_DLL_HEADER  ExportNgstd(py::module & m) {
 	   }
 	   );
 
+  py::class_<HierarchicalProfiler> (m, "HierarchicalProfiler",
+                                    "Records timers nested in each other as a tree per thread.\n"
+                                    "Switch on with Enable(), export with GetJSON(), WriteJSON()\n"
+                                    "or WriteChromeTrace() (chrome://tracing, Perfetto).")
+    .def_static("Enable", &HierarchicalProfiler::Enable,
+                py::arg("record_events")=false, py::arg("max_events")=1000000,
+                "start recording, with record_events also keep every region for a Chrome trace")
+    .def_static("Disable", &HierarchicalProfiler::Disable)
+    .def_static("Reset", &HierarchicalProfiler::Reset, "clear recorded data")
+    .def_static("GetJSON", [] ()
+                {
+                  stringstream str;
+                  HierarchicalProfiler::WriteJSON (str);
+                  return str.str();
+                }, "region trees of all threads as JSON string, times in seconds")
+    .def_static("WriteJSON", [] (string filename)
+                {
+                  ofstream out(filename);
+                  HierarchicalProfiler::WriteJSON (out);
+                })
+    .def_static("WriteChromeTrace", [] (string filename)
+                {
+                  ofstream out(filename);
+                  HierarchicalProfiler::WriteChromeTrace (out);
+                })
+    ;
+
   py::class_<Archive, shared_ptr<Archive>> (m, "Archive")
       /*
     .def("__init__", [](const string & filename, bool write,
@@ -1023,6 +1023,64 @@ namespace ngstd
 
 
 
+  // indexed load: (p[ind[0]], ..., p[ind[N-1]])
+  template <int N>
+  INLINE SIMD<double,N> Gather (const double * p, const int * ind)
+  {
+    double hv[N];
+    for (int i = 0; i < N; i++)
+      hv[i] = p[ind[i]];
+    return SIMD<double,N> (&hv[0]);
+  }
+
+#ifdef __AVX512F__
+  template <>
+  INLINE SIMD<double,8> Gather<8> (const double * p, const int * ind)
+  {
+    return _mm512_i32gather_pd (_mm256_loadu_si256 ((const __m256i*)ind), p, 8);
+  }
+#endif
+#ifdef __AVX2__
+  template <>
+  INLINE SIMD<double,4> Gather<4> (const double * p, const int * ind)
+  {
+    return _mm256_i32gather_pd (p, _mm_loadu_si128 ((const __m128i*)ind), 8);
+  }
+#endif
+
+  // load N consecutive values, single precision is converted to double
+  template <int N>
+  INLINE SIMD<double,N> LoadDouble (const double * p)
+  {
+    return SIMD<double,N> (p);
+  }
+
+  template <int N>
+  INLINE SIMD<double,N> LoadDouble (const float * p)
+  {
+    double hv[N];
+    for (int i = 0; i < N; i++)
+      hv[i] = p[i];
+    return SIMD<double,N> (&hv[0]);
+  }
+
+#ifdef __AVX512F__
+  template <>
+  INLINE SIMD<double,8> LoadDouble<8> (const float * p)
+  {
+    return _mm512_cvtps_pd (_mm256_loadu_ps (p));
+  }
+#endif
+#ifdef __AVX__
+  template <>
+  INLINE SIMD<double,4> LoadDouble<4> (const float * p)
+  {
+    return _mm256_cvtps_pd (_mm_loadu_ps (p));
+  }
+#endif
+
+
+
 #ifdef __AVX512F__
 #endif
 
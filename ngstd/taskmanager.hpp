@@ -919,9 +919,18 @@ public:
       }
   }
 
+  /// uses the memory adata, which is not freed
+  NumaDistributedArray (size_t s, T * adata)
+    : Array<T> (s, adata)
+  {
+    numa_size = 0;
+    numa_ptr = nullptr;
+  }
+
   ~NumaDistributedArray ()
   {
-    numa_free (numa_ptr, numa_size*sizeof(T));
+    if (numa_ptr)
+      numa_free (numa_ptr, numa_size*sizeof(T));
   }
 
   NumaDistributedArray & operator= (NumaDistributedArray && a2)
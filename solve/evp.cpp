@@ -25,7 +25,9 @@ namespace ngsolve
 
     string filename;
 
-    enum SOLVER { DENSE, ARNOLDI };
+    int maxsteps;
+
+    enum SOLVER { DENSE, ARNOLDI, LOBPCG };
     SOLVER solver;
 
   public:
@@ -63,14 +65,57 @@ namespace ngsolve
 
     filename = flags.GetStringFlag ("filename","eigen.out"); 
 
+    prec = flags.GetNumFlag ("prec", 1e-8);
+    maxsteps = int(flags.GetNumFlag ("maxsteps", 200));
+    print = flags.GetDefineFlag ("print");
+
     solver = ARNOLDI;
     if (flags.GetDefineFlag("dense")) solver = DENSE;
+    if (flags.GetDefineFlag("lobpcg")) solver = LOBPCG;
   }
 
 
 
   void NumProcEVP :: Do(LocalHeap & lh)
   {
+    if (solver == LOBPCG)
+      {
+        // preconditioned, no factorization of A - shift M needed
+        if (bfa->GetFESpace()->IsComplex())
+          throw Exception ("evp: lobpcg needs a real eigenvalue problem");
+
+        int nev = gfu->GetMultiDim();
+        auto & vec0 = gfu->GetVector(0);
+        if (vec0.EntrySize() != 1 || vec0.GetParallelStatus() != NOT_PARALLEL)
+          throw Exception ("evp: lobpcg needs sequential vectors with scalar entries");
+
+        ngla::LOBPCG lobpcg (bfa->GetMatrix(), bfm->GetMatrix(),
+                             pre ? &pre->GetMatrix() : nullptr,
+                             bfa->GetFESpace()->GetFreeDofs());
+        lobpcg.SetPrecision (prec);
+        lobpcg.SetMaxSteps (maxsteps);
+        lobpcg.SetPrintRates (print);
+
+        MultiVector x(vec0.Size(), nev);
+        for (int i = 0; i < nev; i++)
+          x.Vec(i).SetRandom();
+        Vector<double> lam;
+        int nconv = lobpcg.Calc (x, lam);
+        cout << nconv << " of " << nev << " eigenpairs converged in "
+             << lobpcg.GetSteps() << " steps" << endl;
+
+        ofstream eigenout(filename.c_str());
+        eigenout.precision(16);
+        for (int i = 0; i < lam.Size(); ++i)
+          eigenout << lam(i) << endl;
+
+        for (int i = 0; i < nev; i++)
+          gfu->GetVector(i).FV<double>() = x[i];
+
+        cout << "lam = " << endl << lam << endl;
+        return;
+      }
+
     if (solver == ARNOLDI)
       {
         cout << "new version using linalg - Arnoldi" << endl;
@@ -72,58 +72,42 @@ public:
   {
     cout << "solve hyperbolic pde" << endl;
       
-    // reference to the matrices provided by the bi-forms.
+    // the matrices provided by the bi-forms.
     // will be of type SparseSymmetricMatrix<double> for scalar problems
 
-    const BaseMatrix & mata = bfa->GetMatrix();
-    const BaseMatrix & matm = bfm->GetMatrix();
-    const BaseVector & vecf = lff->GetVector();
+    auto mata = bfa->GetMatrixPtr();
+    auto matm = bfm->GetMatrixPtr();
+    auto vecf = lff->GetVectorPtr();
     BaseVector & vecu = gfu->GetVector();
 
-    // creates a matrix of same type:
-    auto summat = matm.CreateMatrix();
-
-    // create additional vectors:
-    auto d = vecu.CreateVector();
-    auto w = vecu.CreateVector();
-    auto v = vecu.CreateVector();
-    auto a = vecu.CreateVector();
-    auto anew = vecu.CreateVector();
-
-
-    // matrices matm and mata have the same memory layout. The arrays of values 
-    // can be accessed and manipulated as vectors:
-
-    summat->AsVector() = matm.AsVector() + (dt*dt/4) * mata.AsVector();
-
-    // A sparse matrix can compute a sparse factorization. One has to cast to a sparse matrix:
-    // auto invmat = * dynamic_cast<BaseSparseMatrix&> (*summat) . InverseMatrix();
-    auto & invmat = * summat -> InverseMatrix();
-
-
-    // Newmark method
-    vecu = 0;
-    v = 0;
-    a = 0;
-
-    for (double t = 0; t <= tend; t += dt)
+    // the right hand side is switched off at t = 1. Newmark evaluates it at
+    // the end of a step, the switch is tested with the time at the beginning
+    // of the step, as in the original loop. h is the step of Integrate.
+    double h = tend / max2 (ceil (tend/dt - 1e-10), 1.0);
+    auto rhs = [vecf, h] (double t, BaseVector & f)
       {
-	cout << "t = " << t << endl;
+        double fac = (t-h < 1) ? 1 : 0;
+        f = fac * *vecf;
+      };
 
-	*w = vecu + dt * *v + (dt*dt/4) * *a;
+    // Newmark method, the generalized-alpha stepper with alpha_m = alpha_f = 0.
+    // It factorizes  M + dt^2/4 A  once, and reuses it as long as dt is not changed
+    GeneralizedAlpha newmark (matm, nullptr, mata, rhs);
+    newmark.SetParameters (0, 0, 0.25, 0.5);
 
-	double fac = (t < 1) ? 1 : 0;
-	*d = fac * vecf - mata * *w;
-	*anew = invmat * *d;
-	
-	vecu += dt * *v + (dt*dt/4) * *a + (dt*dt/4) * *anew;
-	*v += (dt/2) * *a + (dt/2) * *anew;
-
-	*a = *anew;
-
-	// update visualization
-	Ng_Redraw ();	  
-      }
+    vecu = 0;
+    auto zero = vecu.CreateVector();
+    *zero = 0;
+    newmark.SetVelocity (*zero);
+    newmark.SetAcceleration (*zero);
+
+    newmark.Integrate (vecu, tend, dt,
+                       [] (double t)
+                       {
+                         cout << "t = " << t << endl;
+                         // update visualization
+                         Ng_Redraw ();
+                       });
   }
 
 
@@ -1,4 +1,5 @@
 import pytest
+import re
 from netgen.geom2d import unit_square
 from netgen.csg import unit_cube
 from ngsolve import *
@@ -78,8 +79,59 @@ def test_code_generation_derivatives():
         vals -= vals_ref
         assert Norm(vals) < 1e-13
 
+def test_code_generation_cache():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    # identical code, the library is compiled once and shared
+    p1, p2 = Parameter(1), Parameter(2)
+    f1 = (p1*x*y).Compile(True, wait=True)
+    f2 = (p2*x*y).Compile(True, wait=True)
+    assert abs(Integrate(f1, mesh) - 0.25) < 1e-13
+    assert abs(Integrate(f2, mesh) - 0.5) < 1e-13
+    p1.Set(3)
+    assert abs(Integrate(f1, mesh) - 0.75) < 1e-13
+
+def test_code_generation_cse():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    # sqrt(x*x+y*y) is built twice, 2*3 is folded, *1 and +0 are removed
+    r1 = sqrt(x*x+y*y)
+    r2 = sqrt(x*x+y*y)
+    one, zero = CoefficientFunction(1), CoefficientFunction(0)
+    cf = (r1*r2 + (CoefficientFunction(2)*CoefficientFunction(3))*x) * one + zero + r1
+    for f in [cf.Compile(), cf.Compile(True, wait=True)]:
+        assert abs(Integrate((cf-f)*(cf-f), mesh)) < 1e-13
+    descr = str(cf.Compile())
+    counts = { key : int(val) for val, key in re.findall(r"(\d+) (duplicates|constants folded|trivial operations removed)", descr) }
+    # the four steps of r2 repeat those of r1
+    assert counts["duplicates"] >= 4
+    assert counts["constants folded"] >= 1
+    assert counts["trivial operations removed"] >= 1
+
+def test_code_generation_element_matrix_kernels():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    fes = H1(mesh, order=3)
+    u,v = fes.TnT()
+    forms = [grad(u)*grad(v), (1+x)*grad(u)*grad(v)+u*v, x*u*v+grad(u)[0]*v]
+    for form in forms:
+        aref = BilinearForm(fes)
+        aref += SymbolicBFI(form)
+        aref.Assemble()
+        a = BilinearForm(fes)
+        bfi = SymbolicBFI(form).Compile()
+        a += bfi
+        a.Assemble()
+        vals = a.mat.AsVector()
+        vals -= aref.mat.AsVector()
+        assert Norm(vals) < 1e-12 * Norm(aref.mat.AsVector())
+        # all contributions must come from compiled kernels, no silent fallback
+        calls = bfi.kernel_calls
+        assert calls["compiled"] > 0
+        assert calls["generic"] == 0
+
 if __name__ == "__main__":
     test_code_generation_derivatives()
     test_code_generation_volume_terms()
     test_code_generation_volume_terms_complex()
     test_code_generation_boundary_terms()
+    test_code_generation_cache()
+    test_code_generation_cse()
+    test_code_generation_element_matrix_kernels()
@@ -3,10 +3,9 @@ from netgen import meshing
 from netgen.csg import Pnt
 from ngsolve import *
     
-def test_convection1d_dg():
+def periodic_mesh_1d(nel):
     m = meshing.Mesh()
     m.dim = 1
-    nel = 20
     pnums = []
     for i in range(0, nel+1):
         pnums.append (m.Add (meshing.MeshPoint (Pnt(i/nel, 0, 0))))
@@ -17,8 +16,10 @@ def test_convection1d_dg():
     m.Add (meshing.Element0D (pnums[0], index=1))
     m.Add (meshing.Element0D (pnums[nel], index=2))
     m.AddPointIdentification(pnums[0],pnums[nel],identnr=1,type=2)
+    return Mesh (m)
 
-    mesh = Mesh (m)
+def test_convection1d_dg():
+    mesh = periodic_mesh_1d(20)
 
     fes = L2(mesh, order=4)
 
@@ -53,3 +54,57 @@ def test_convection1d_dg():
     l2error = sqrt(Integrate((u-u0)*(u-u0),mesh))
     print(l2error)
     assert l2error < 1e-2
+
+def compare_dg_convection_operator(mesh, order, b):
+    fes = L2(mesh, order=order)
+    u,v = fes.TrialFunction(), fes.TestFunction()
+    bn = b*specialcf.normal(mesh.dim)
+
+    a = BilinearForm(fes)
+    a += SymbolicBFI (-u * b*grad(v))
+    a += SymbolicBFI (bn*IfPos(bn, u, u.Other(bnd=0)) * v, element_boundary=True)
+    with TaskManager():
+        op = DGConvectionOperator(fes, b)
+
+    gfu = GridFunction(fes)
+    gfu.Set(sin(3*x)*(1+y)+x-z)
+    w1 = gfu.vec.CreateVector()
+    w2 = gfu.vec.CreateVector()
+    a.Apply (gfu.vec, w1)
+    with TaskManager():
+        w2.data = op * gfu.vec
+    w1.data -= w2
+    assert Norm(w1) < 1e-10 * Norm(w2)
+
+def test_dg_convection_operator():
+    from netgen.geom2d import unit_square
+    for quads in [False, True]:
+        mesh = Mesh(unit_square.GenerateMesh(maxh=0.2, quad_dominated=quads))
+        compare_dg_convection_operator(mesh, 3, CoefficientFunction((1, 0.3)))
+
+def test_dg_convection_operator_periodic():
+    from netgen.geom2d import SplineGeometry
+    compare_dg_convection_operator(periodic_mesh_1d(20), 4, CoefficientFunction((1,)))
+
+    periodic = SplineGeometry()
+    pnts = [ (0,0), (1,0), (1,1), (0,1) ]
+    pnums = [periodic.AppendPoint(*p) for p in pnts]
+    periodic.Append ( ["line", pnums[0], pnums[1]],bc="outer")
+    lright = periodic.Append ( ["line", pnums[1], pnums[2]], bc="periodic")
+    periodic.Append ( ["line", pnums[2], pnums[3]], bc="outer")
+    periodic.Append ( ["line", pnums[0], pnums[3]], leftdomain=0, rightdomain=1, copy=lright, bc="periodic")
+    mesh = Mesh(periodic.GenerateMesh(maxh=0.2))
+    compare_dg_convection_operator(mesh, 3, CoefficientFunction((1, 0.3)))
+
+def test_dg_convection_operator_curved():
+    from netgen.geom2d import SplineGeometry
+    geo = SplineGeometry()
+    geo.AddCircle((0,0), 1)
+    mesh = Mesh(geo.GenerateMesh(maxh=0.3))
+    mesh.Curve(3)
+    compare_dg_convection_operator(mesh, 3, CoefficientFunction((1+y, 0.3-x)))
+
+def test_dg_convection_operator_3d():
+    from netgen.csg import unit_cube
+    mesh = Mesh(unit_cube.GenerateMesh(maxh=0.4))
+    compare_dg_convection_operator(mesh, 2, CoefficientFunction((1, 0.3, 0.2)))
@@ -32,3 +32,24 @@ def test_GetFE():
                 for el in space.Elements(vb):
                     assert space.GetFE(el).ndof == len(space.GetDofNrs(el)), [spacename,vb,order]
                     
+
+def test_l2_projection():
+    # triangles have diagonal mass matrices, general quads use cached Cholesky factors
+    for quads in [False, True]:
+        mesh = Mesh(unit_square.GenerateMesh(maxh=0.2, quad_dominated=quads))
+        fes = L2(mesh, order=3)
+        gfu = GridFunction(fes)
+        with TaskManager():
+            gfu.Set(x*x*y-2*y+x)
+        assert Integrate((gfu-(x*x*y-2*y+x))**2, mesh) < 1e-20
+
+        u,v = fes.TrialFunction(), fes.TestFunction()
+        m = BilinearForm(fes)
+        m += SymbolicBFI(u*v)
+        m.Assemble()
+        w = gfu.vec.CreateVector()
+        w.data = m.mat * gfu.vec
+        with TaskManager():
+            fes.SolveM(rho=CoefficientFunction(2), vec=w)
+        w.data -= 0.5 * gfu.vec
+        assert Norm(w) < 1e-10 * Norm(gfu.vec)
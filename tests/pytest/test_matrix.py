@@ -99,7 +99,56 @@ def test_sparsematrix_access():
     a.Assemble()
     assert abs(a.mat[1,1][0,0] - (reference_values[3])) < 1e-8
 
+def test_sellmatrix():
+    mesh = Mesh("square.vol.gz")
+    fes = H1(mesh, order=3)
+    u,v = fes.TrialFunction(), fes.TestFunction()
+    b = CoefficientFunction((1,0.5))
+    for symmetric, form in [(True, grad(u)*grad(v)+u*v), (False, grad(u)*grad(v)+b*grad(u)*v)]:
+        a = BilinearForm(fes, symmetric=symmetric)
+        a += SymbolicBFI(form)
+        a.Assemble()
+        x, y1, y2 = a.mat.CreateColVector(), a.mat.CreateColVector(), a.mat.CreateColVector()
+        x.SetRandom()
+        y1.data = a.mat * x
+        for sigma in [1, 256]:
+            y2.data = SELLMatrix(a.mat, sigma=sigma) * x
+            y2.data -= y1
+            assert Norm(y2) < 1e-12 * Norm(y1)
+
+def test_sparsematrix_numpy_views():
+    mesh = Mesh("square.vol.gz")
+    fes = H1(mesh, order=2)
+    u,v = fes.TrialFunction(), fes.TestFunction()
+    a = BilinearForm(fes)
+    a += SymbolicBFI(grad(u)*grad(v)+u*v)
+    a.Assemble()
+
+    vals, cols, indptr = a.mat.CSR()
+    assert len(indptr) == a.mat.height+1 and len(vals) == len(cols) == indptr[-1]
+    vals[0] = 17                      # views share the memory of the matrix
+    assert a.mat[0,cols[0]] == 17
+    rows, cols2, vals2 = a.mat.COO()
+    assert vals2[0] == 17 and all(cols2 == cols)
+
+    # matrix on numpy arrays, without copying them
+    vals = vals.copy()
+    mat = type(a.mat).CreateFromCSR(indptr.astype(np.int64), cols.copy(), vals)
+    x, y1, y2 = a.mat.CreateColVector(), a.mat.CreateColVector(), a.mat.CreateColVector()
+    x.NumPy()[:] = np.arange(len(x))
+    y1.data = a.mat * x
+    y2.data = mat * x
+    assert np.linalg.norm(y1.NumPy()-y2.NumPy()) < 1e-12
+    vals *= 2
+    y2.data = mat * x
+    assert np.linalg.norm(2*y1.NumPy()-y2.NumPy()) < 1e-10
+
+    with pytest.raises(Exception):
+        type(a.mat).CreateFromCSR(indptr, cols.astype(np.int64), vals)
+
 if __name__ == "__main__":
     test_matrix()
     test_matrix_numpy()
     test_sparsematrix_access()
+    test_sellmatrix()
+    test_sparsematrix_numpy_views()
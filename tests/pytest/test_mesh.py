@@ -13,3 +13,102 @@ def test_multiple_meshes_refine():
 
     for v in range(mesh.nv):
         assert parents[v] == mesh.GetParentVertices(v)
+
+def test_batch_point_evaluation():
+    import numpy as np
+    from netgen.geom2d import unit_square
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    fes = H1(mesh, order=3, complex=True)
+    gfu = GridFunction(fes)
+    gfu.Set((1+2j)*x*x*y)
+
+    xs = np.linspace(-0.1, 1.1, 50)
+    np.random.seed(4711)
+    ys = np.random.rand(50)
+    with TaskManager():
+        pts = mesh(xs, ys)
+        vals = pts.Evaluate(CoefficientFunction((x, y, x*y)))
+        cvals = pts.Evaluate(gfu)
+    inside = (xs >= 0) & (xs <= 1)
+    assert len(pts) == 50
+    assert pts.found == np.count_nonzero(inside)
+    assert all((pts.elementnumbers >= 0) == inside)
+    assert vals.shape == (50, 3)
+    assert np.allclose(vals[inside,0], xs[inside])
+    assert np.allclose(vals[inside,1], ys[inside])
+    assert np.allclose(vals[inside,2], xs[inside]*ys[inside])
+    assert np.all(vals[~inside] == 0)
+    assert np.allclose(cvals[inside], (1+2j)*xs[inside]**2*ys[inside])
+
+    # single points still give a MappedIntegrationPoint
+    assert abs(gfu(mesh(0.5, 0.5)) - (1+2j)*0.125) < 1e-12
+
+def test_point_search():
+    import numpy as np
+    from netgen.geom2d import unit_square, SplineGeometry
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.1))
+    np.random.seed(4711)
+    xs, ys = np.random.rand(1000), np.random.rand(1000)
+    with TaskManager():
+        pts = mesh(xs, ys)
+    assert pts.found == 1000
+    # the parallel search gives the same elements as the single point search
+    for i in range(0, 1000, 50):
+        assert mesh(xs[i], ys[i]).elementid.nr == pts.elementnumbers[i]
+
+    # surface elements
+    bnd = mesh(np.array([0.5, 1.0, 0.3]), np.array([0.0, 0.25, 0.7]), VOL_or_BND=BND)
+    assert list(bnd.elementnumbers >= 0) == [True, True, False]
+
+    # points on the circle are slightly outside of the straight boundary
+    geo = SplineGeometry()
+    geo.AddCircle((0,0), 1)
+    mesh = Mesh(geo.GenerateMesh(maxh=0.2))
+    phi = np.linspace(0, 2*np.pi, 100, endpoint=False)
+    onboundary = mesh(np.cos(phi), np.sin(phi))
+    assert onboundary.found < 100
+    mesh.SetPointSearchTolerance(0.1)
+    onboundary = mesh(np.cos(phi), np.sin(phi))
+    assert onboundary.found == 100
+    assert not mesh.Contains(1.5, 0)
+
+def test_point_search_deformation():
+    from netgen.geom2d import unit_square
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    deform = GridFunction(H1(mesh, order=2, dim=2))
+    mesh.SetDeformation(deform)
+    assert mesh.Contains(0.5, 0.5)
+    assert not mesh.Contains(1.3, 0.5)
+    # the deformation is changed in place, as in ALE time stepping
+    deform.Set((0.5, 0))
+    assert mesh.Contains(1.3, 0.5)
+    assert not mesh.Contains(0.2, 0.5)
+    # a curved deformation of straight elements
+    deform.vec[:] = 0
+    deform.Set((0, 0.3*x*(1-x)))
+    assert mesh.Contains(0.5, 1.05)
+
+def test_transfer_matrix():
+    from netgen.geom2d import unit_square
+    mesh1 = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    mesh2 = Mesh(unit_square.GenerateMesh(maxh=0.13))
+    for space in [H1, L2]:
+        fes1 = space(mesh1, order=2)
+        fes2 = space(mesh2, order=2)
+        gf1 = GridFunction(fes1)
+        gf2 = GridFunction(fes2)
+        with TaskManager():
+            mat = TransferMatrix(fes1, fes2)
+        # polynomials of the order are transferred exactly
+        gf1.Set(x*x-x*y+3*y)
+        gf2.vec.data = mat * gf1.vec
+        assert Integrate((gf2-(x*x-x*y+3*y))**2, mesh2) < 1e-20
+
+        # the same as Set with the GridFunction as coefficient
+        gf1.Set(sin(3*x)*exp(y))
+        gf2.vec.data = mat * gf1.vec
+        gfset = GridFunction(fes2)
+        gfset.Set(gf1)
+        diff = gf2.vec.CreateVector()
+        diff.data = gf2.vec - gfset.vec
+        assert Norm(diff) < 1e-10 * Norm(gfset.vec)
@@ -183,6 +183,27 @@ def test_pickle_periodic():
     assert sqrt(Integrate((u-u2)*(u-u2),mesh)) < 1e-14
 
 
+def test_checkpoint_gridfunction(tmpdir):
+    import os, pytest
+    filename = os.path.join(str(tmpdir), "u.ckpt")
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.3))
+    for fes in [H1(mesh,order=3), HCurl(mesh,order=2,complex=True)]:
+        u = GridFunction(fes, multidim=2)
+        u.vecs[0].SetRandom()
+        u.vecs[1].SetRandom()
+        u.SaveCheckpoint(filename)
+
+        for mmap in [False, True]:
+            u2 = GridFunction(fes, multidim=2)
+            u2.LoadCheckpoint(filename, mmap=mmap)
+            for i in range(2):
+                u2.vecs[i].data -= u.vecs[i]
+                assert Norm(u2.vecs[i]) == 0
+
+    with pytest.raises(Exception):
+        GridFunction(H1(mesh,order=2), multidim=2).LoadCheckpoint(filename)
+
+
 if __name__ == "__main__":
     test_pickle_volume_fespaces()
     test_pickle_surface_fespaces()
@@ -191,3 +212,5 @@ if __name__ == "__main__":
     test_pickle_compoundfespace()
     test_pickle_hcurl()
     test_pickle_periodic()
+    import tempfile
+    test_checkpoint_gridfunction(tempfile.mkdtemp())
@@ -0,0 +1,43 @@
+import json
+from netgen.geom2d import unit_square
+from ngsolve import *
+
+def find(regions, name):
+    for r in regions:
+        if r["name"] == name:
+            return r
+        found = find(r["children"], name)
+        if found:
+            return found
+    return None
+
+def test_hierarchical_profiler():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    fes = H1(mesh, order=2)
+    u,v = fes.TrialFunction(), fes.TestFunction()
+    a = BilinearForm(fes)
+    a += SymbolicBFI(grad(u)*grad(v))
+
+    HierarchicalProfiler.Reset()
+    HierarchicalProfiler.Enable()
+    a.Assemble()
+    a.Assemble()
+    HierarchicalProfiler.Disable()
+
+    threads = json.loads(HierarchicalProfiler.GetJSON())["threads"]
+    main = [t for t in threads if t["thread"] == 0][0]
+    assembling = find(main["regions"], "Matrix assembling")
+    assert assembling["calls"] == 2
+    assert 0 <= assembling["exclusive"] <= assembling["time"]
+    assert sum(c["time"] for c in assembling["children"]) <= assembling["time"]
+    assert find(assembling["children"], "Matrix assembling vol")
+
+    # nothing recorded while disabled
+    a.Assemble()
+    threads = json.loads(HierarchicalProfiler.GetJSON())["threads"]
+    main = [t for t in threads if t["thread"] == 0][0]
+    assert find(main["regions"], "Matrix assembling")["calls"] == 2
+    HierarchicalProfiler.Reset()
+
+if __name__ == "__main__":
+    test_hierarchical_profiler()
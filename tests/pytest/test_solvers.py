@@ -43,6 +43,405 @@ def test_arnoldi():
     Draw(laplace(evec),mesh,"laplace")
 
 
+def test_sparsecholesky_outofcore():
+    from netgen.csg import unit_cube
+    mesh = Mesh(unit_cube.GenerateMesh(maxh=0.3))
+    fes = H1(mesh, order=3, dirichlet=".*")
+    u,v = fes.TrialFunction(), fes.TestFunction()
+    a = BilinearForm(fes, symmetric=True)
+    a += SymbolicBFI(grad(u)*grad(v))
+    f = LinearForm(fes)
+    f += SymbolicLFI(v)
+    a.Assemble()
+    f.Assemble()
+
+    gfu = GridFunction(fes)
+    gfu.vec.data = a.mat.Inverse(fes.FreeDofs(), inverse="sparsecholesky") * f.vec
+    # an in-core budget of 10 kB evicts almost all blocks of the factor
+    inv = a.mat.Inverse(fes.FreeDofs(), inverse="sparsecholesky",
+                        flags={"outofcore" : True, "outofcore_memory" : 0.01})
+    res = f.vec.CreateVector()
+    res.data = gfu.vec - inv * f.vec
+    assert Norm(res) < 1e-10 * Norm(gfu.vec)
+
+    with pytest.raises(Exception):
+        a.mat.Inverse(fes.FreeDofs(), inverse="umfpack", flags={"outofcore" : True})
+
+
+def test_sparsecholesky_ordering():
+    from netgen.csg import unit_cube
+    mesh = Mesh(unit_cube.GenerateMesh(maxh=0.3))
+    fes = H1(mesh, order=3, dirichlet=".*")
+    u,v = fes.TrialFunction(), fes.TestFunction()
+    a = BilinearForm(fes, symmetric=True)
+    a += SymbolicBFI(grad(u)*grad(v))
+    f = LinearForm(fes)
+    f += SymbolicLFI(v)
+    a.Assemble()
+    f.Assemble()
+
+    gfu = GridFunction(fes)
+    gfu.vec.data = a.mat.Inverse(fes.FreeDofs(), inverse="sparsecholesky") * f.vec
+    for ordering in ["mindegree", "nesteddissection"]:
+        inv = a.mat.Inverse(fes.FreeDofs(), inverse="sparsecholesky", flags={"ordering" : ordering})
+        res = f.vec.CreateVector()
+        res.data = gfu.vec - inv * f.vec
+        assert Norm(res) < 1e-10 * Norm(gfu.vec)
+
+
+def test_singleprecision_preconditioners():
+    from netgen.csg import unit_cube
+    mesh = Mesh(unit_cube.GenerateMesh(maxh=0.3))
+    fes = H1(mesh, order=3, dirichlet=".*")
+    u,v = fes.TrialFunction(), fes.TestFunction()
+    a = BilinearForm(fes, symmetric=True)
+    a += SymbolicBFI(grad(u)*grad(v))
+    f = LinearForm(fes)
+    f += SymbolicLFI(v)
+    a.Assemble()
+    f.Assemble()
+
+    gfu = GridFunction(fes)
+    gfu.vec.data = a.mat.Inverse(fes.FreeDofs(), inverse="sparsecholesky") * f.vec
+
+    # single precision factor as preconditioner, CG recovers double accuracy
+    pre = a.mat.Inverse(fes.FreeDofs(), inverse="sparsecholesky", flags={"singleprecision" : True})
+    res = f.vec.CreateVector()
+    res.data = gfu.vec - pre * f.vec
+    assert Norm(res) < 1e-5 * Norm(gfu.vec)
+    inv = CGSolver(a.mat, pre, printrates=False, precision=1e-12, maxsteps=20)
+    res.data = gfu.vec - inv * f.vec
+    assert Norm(res) < 1e-9 * Norm(gfu.vec)
+
+    # block smoothers of the symmetric and the non-symmetric matrix
+    ans = BilinearForm(fes, symmetric=False)
+    ans += SymbolicBFI(grad(u)*grad(v))
+    ans.Assemble()
+    blocks = [[d] for d in range(fes.ndof) if fes.FreeDofs()[d]]
+    blocks += [[d for d in el.dofs if fes.FreeDofs()[d]] for el in fes.Elements(VOL)][::10]
+    w = f.vec.CreateVector()
+    for mat in [a.mat, ans.mat]:
+        bjac = mat.CreateBlockSmoother(blocks)
+        bjacf = mat.CreateBlockSmoother(blocks, singleprecision=True)
+        w.data = bjac * f.vec
+        res.data = w - bjacf * f.vec
+        assert Norm(res) < 1e-5 * Norm(w)
+
+
+def test_pipelined_cg():
+    from netgen.csg import unit_cube
+    mesh = Mesh(unit_cube.GenerateMesh(maxh=0.3))
+    fes = H1(mesh, order=3, dirichlet=".*")
+    u,v = fes.TrialFunction(), fes.TestFunction()
+    a = BilinearForm(fes, symmetric=True)
+    a += SymbolicBFI(grad(u)*grad(v))
+    f = LinearForm(fes)
+    f += SymbolicLFI(v)
+    c = Preconditioner(a, "local")
+    a.Assemble()
+    f.Assemble()
+
+    gfu = GridFunction(fes)
+    gfu.vec.data = a.mat.Inverse(fes.FreeDofs()) * f.vec
+    cg = CGSolver(a.mat, c.mat, printrates=False, precision=1e-12, maxsteps=500)
+    res = f.vec.CreateVector()
+    for inv in [PipelinedCGSolver(a.mat, c.mat, printrates=False, precision=1e-12, maxsteps=500),
+                SStepCGSolver(a.mat, c.mat, s=4, printrates=False, precision=1e-12, maxsteps=500)]:
+        res.data = gfu.vec - inv * f.vec
+        assert Norm(res) < 1e-8 * Norm(gfu.vec)
+        res.data = cg * f.vec
+        assert inv.GetSteps() <= cg.GetSteps() + 8
+
+def test_gmres_qmr():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.1))
+    fes = H1(mesh, order=2)
+    u,v = fes.TrialFunction(), fes.TestFunction()
+    b = CoefficientFunction((10,3))
+    a = BilinearForm(fes)
+    a += SymbolicBFI(grad(u)*grad(v)+b*grad(u)*v+u*v)
+    f = LinearForm(fes)
+    f += SymbolicLFI(v)
+    a.Assemble()
+    f.Assemble()
+    pre = a.mat.CreateSmoother()
+
+    x = f.vec.CreateVector()
+    res = f.vec.CreateVector()
+    for inv in [GMRESSolver(a.mat, pre, printrates=False, precision=1e-12, maxsteps=1000),
+                QMRSolver(a.mat, pre, printrates=False, precision=1e-12, maxsteps=1000)]:
+        x.data = inv * f.vec
+        res.data = f.vec - a.mat * x
+        assert Norm(res) < 1e-8 * Norm(f.vec)
+
+def test_lobpcg():
+    from math import pi
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.1))
+    fes = H1(mesh, order=4, dirichlet=".*")
+    u,v = fes.TrialFunction(), fes.TestFunction()
+    a = BilinearForm(fes)
+    a += SymbolicBFI(grad(u)*grad(v))
+    m = BilinearForm(fes)
+    m += SymbolicBFI(u*v)
+    pre = Preconditioner(a, "local")
+    a.Assemble()
+    m.Assemble()
+
+    exact = [2*pi**2, 5*pi**2, 5*pi**2, 8*pi**2]
+    gfu = GridFunction(fes, multidim=4)
+    lam = LOBPCG(a.mat, m.mat, gfu.vecs, pre=pre.mat, freedofs=fes.FreeDofs(),
+                 precision=1e-8, maxsteps=1000)
+    for l, ex in zip(lam, exact):
+        assert abs(l-ex) < 1e-4 * ex
+
+    # with the first eigenvector deflated, the next ones are computed
+    vecs = [gfu.vecs[0].CreateVector() for i in range(3)]
+    lam2 = LOBPCG(a.mat, m.mat, vecs, pre=pre.mat, freedofs=fes.FreeDofs(),
+                  deflation=[gfu.vecs[0]], precision=1e-8, maxsteps=1000)
+    for l, ex in zip(lam2, exact[1:]):
+        assert abs(l-ex) < 1e-4 * ex
+
+    # deflation and initial vectors must be real and of the same size
+    with pytest.raises(Exception):
+        LOBPCG(a.mat, m.mat, vecs, deflation=[CreateVVector(fes.ndof+1)])
+    with pytest.raises(Exception):
+        LOBPCG(a.mat, m.mat, vecs + [CreateVVector(fes.ndof, complex=True)])
+
+def test_block_krylov():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.1))
+    fes = H1(mesh, order=3, dirichlet=".*")
+    u,v = fes.TrialFunction(), fes.TestFunction()
+    rhs = []
+    for cf in [1, x, y*y, 0, x-2*y*y]:
+        f = LinearForm(fes)
+        f += SymbolicLFI(cf*v)
+        f.Assemble()
+        rhs.append(f.vec)
+
+    for sym, solver in [(True, BlockCGSolver), (False, BlockGMRESSolver)]:
+        a = BilinearForm(fes, symmetric=sym)
+        a += SymbolicBFI(grad(u)*grad(v) + u*v)
+        if not sym:
+            a += SymbolicBFI(0.5*grad(u)[0]*v)
+        c = Preconditioner(a, "local")
+        a.Assemble()
+
+        inv = a.mat.Inverse(fes.FreeDofs())
+        sol = [f.CreateVector() for f in rhs]
+        res = rhs[0].CreateVector()
+        solver(a.mat, c.mat, printrates=False, precision=1e-12, maxsteps=500).Solve(rhs, sol)
+        for f, s in zip(rhs, sol):
+            res.data = inv * f - s
+            assert Norm(res) <= 1e-8 * Norm(s) + 1e-14
+
+        if not sym:
+            # short cycles, the solution is improved over several restarts
+            sol = [f.CreateVector() for f in rhs]
+            solver(a.mat, c.mat, printrates=False, precision=1e-12, maxsteps=2000, restart=10).Solve(rhs, sol)
+            for f, s in zip(rhs, sol):
+                res.data = inv * f - s
+                assert Norm(res) <= 1e-8 * Norm(s) + 1e-14
+
+def test_multivector_products():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.1))
+    fes = H1(mesh, order=3)
+    u,v = fes.TrialFunction(), fes.TestFunction()
+    gfu = GridFunction(fes)
+    k = 5
+    mx = MultiVector(fes.ndof, k)
+    my = MultiVector(fes.ndof, k)
+    for i in range(k):
+        gfu.Set(sin((i+1)*x) + y*y)
+        mx[i] = gfu.vec
+    w = gfu.vec.CreateVector()
+    a = BilinearForm(fes, symmetric=True)
+    coef = Parameter(1)
+    a += SymbolicBFI(coef*grad(u)*grad(v) + (1+x)*u*v)
+    # the transposed graph is kept, the values are read after re-assembling
+    for val in [1, 3]:
+        coef.Set(val)
+        a.Assemble()
+        a.mat.Mult(mx, my)
+        for i in range(k):
+            w.data = a.mat * mx[i] - my[i]
+            assert Norm(w) < 1e-12 * Norm(my[i])
+
+    # solvers without a block version solve vector by vector
+    inv = CGSolver(a.mat, a.mat.CreateSmoother(), printrates=False, precision=1e-12, maxsteps=1000)
+    inv.Mult(my, mx)
+    for i in range(k):
+        w.data = a.mat * mx[i] - my[i]
+        assert Norm(w) < 1e-8 * Norm(my[i])
+
+def test_multivector_orthogonalize():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.1))
+    fes = H1(mesh, order=2)
+    gfu = GridFunction(fes)
+    k = 6
+    mv = MultiVector(fes.ndof, k)
+    for i in range(k):
+        gfu.Set(sin((i+1)*x) + y*y)
+        mv[i] = gfu.vec
+
+    for tsqr in [False, True]:
+        q = MultiVector(fes.ndof, k)
+        q.Assign(mv)
+        r = q.Orthogonalize(tsqr=tsqr)
+        g = q.InnerProduct(q)
+        for i in range(k):
+            for j in range(k):
+                assert abs(g[i,j] - (1 if i == j else 0)) < 1e-10
+        # mv - q*r = 0
+        diff = MultiVector(fes.ndof, k)
+        diff.Assign(mv)
+        diff.Add(-1, q, r)
+        for nrm, ref in zip(diff.Norms(), mv.Norms()):
+            assert nrm < 1e-10 * ref
+
+    # vectors of another size or complex vectors are rejected
+    with pytest.raises(Exception):
+        mv[0] = CreateVVector(fes.ndof+1)
+    with pytest.raises(Exception):
+        mv[0] = CreateVVector(fes.ndof, complex=True)
+
+def test_matrixfree_sumfactorization():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.25, quad_dominated=True))
+    fes = H1(mesh, order=5, dirichlet="left|bottom")
+    u,v = fes.TrialFunction(), fes.TestFunction()
+    form = (1+x*x)*grad(u)*grad(v) + u*v
+    a = BilinearForm(fes)
+    a += SymbolicBFI(form)
+    amf = BilinearForm(fes, nonassemble=True, precompute=True)
+    amf += SymbolicBFI(form)
+    f = LinearForm(fes)
+    f += SymbolicLFI(v)
+    a.Assemble()
+    amf.Assemble()
+    f.Assemble()
+
+    gfu = GridFunction(fes)
+    gfu.Set(sin(3*x)*y)
+    y1 = gfu.vec.CreateVector()
+    y2 = gfu.vec.CreateVector()
+    y1.data = a.mat * gfu.vec
+    y2.data = amf.mat * gfu.vec
+    y1.data -= y2
+    assert Norm(y1) < 1e-10 * Norm(y2)
+
+    pre = a.mat.CreateSmoother(fes.FreeDofs())
+    inv = CGSolver(amf.mat, pre, printrates=False, precision=1e-12, maxsteps=1000)
+    y1.data = inv * f.vec
+    y2.data = a.mat.Inverse(fes.FreeDofs()) * f.vec
+    y1.data -= y2
+    assert Norm(y1) < 1e-8 * Norm(y2)
+
+def test_elmat_cache():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.3))
+    fes = H1(mesh, order=3)
+    u,v = fes.TrialFunction(), fes.TestFunction()
+    t = Parameter(1)
+    a = BilinearForm(fes)
+    a += SymbolicBFI(grad(u)*grad(v))
+    a += SymbolicBFI(t*u*v)
+    c = Parameter(1)
+    a += SymbolicBFI(c*u.Trace()*v.Trace(), BND)
+    ac = BilinearForm(fes, cache_elmats=True)
+    ac += SymbolicBFI(grad(u)*grad(v)).SetCacheElementMatrix()
+    ac += SymbolicBFI(t*u*v)
+    bfi = SymbolicBFI(c*u.Trace()*v.Trace(), BND)
+    ac += bfi.SetCacheElementMatrix()
+
+    def check():
+        a.Assemble()
+        ac.Assemble()
+        diff = a.mat.AsVector().CreateVector()
+        diff.data = a.mat.AsVector() - ac.mat.AsVector()
+        assert Norm(diff) < 1e-12 * Norm(a.mat.AsVector())
+
+    for tval in [1, 2]:
+        t.Set(tval)
+        check()
+
+    # marking the integrator again recomputes its cached matrices
+    c.Set(3)
+    bfi.SetCacheElementMatrix()
+    check()
+
+    # a new geometry invalidates the cache
+    deform = GridFunction(H1(mesh, order=1, dim=2))
+    deform.Set((0.2*y, 0))
+    mesh.SetDeformation(deform)
+    check()
+    # as well as a deformation changed in place
+    deform.Set((0.1*y, 0.1*x))
+    check()
+    mesh.UnsetDeformation()
+    check()
+
+
+def test_timestepping():
+    from math import pi, exp, cos, sqrt
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    fes = H1(mesh, order=4, dirichlet=".*")
+    u,v = fes.TrialFunction(), fes.TestFunction()
+    a = BilinearForm(fes)
+    a += SymbolicBFI(grad(u)*grad(v))
+    m = BilinearForm(fes)
+    m += SymbolicBFI(u*v)
+    a.Assemble()
+    m.Assemble()
+
+    # the first eigenfunction decays like exp(-lam t), or oscillates like cos(sqrt(lam) t)
+    lam = 2*pi**2
+    u0 = GridFunction(fes)
+    u0.Set(sin(pi*x)*sin(pi*y))
+    gfu = GridFunction(fes)
+    tend = 0.1
+
+    def error(stepper, dt, exact):
+        gfu.vec.data = u0.vec
+        stepper.time = 0
+        stepper.Integrate(gfu.vec, tend, dt)
+        assert abs(stepper.time - tend) < 1e-12
+        return sqrt(Integrate((gfu-exact*u0)**2, mesh))
+
+    for stepper, order in [ (BDF(m.mat, a.mat, order=2, freedofs=fes.FreeDofs()), 2),
+                            (BDF(m.mat, a.mat, order=3, freedofs=fes.FreeDofs()), 3),
+                            (RungeKutta(m.mat, a.mat, method="sdirk3", freedofs=fes.FreeDofs()), 3) ]:
+        errs = [error(stepper, dt, exp(-lam*tend)) for dt in [0.01, 0.005]]
+        assert errs[0] < 1e-2
+        assert errs[0] / errs[1] > 2**order * 0.7
+
+    newmark = Newmark(m.mat, a.mat, freedofs=fes.FreeDofs())
+    zero = u0.vec.CreateVector()
+    zero[:] = 0
+    errs = []
+    for dt in [0.01, 0.005]:
+        newmark.SetVelocity(zero)
+        errs.append(error(newmark, dt, cos(sqrt(lam)*tend)))
+    assert errs[0] < 1e-2
+    assert errs[0] / errs[1] > 4 * 0.7
+
+    # a right hand side as function of time:  M u' = 2t M u0, u(0) = 0,  so u(1) = u0
+    f = m.mat.CreateColVector()
+    f.data = m.mat * u0.vec
+    def rhs(t, vec):
+        vec.data = 2*t * f
+    stepper = RungeKutta(m.mat, 0*m.mat, rhs=rhs, method="rk4", freedofs=fes.FreeDofs())
+    gfu.vec[:] = 0
+    calls = []
+    stepper.Integrate(gfu.vec, 1, 0.1, callback=lambda t: calls.append(t))
+    assert len(calls) == 10 and abs(calls[-1]-1) < 1e-12
+    gfu.vec.data -= u0.vec
+    assert Norm(gfu.vec) < 1e-8 * Norm(u0.vec)
+
 
 if __name__ == "__main__":
     test_arnoldi()
+    test_sparsecholesky_outofcore()
+    test_sparsecholesky_ordering()
+    test_singleprecision_preconditioners()
+    test_pipelined_cg()
+    test_gmres_qmr()
+    test_matrixfree_sumfactorization()
+    test_elmat_cache()
+    test_timestepping()
@@ -0,0 +1,58 @@
+import pytest
+import re, struct
+from ngsolve import *
+from netgen.geom2d import unit_square
+
+
+def read_vtu(filename):
+    """ the data arrays of a vtu file with appended raw data, by name """
+    data = open(filename, "rb").read()
+    start = data.index(b'<AppendedData encoding="raw">\n_') + len(b'<AppendedData encoding="raw">\n_')
+    header = data[:start].decode()
+    compressed = "vtkZLibDataCompressor" in header
+    sizes = { "Float32" : "f", "Int64" : "q", "UInt8" : "B" }
+    arrays = {}
+    for tag in re.findall(r'<DataArray [^>]*>', header):
+        typ = re.search(r'type="(\w+)"', tag).group(1)
+        name = re.search(r'Name="(\w+)"', tag)
+        name = name.group(1) if name else "Points"
+        pos = start + int(re.search(r'offset="(\d+)"', tag).group(1))
+        if compressed:
+            import zlib
+            nblocks, = struct.unpack("<Q", data[pos:pos+8])
+            csizes = struct.unpack("<%dQ" % nblocks, data[pos+24:pos+24+8*nblocks])
+            pos += 24+8*nblocks
+            raw = b""
+            for c in csizes:
+                raw += zlib.decompress(data[pos:pos+c])
+                pos += c
+        else:
+            nbytes, = struct.unpack("<Q", data[pos:pos+8])
+            raw = data[pos+8:pos+8+nbytes]
+        arrays[name] = struct.unpack("<%d%s" % (len(raw)//struct.calcsize(sizes[typ]), sizes[typ]), raw)
+    return arrays
+
+
+@pytest.mark.parametrize("compress", [False, True])
+def test_vtu_output(tmpdir, compress):
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.3))
+    filename = str(tmpdir.join("out"))
+    with TaskManager():
+        vtk = VTKOutput(ma=mesh, coefs=[x*y, CoefficientFunction((x,y))], names=["u","grad"],
+                        filename=filename, subdivision=2, format="vtu", compress=compress)
+        vtk.Do()
+    arrays = read_vtu(filename+".vtu")
+
+    npts = len(arrays["Points"]) // 3
+    ncells = len(arrays["types"])
+    assert ncells == mesh.ne * 16
+    assert npts == mesh.ne * 15
+    assert set(arrays["types"]) == { 5 }
+    assert arrays["offsets"][-1] == len(arrays["connectivity"]) == 3*ncells
+    assert max(arrays["connectivity"]) == npts-1
+    for i in range(npts):
+        px, py, pz = arrays["Points"][3*i:3*i+3]
+        assert pz == 0
+        assert abs(arrays["u"][i] - px*py) < 1e-6
+        assert abs(arrays["grad"][2*i] - px) < 1e-6
+        assert abs(arrays["grad"][2*i+1] - py) < 1e-6
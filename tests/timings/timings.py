@@ -5,6 +5,7 @@ import multiprocessing
 from ngsolve import *
 import json
 import os
+import time
 ngsglobals.msg_level=0
 
 import argparse
@@ -43,8 +44,10 @@ else:
     results['build'] = build
 
     timings = results["timings"]
-    timings["FESpace"] = []
-    timings["Element"] = []
+
+# results files written by older versions lack the newer keys
+for key in ["FESpace", "Element", "Assembly", "SpMV"]:
+    timings.setdefault(key, [])
 
 
 # test fespaces
@@ -106,5 +109,67 @@ if args.sequential:
                     timings["Element"].append(tim)
 
 
+# colored vs. task-graph matrix assembly
+if args.parallel:
+    mesh = Mesh(unit_cube.GenerateMesh(maxh=0.1))
+    for order in [1,4]:
+        fes = H1(mesh, order=order)
+        u,v = fes.TnT()
+        for taskgraph in [False, True]:
+            a = BilinearForm(fes, taskgraph=taskgraph)
+            a += SymbolicBFI(grad(u)*grad(v)+u*v)
+            with TaskManager():
+                a.Assemble()   # first call builds coloring/task-graph and matrix graph
+                start = time.time()
+                a.Assemble()
+                tim = {}
+                tim['dimension'] = mesh.dim
+                tim['fespace'] = "H1"
+                tim['order'] = order
+                tim['name'] = "Assemble " + ("taskgraph" if taskgraph else "colored")
+                tim['time'] = time.time()-start
+                tim['taskmanager'] = 1
+                tim['nthreads'] = ngsglobals.numthreads
+                timings["Assembly"].append(tim)
+
+
+# CSR vs. SELL-C-sigma matrix-vector product
+def TimeMult(mat, x, y, runs=100):
+    y.data = mat * x
+    start = time.time()
+    for i in range(runs):
+        y.data = mat * x
+    return (time.time()-start) / runs
+
+mesh = Mesh(unit_cube.GenerateMesh(maxh=0.1))
+for order in [1,4]:
+    fes = H1(mesh, order=order)
+    u,v = fes.TnT()
+    a = BilinearForm(fes)
+    a += SymbolicBFI(grad(u)*grad(v)+u*v)
+    a.Assemble()
+    x = a.mat.CreateColVector()
+    y = a.mat.CreateColVector()
+    x.SetRandom()
+    for name, mat in [("CSR", a.mat), ("SELL", SELLMatrix(a.mat)), ("SELL float", SELLMatrixFloat(a.mat))]:
+        for parallel in [False, True]:
+            if parallel and args.parallel:
+                with TaskManager():
+                    t = TimeMult(mat, x, y)
+            elif not parallel and args.sequential:
+                t = TimeMult(mat, x, y)
+            else:
+                continue
+            tim = {}
+            tim['dimension'] = mesh.dim
+            tim['fespace'] = "H1"
+            tim['order'] = order
+            tim['name'] = "Mult " + name
+            tim['time'] = t
+            tim['gflops'] = 2*a.mat.nze / t * 1e-9
+            tim['taskmanager'] = 1 if parallel else 0
+            tim['nthreads'] = ngsglobals.numthreads if parallel else 1
+            timings["SpMV"].append(tim)
+
 json.dump(results,open('results.json','w'))
 